@@ -1,5 +1,9 @@
+#include <dirent.h>
+#include <sys/stat.h>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -34,4 +38,93 @@ class FileUtils {
         inFile.close();
         return false;
     }
+
+    /* Read the whole given file into data, for the modes that need random
+     * access to the input; return false if it cannot be read whole */
+    static bool readFile(string fileName, vector<unsigned char>& data) {
+        ifstream inFile;
+        inFile.open(fileName, ios::binary);
+        inFile.seekg(0, ios::end);
+        streamoff size = inFile.tellg();
+        inFile.seekg(0, ios::beg);
+        data.resize(size > 0 ? size : 0);
+        inFile.read((char*)data.data(), data.size());
+        bool read = inFile.is_open() && size >= 0 &&
+                    (size_t)inFile.gcount() == data.size();
+        inFile.close();
+        return read;
+    }
+
+    /* Check if the given path is a directory */
+    static bool isDirectory(string path) {
+        struct stat info;
+        return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+    }
+
+    /* return the number of bytes of the given file, 0 if it cannot be read */
+    static unsigned long long getFileSize(string fileName) {
+        struct stat info;
+        return stat(fileName.c_str(), &info) == 0 ? info.st_size : 0;
+    }
+
+    /* Add every regular file below the given directory to fileNames, in
+     * directory order */
+    static void listFiles(string dirName, vector<string>& fileNames) {
+        DIR* dir = opendir(dirName.c_str());
+        if (dir == 0) {
+            return;
+        }
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != 0) {
+            string name = entry->d_name;
+            if (name == "." || name == "..") {
+                continue;
+            }
+            string path = dirName + "/" + name;
+            struct stat info;
+            if (lstat(path.c_str(), &info) != 0) {
+                continue;
+            }
+            if (S_ISDIR(info.st_mode)) {
+                listFiles(path, fileNames);
+            } else if (S_ISREG(info.st_mode)) {
+                fileNames.push_back(path);
+            }
+        }
+        closedir(dir);
+    }
+
+    /* return the absolute path of the given file or directory, with no
+     * symbolic link, "." or "..", or "" if it does not exist */
+    static string getRealPath(string path) {
+        char* real = realpath(path.c_str(), 0);
+        if (real == 0) {
+            return "";
+        }
+        string result = real;
+        free(real);
+        return result;
+    }
+
+    /* Check if the given file is below the given directory, however
+     * either path is spelled */
+    static bool isInside(string fileName, string dirName) {
+        string dir = getRealPath(dirName);
+        string file = getRealPath(fileName);
+        if (dir.empty() || file.empty()) {
+            return false;
+        }
+        if (dir != "/") {
+            dir += "/";
+        }
+        return file.compare(0, dir.size(), dir) == 0;
+    }
+
+    /* Create every missing directory above the given file */
+    static void makeParentDirs(string fileName) {
+        for (size_t slash = fileName.find('/', 1); slash != string::npos;
+             slash = fileName.find('/', slash + 1)) {
+            mkdir(fileName.substr(0, slash).c_str(), 0755);
+        }
+    }
 };
@@ -0,0 +1,74 @@
+/**
+ * This file shows the implementation of ArchiveFormat class methods.
+ * Declaration can be found in 'ArchiveFormat.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "ArchiveFormat.hpp"
+
+#include <fstream>
+
+const byte ArchiveFormat::VERSION = 1;
+const unsigned int ArchiveFormat::HEADER_SIZE = 13;
+const unsigned int ArchiveFormat::TRAILER_SIZE = 12;
+const unsigned int ArchiveFormat::MAX_NAME_LENGTH = 65535;
+
+const byte ArchiveFormat::SHARED_TREE_FLAG = 1;
+
+/* the bytes after the legacy total of 0 */
+static const char MAGIC[3] = {'H', 'C', 'A'};
+
+/* Write the archive header, without the shared tree */
+void ArchiveFormat::writeHeader(ostream& out, unsigned int chunkSize,
+                                byte flags) {
+    FrameFormat::writeNumber(out, 0, 4);
+    out.write(MAGIC, 3);
+    out.put(VERSION);
+    out.put(flags);
+    FrameFormat::writeNumber(out, chunkSize, 4);
+}
+
+/* Read the archive header, return false if in does not start with one */
+bool ArchiveFormat::readHeader(istream& in, unsigned int& chunkSize,
+                               byte& flags) {
+    char head[8];
+    in.read(head, 8);
+    if (!in || head[0] != 0 || head[1] != 0 || head[2] != 0 || head[3] != 0 ||
+        head[4] != MAGIC[0] || head[5] != MAGIC[1] || head[6] != MAGIC[2] ||
+        (byte)head[7] > VERSION) {
+        return false;
+    }
+    flags = in.get();
+    chunkSize = FrameFormat::readNumber(in, 4);
+    return in && chunkSize > 0;
+}
+
+/* return the name a file is stored under, without its leading '/', '.'
+      and '..' components */
+string ArchiveFormat::normalizeName(const string& name) {
+    size_t start = 0;
+    while (start < name.size()) {
+        size_t end = name.find('/', start);
+        if (end == string::npos) {
+            end = name.size();
+        }
+        string component = name.substr(start, end - start);
+        if (!component.empty() && component != "." && component != "..") {
+            break;
+        }
+        start = end + 1;
+    }
+    return start < name.size() ? name.substr(start) : "";
+}
+
+/* Check if the given file holds an archive */
+bool ArchiveFormat::isArchive(string fileName) {
+    ifstream inFile;
+    inFile.open(fileName, ios::binary);
+    unsigned int chunkSize;
+    byte flags;
+    bool archive = readHeader(inFile, chunkSize, flags);
+    inFile.close();
+    return archive;
+}
@@ -0,0 +1,61 @@
+/**
+ * This file declares the ArchiveFormat class, the constants and the header
+ * helpers of the multi-file archive format
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef ARCHIVEFORMAT_HPP
+#define ARCHIVEFORMAT_HPP
+
+#include <iostream>
+#include <string>
+#include "FrameFormat.hpp"
+
+using namespace std;
+
+/** The multi-file archive format. Like a frame it starts with a legacy
+ * header of total 0, then:
+ *   3 bytes magic "HCA", 1 byte version, 1 byte flags, 4 bytes chunk size
+ *   if SHARED_TREE_FLAG is set: 4 bytes tree length, the shared tree as
+ *   8 bits distinct count - 1 and HCTree::getTree, padded to a byte
+ * then the chunks of every file, as frame chunks with checksums, a file
+ * is cut into chunks of the chunk size. Then the file table:
+ *   for every file 2 bytes name length, name, 8 bytes size, 8 bytes offset
+ *   of its first chunk in the archive
+ * and 4 bytes number of files, 8 bytes offset of the file table. All
+ * numbers are big endian */
+class ArchiveFormat {
+  public:
+    static const byte VERSION;
+    static const unsigned int HEADER_SIZE;   // bytes before the tree
+    static const unsigned int TRAILER_SIZE;  // bytes after the file table
+    static const unsigned int MAX_NAME_LENGTH;  // fits the 2 byte length
+
+    /* header flags */
+    static const byte SHARED_TREE_FLAG;  // SHARED chunks use one tree
+
+    /* Write the archive header, without the shared tree
+      params:
+        out: the output stream, should be passed by reference
+        chunkSize: the nominal number of bytes per chunk
+        flags: the header flags */
+    static void writeHeader(ostream& out, unsigned int chunkSize, byte flags);
+
+    /* Read the archive header, return false if in does not start with one
+      params:
+        in: the input stream, should be passed by reference
+        chunkSize: set to the nominal number of bytes per chunk
+        flags: set to the header flags */
+    static bool readHeader(istream& in, unsigned int& chunkSize, byte& flags);
+
+    /* return the name a file is stored under: the path without its leading
+      '/', '.' and '..' components, so that it stays inside the directory
+      it is extracted to. Empty if no component is left */
+    static string normalizeName(const string& name);
+
+    /* Check if the given file holds an archive */
+    static bool isArchive(string fileName);
+};
+
+#endif  // ARCHIVEFORMAT_HPP
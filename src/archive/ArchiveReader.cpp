@@ -0,0 +1,130 @@
+/**
+ * This file shows the implementation of ArchiveReader class methods.
+ * Declaration can be found in 'ArchiveReader.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "ArchiveReader.hpp"
+
+#include <sstream>
+#include "BitInputStream.hpp"
+#include "Crc32c.hpp"
+
+/* Constructor of ArchiveReader, reads the header, the shared tree and the
+      file table */
+ArchiveReader::ArchiveReader(istream& is)
+    : in(is), valid(false), chunkSize(0), sharedTree(0) {
+    start = in.tellg();
+    byte flags;
+    if (start < 0 || !ArchiveFormat::readHeader(in, chunkSize, flags)) {
+        return;
+    }
+    if (flags & ArchiveFormat::SHARED_TREE_FLAG) {
+        unsigned int treeLength = FrameFormat::readNumber(in, 4);
+        string tree(treeLength, '\0');
+        in.read(&tree[0], treeLength);
+        if (!in) {
+            return;
+        }
+        sharedTree = new HCTree();
+        if (treeLength > 0) {
+            istringstream treeIn(tree);
+            BitInputStream bitIn(treeIn);
+            if (!sharedTree->reconstructTree(bitIn, bitIn.readBits(8) + 1)) {
+                return;
+            }
+            sharedTree->buildDecodeTable();
+        }
+    }
+
+    // the file table, found from the end
+    in.seekg(-(streamoff)ArchiveFormat::TRAILER_SIZE, ios::end);
+    streamoff trailer = in.tellg();
+    unsigned int count = FrameFormat::readNumber(in, 4);
+    unsigned long long tableOffset = FrameFormat::readNumber(in, 8);
+    if (!in || trailer < start ||
+        tableOffset > (unsigned long long)(trailer - start)) {
+        return;
+    }
+    in.seekg(start + (streamoff)tableOffset);
+    for (unsigned int i = 0; i < count && in; i++) {
+        unsigned int nameLength = FrameFormat::readNumber(in, 2);
+        string name(nameLength, '\0');
+        in.read(&name[0], nameLength);
+        names.push_back(name);
+        sizes.push_back(FrameFormat::readNumber(in, 8));
+        offsets.push_back(FrameFormat::readNumber(in, 8));
+    }
+    valid = in && in.tellg() == trailer;
+}
+
+/* Destructor, automatically call it to avoid memory leak */
+ArchiveReader::~ArchiveReader() { delete sharedTree; }
+
+/* return whether the stream holds an archive with a file table */
+bool ArchiveReader::isValid() const { return valid; }
+
+/* return the number of files */
+unsigned int ArchiveReader::getFileCount() const { return names.size(); }
+
+/* return the name of the given file */
+const string& ArchiveReader::getName(unsigned int index) const {
+    return names[index];
+}
+
+/* return the number of bytes of the given file */
+unsigned long long ArchiveReader::getSize(unsigned int index) const {
+    return sizes[index];
+}
+
+/* return the index of the file of the given name */
+int ArchiveReader::findFile(const string& name) const {
+    // the name as typed, or as the writer stores it
+    string stored = ArchiveFormat::normalizeName(name);
+    for (unsigned int i = 0; i < names.size(); i++) {
+        if (names[i] == name || names[i] == stored) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Read, decode and verify the given file */
+bool ArchiveReader::readFile(unsigned int index, vector<byte>& data) {
+    data.clear();
+    if (!valid || index >= names.size()) {
+        return false;
+    }
+    in.clear();
+    in.seekg(start + (streamoff)offsets[index]);
+    vector<byte> chunk;
+    while (data.size() < sizes[index]) {
+        byte mode;
+        unsigned int length, payloadLength, checksum;
+        if (!FrameFormat::readChunkHeader(in, mode, length, payloadLength,
+                                          checksum, true) ||
+            length == 0 || length > chunkSize ||
+            length > sizes[index] - data.size() ||
+            (mode > FrameFormat::LZ && mode != FrameFormat::SHARED) ||
+            (mode == FrameFormat::SHARED && sharedTree == 0)) {
+            return false;
+        }
+        string payload(payloadLength, '\0');
+        in.read(&payload[0], payloadLength);
+        if (!in) {
+            return false;
+        }
+        if (mode == FrameFormat::SHARED) {
+            // codes of the shared tree, with no header
+            ChunkCodec::decodeShared(payload, *sharedTree, length, chunk);
+        } else if (!ChunkCodec::decode(payload, mode, length, chunk)) {
+            return false;
+        }
+        if (Crc32c::compute(chunk) != checksum) {
+            return false;
+        }
+        data.insert(data.end(), chunk.begin(), chunk.end());
+    }
+    return true;
+}
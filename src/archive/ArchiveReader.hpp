@@ -0,0 +1,64 @@
+/**
+ * This file declares the ArchiveReader class, which reads the files of an
+ * archive in any order
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef ARCHIVEREADER_HPP
+#define ARCHIVEREADER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ArchiveFormat.hpp"
+#include "ChunkCodec.hpp"
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** A class, instance of which reads one archive from a seekable stream */
+class ArchiveReader {
+  private:
+    istream& in;               // reference to the input stream to use
+    bool valid;                // whether the header and file table were read
+    unsigned int chunkSize;    // nominal number of bytes per chunk
+    HCTree* sharedTree;        // the tree of SHARED chunks, 0 if none
+    streamoff start;           // position of the archive in the stream
+    vector<string> names;               // file table, names
+    vector<unsigned long long> sizes;   // file table, sizes
+    vector<unsigned long long> offsets;  // file table, first chunks
+
+  public:
+    /* Constructor of ArchiveReader, reads the header, the shared tree and
+      the file table
+      param: the input stream, must be seekable */
+    explicit ArchiveReader(istream& is);
+
+    /* Destructor, automatically call it to avoid memory leak */
+    ~ArchiveReader();
+
+    /* return whether the stream holds an archive with a file table */
+    bool isValid() const;
+
+    /* return the number of files */
+    unsigned int getFileCount() const;
+
+    /* return the name of the given file */
+    const string& getName(unsigned int index) const;
+
+    /* return the number of bytes of the given file */
+    unsigned long long getSize(unsigned int index) const;
+
+    /* return the index of the file of the given name, -1 if there is none */
+    int findFile(const string& name) const;
+
+    /* Read, decode and verify the given file
+      params:
+        index: the index of the file
+        data: the output, resized to the file size
+      return: false if a chunk is damaged */
+    bool readFile(unsigned int index, vector<byte>& data);
+};
+
+#endif  // ARCHIVEREADER_HPP
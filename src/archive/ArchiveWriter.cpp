@@ -0,0 +1,100 @@
+/**
+ * This file shows the implementation of ArchiveWriter class methods.
+ * Declaration can be found in 'ArchiveWriter.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "ArchiveWriter.hpp"
+
+#include <sstream>
+#include "BitOutputStream.hpp"
+#include "Crc32c.hpp"
+
+const unsigned int ArchiveWriter::SMALL_FILE_SIZE = 1 << 16;
+
+/* Constructor of ArchiveWriter, writes the archive header */
+ArchiveWriter::ArchiveWriter(ostream& os, unsigned int chunkSize, int level)
+    : out(os), chunkSize(chunkSize), level(level), sharedTree(0) {
+    ArchiveFormat::writeHeader(out, chunkSize, 0);
+    position = ArchiveFormat::HEADER_SIZE;
+}
+
+/* Constructor of ArchiveWriter, writes the archive header and a tree
+      built from the given frequencies that chunks may share */
+ArchiveWriter::ArchiveWriter(ostream& os, unsigned int chunkSize, int level,
+                             const vector<unsigned int>& sharedFreqs)
+    : out(os), chunkSize(chunkSize), level(level), sharedTree(0) {
+    ArchiveFormat::writeHeader(out, chunkSize,
+                               ArchiveFormat::SHARED_TREE_FLAG);
+    position = ArchiveFormat::HEADER_SIZE + 4;
+    sharedTree = new HCTree();
+    sharedTree->build(sharedFreqs);
+    // the tree goes aside first, its length is written before it
+    ostringstream tree;
+    unsigned int count = sharedTree->getDistinctChars();
+    if (count > 0) {
+        BitOutputStream bitOut(tree);
+        bitOut.writeBits(count - 1, 8);
+        sharedTree->getTree(bitOut);
+        bitOut.flush();
+    }
+    FrameFormat::writeNumber(out, tree.str().size(), 4);
+    out << tree.str();
+    position += tree.str().size();
+}
+
+/* Destructor, automatically call it to avoid memory leak */
+ArchiveWriter::~ArchiveWriter() { delete sharedTree; }
+
+/* Write one file */
+bool ArchiveWriter::addFile(const string& name, const vector<byte>& data) {
+    string stored = ArchiveFormat::normalizeName(name);
+    if (stored.empty() || stored.size() > ArchiveFormat::MAX_NAME_LENGTH) {
+        return false;
+    }
+    names.push_back(stored);
+    sizes.push_back(data.size());
+    offsets.push_back(position);
+    for (unsigned long long i = 0; i < data.size(); i += chunkSize) {
+        unsigned long long end = i + chunkSize < data.size()
+                                     ? i + chunkSize
+                                     : data.size();
+        writeChunk(vector<byte>(data.begin() + i, data.begin() + end));
+    }
+    return true;
+}
+
+/* Write one chunk in the smallest mode */
+void ArchiveWriter::writeChunk(const vector<byte>& data) {
+    ostringstream payload;
+    byte mode = ChunkCodec::encodeBest(data, level, payload);
+
+    // the shared tree needs no header, but has to know every byte
+    if (sharedTree != 0) {
+        ostringstream shared;
+        if (ChunkCodec::encodeShared(data, *sharedTree, payload.str().size(),
+                                     shared)) {
+            mode = FrameFormat::SHARED;
+            payload.str(shared.str());
+        }
+    }
+    FrameFormat::writeChunkHeader(out, mode, data.size(),
+                                  payload.str().size(), Crc32c::compute(data));
+    out << payload.str();
+    position += FrameFormat::CHUNK_HEADER_SIZE + payload.str().size();
+}
+
+/* Write the file table */
+void ArchiveWriter::close() {
+    unsigned long long tableOffset = position;
+    for (unsigned int i = 0; i < names.size(); i++) {
+        FrameFormat::writeNumber(out, names[i].size(), 2);
+        out << names[i];
+        FrameFormat::writeNumber(out, sizes[i], 8);
+        FrameFormat::writeNumber(out, offsets[i], 8);
+    }
+    FrameFormat::writeNumber(out, names.size(), 4);
+    FrameFormat::writeNumber(out, tableOffset, 8);
+    out.flush();
+}
@@ -0,0 +1,76 @@
+/**
+ * This file declares the ArchiveWriter class, which packs many files into
+ * one archive
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef ARCHIVEWRITER_HPP
+#define ARCHIVEWRITER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ArchiveFormat.hpp"
+#include "ChunkCodec.hpp"
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** A class, instance of which writes one archive. Every chunk is coded in
+ * the smallest mode the level finds, or with the shared tree when there is
+ * one and it is smaller: small files then need no tree of their own */
+class ArchiveWriter {
+  private:
+    ostream& out;              // reference to the output stream to use
+    unsigned int chunkSize;    // nominal number of bytes per chunk
+    int level;                 // the ChunkCodec level of the mode selection
+    HCTree* sharedTree;        // the tree of SHARED chunks, 0 if none
+    unsigned long long position;        // bytes written so far
+    vector<string> names;               // file table, names
+    vector<unsigned long long> sizes;   // file table, sizes
+    vector<unsigned long long> offsets;  // file table, first chunks
+
+  public:
+    /* files at most this large are meant for the shared tree */
+    static const unsigned int SMALL_FILE_SIZE;
+
+    /* Constructor of ArchiveWriter, writes the archive header
+      params:
+        os: the output stream
+        chunkSize: the nominal number of bytes per chunk
+        level: the ChunkCodec level of the mode selection */
+    ArchiveWriter(ostream& os, unsigned int chunkSize, int level);
+
+    /* Constructor of ArchiveWriter, writes the archive header and a tree
+      built from the given frequencies that chunks may share
+      params:
+        os: the output stream
+        chunkSize: the nominal number of bytes per chunk
+        level: the ChunkCodec level of the mode selection
+        sharedFreqs: the byte frequencies of the files to share the tree */
+    ArchiveWriter(ostream& os, unsigned int chunkSize, int level,
+                  const vector<unsigned int>& sharedFreqs);
+
+    /* Destructor, automatically call it to avoid memory leak */
+    ~ArchiveWriter();
+
+    /* Write one file under its normalized name
+      params:
+        name: the path of the file, ArchiveFormat::normalizeName gives the
+          name in the file table
+        data: the bytes of the file
+      return: false, writing nothing, if the name is empty once normalized
+        or longer than ArchiveFormat::MAX_NAME_LENGTH */
+    bool addFile(const string& name, const vector<byte>& data);
+
+    /* Write the file table */
+    void close();
+
+  private:
+    /* Write one chunk in the smallest mode
+      param: the bytes of the chunk, at least one */
+    void writeChunk(const vector<byte>& data);
+};
+
+#endif  // ARCHIVEWRITER_HPP
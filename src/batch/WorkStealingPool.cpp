@@ -0,0 +1,116 @@
+/**
+ * This file shows the implementation of WorkStealingPool class methods.
+ * Declaration can be found in 'WorkStealingPool.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "WorkStealingPool.hpp"
+
+#include <thread>
+
+/* the index of the pool thread running this code, -1 outside the pool */
+static thread_local int currentWorker = -1;
+
+/* Constructor of WorkStealingPool */
+WorkStealingPool::WorkStealingPool(unsigned int threads)
+    : pending(0), queued(0), next(0) {
+    if (threads == 0) {
+        threads = thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.push_back(new Worker());
+    }
+}
+
+/* Destructor, automatically call it to avoid memory leak */
+WorkStealingPool::~WorkStealingPool() {
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        delete workers[i];
+    }
+}
+
+/* return the number of threads */
+unsigned int WorkStealingPool::getThreadCount() const {
+    return workers.size();
+}
+
+/* Add a task */
+void WorkStealingPool::submit(function<void()> task) {
+    unsigned int id = currentWorker >= 0
+                          ? currentWorker
+                          : next.fetch_add(1) % workers.size();
+    pending++;
+    {
+        lock_guard<mutex> guard(workers[id]->lock);
+        workers[id]->tasks.push_back(task);
+    }
+    // counted under the lock idle threads check it with, so that none
+    // misses the notification
+    {
+        lock_guard<mutex> guard(idleLock);
+        queued++;
+    }
+    idle.notify_one();
+}
+
+/* Run every task on the threads, return when all are finished */
+void WorkStealingPool::run() {
+    vector<thread> threads;
+    for (unsigned int i = 1; i < workers.size(); i++) {
+        threads.push_back(thread(&WorkStealingPool::work, this, i));
+    }
+    // the calling thread is the first worker
+    work(0);
+    for (unsigned int i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+/* The loop of one thread, until no task is left */
+void WorkStealingPool::work(unsigned int id) {
+    int outside = currentWorker;
+    currentWorker = id;
+    function<void()> task;
+    while (pending > 0) {
+        if (take(id, task)) {
+            task();
+            if (--pending == 0) {
+                lock_guard<mutex> guard(idleLock);
+                idle.notify_all();
+            }
+        } else {
+            // the last tasks are running elsewhere, and may submit more
+            unique_lock<mutex> guard(idleLock);
+            idle.wait(guard, [this]() { return pending == 0 || queued > 0; });
+        }
+    }
+    currentWorker = outside;
+}
+
+/* Take the newest task of the given queue, or the oldest of another */
+bool WorkStealingPool::take(unsigned int id, function<void()>& task) {
+    {
+        lock_guard<mutex> guard(workers[id]->lock);
+        if (!workers[id]->tasks.empty()) {
+            task = workers[id]->tasks.back();
+            workers[id]->tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    for (unsigned int i = 1; i < workers.size(); i++) {
+        Worker* victim = workers[(id + i) % workers.size()];
+        lock_guard<mutex> guard(victim->lock);
+        if (!victim->tasks.empty()) {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
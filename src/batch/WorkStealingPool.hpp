@@ -0,0 +1,72 @@
+/**
+ * This file declares the WorkStealingPool class, a thread pool where idle
+ * threads take tasks from the queues of busy ones
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+/** A pool of threads with one task queue each. A thread runs the newest
+ * task of its own queue, and when it is empty steals the oldest task of
+ * another queue, so a thread stuck on a huge task does not hold back the
+ * small ones queued behind it. Tasks may submit more tasks */
+class WorkStealingPool {
+  private:
+    /* the queue of one thread */
+    struct Worker {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<Worker*> workers;            // one per thread
+    atomic<unsigned long long> pending;  // tasks submitted, not finished
+    atomic<unsigned long long> queued;   // tasks submitted, not taken
+    atomic<unsigned int> next;          // queue of the next outside task
+    mutex idleLock;                     // guards the waits of idle threads
+    condition_variable idle;            // a task queued, or all finished
+
+  public:
+    /* Constructor of WorkStealingPool
+      param: the number of threads, 0 for one per core */
+    explicit WorkStealingPool(unsigned int threads);
+
+    /* Destructor, automatically call it to avoid memory leak */
+    ~WorkStealingPool();
+
+    /* return the number of threads */
+    unsigned int getThreadCount() const;
+
+    /* Add a task. From outside the pool the queues take turns, from a task
+      it goes to the queue of its thread
+      param: the task */
+    void submit(function<void()> task);
+
+    /* Run every task on the threads, return when all are finished, the
+      ones submitted by tasks included */
+    void run();
+
+  private:
+    /* The loop of one thread, until no task is left
+      param: the index of the thread */
+    void work(unsigned int id);
+
+    /* Take the newest task of the given queue, or the oldest of another
+      params:
+        id: the index of the thread
+        task: set to the task taken
+      return: false if every queue is empty */
+    bool take(unsigned int id, function<void()>& task);
+};
+
+#endif  // WORKSTEALINGPOOL_HPP
@@ -7,9 +7,20 @@
  */
 #include "BitInputStream.hpp"
 
+#include <algorithm>
+
+/* the number of bytes readCodes reads at once */
+static const size_t READ_BLOCK_SIZE = 1 << 16;
+
+const size_t BitInputStream::AHEAD_PADDING = 32;
+
 /* Fills the one byte buffer from input stream */
 void BitInputStream::fill() {
-    buf = in.get();
+    if (aheadPos < ahead.size()) {
+        buf = ahead[aheadPos++];
+    } else {
+        buf = in.get();
+    }
     nbits = 7;
 }
 
@@ -22,4 +33,128 @@ unsigned int BitInputStream::readBit() {
     unsigned int nextbit = (buf >> nbits) & 1;
     nbits--;
     return nextbit;
-}
\ No newline at end of file
+}
+
+/* Read the next n bits, the first one read being the most significant.
+      Same as n calls of readBit */
+unsigned int BitInputStream::readBits(int n) {
+    unsigned int value = 0;
+    while (n > 0) {
+        if (nbits == -1) {
+            fill();
+        }
+        // take as many bits as the buffer still holds
+        int take = n < nbits + 1 ? n : nbits + 1;
+        unsigned int chunk =
+            ((unsigned char)buf >> (nbits + 1 - take)) & ((1u << take) - 1);
+        value = (value << take) | chunk;
+        nbits -= take;
+        n -= take;
+    }
+    return value;
+}
+
+/* Read n codes with a table, unpacked by BitKernels */
+void BitInputStream::readCodes(const BitKernels::DecodeTable& table,
+                               byte* symbols, size_t n) {
+    readCodesOf(table, symbols, n);
+}
+
+/* Read n codes of up to 16-bit symbols the same way */
+void BitInputStream::readCodes(const BitKernels::DecodeTable& table,
+                               unsigned short* symbols, size_t n) {
+    readCodesOf(table, symbols, n);
+}
+
+/* Helper method for readCodes, of either symbol width */
+template <typename T>
+void BitInputStream::readCodesOf(const BitKernels::DecodeTable& table,
+                                 T* symbols, size_t n) {
+    if (n == 0) {
+        return;
+    }
+    unsigned long long bitPos = takeBuffer();
+    size_t done = 0;
+    while (done < n) {
+        size_t size = ahead.size();
+        if (size < READ_BLOCK_SIZE && in) {
+            ahead.resize(READ_BLOCK_SIZE);
+            in.read((char*)ahead.data() + size, READ_BLOCK_SIZE - size);
+            size += in.gcount();
+            ahead.resize(size);
+        }
+        // past the end of the stream, zeros let the last codes be loaded
+        bool end = !in;
+        if (end) {
+            ahead.resize(size + 8, 0);
+        }
+        size_t count = BitKernels::unpackCodes(ahead.data(), ahead.size(),
+                                               bitPos, table, symbols + done,
+                                               n - done);
+        ahead.resize(size);
+        done += count;
+        if (count == 0 && end) {
+            // a truncated stream
+            fill_n(symbols + done, n - done, 0);
+            break;
+        }
+        // keep the bytes not decoded yet
+        size_t used = bitPos / 8 < size ? bitPos / 8 : size;
+        ahead.erase(ahead.begin(), ahead.begin() + used);
+        bitPos -= used * 8;
+    }
+    giveBuffer(bitPos);
+}
+
+/* Read the stream ahead for a decoder that takes the bits itself */
+const byte* BitInputStream::readAhead(size_t want, size_t& size,
+                                      unsigned long long& bitPos) {
+    bitPos = takeBuffer();
+    size = ahead.size();
+    size_t needed = bitPos / 8 + want;
+    if (size < needed && in) {
+        ahead.resize(needed);
+        in.read((char*)ahead.data() + size, needed - size);
+        size += in.gcount();
+    }
+    ahead.resize(size + AHEAD_PADDING, 0);
+    return ahead.data();
+}
+
+/* Take the bits of the bytes readAhead returned up to bitPos */
+void BitInputStream::skipAhead(unsigned long long bitPos) {
+    ahead.resize(ahead.size() - AHEAD_PADDING);
+    size_t used = bitPos / 8 < ahead.size() ? bitPos / 8 : ahead.size();
+    ahead.erase(ahead.begin(), ahead.begin() + used);
+    giveBuffer(bitPos - used * 8);
+}
+
+/* Helper method for readCodes and readAhead, put the byte of the next bit
+      back in front of the bytes read ahead */
+unsigned long long BitInputStream::takeBuffer() {
+    // the bits left in the buffer, then the bytes read ahead before
+    ahead.erase(ahead.begin(), ahead.begin() + aheadPos);
+    aheadPos = 0;
+    unsigned long long bitPos = 0;
+    if (nbits >= 0) {
+        ahead.insert(ahead.begin(), (byte)buf);
+        bitPos = 7 - nbits;
+        nbits = -1;
+    }
+    return bitPos;
+}
+
+/* Helper method for readCodes and skipAhead, put the byte of bitPos back
+      in the buffer */
+void BitInputStream::giveBuffer(unsigned long long bitPos) {
+    // the byte of the next bit goes back to the buffer
+    aheadPos = 0;
+    nbits = -1;
+    if (bitPos >= ahead.size() * 8) {
+        ahead.clear();
+    } else if (bitPos > 0) {
+        buf = ahead[0];
+        nbits = 7 - bitPos;
+        aheadPos = 1;
+    }
+}
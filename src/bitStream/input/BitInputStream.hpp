@@ -9,6 +9,8 @@
 #define BITINPUTSTREAM_HPP
 
 #include <iostream>
+#include <vector>
+#include "BitKernels.hpp"
 
 typedef unsigned char byte;
 
@@ -20,10 +22,13 @@ class BitInputStream {
     char buf;     // one byte buffer of bits
     int nbits;    // number of bits have been writen to buf
     istream& in;  // reference to the input stream to use
+    vector<byte> ahead;  // bytes readCodes read past its last code
+    size_t aheadPos;     // the next one of them
 
   public:
     /* constructor of BitInputStream */
-    explicit BitInputStream(istream& is) : in(is), buf(0), nbits(-1){};
+    explicit BitInputStream(istream& is)
+        : in(is), buf(0), nbits(-1), aheadPos(0){};
 
     /* Fills the one byte buffer from input stream */
     void fill();
@@ -31,6 +36,62 @@ class BitInputStream {
     /* Read next bit from the buffer. if the buffer has been
       already read, fill it */
     unsigned int readBit();
+
+    /* Read the next n bits, the first one read being the most significant.
+      Same as n calls of readBit
+      param: n, the number of bits, from 0 to 32 */
+    unsigned int readBits(int n);
+
+    /* Read n codes with a table, unpacked by BitKernels. Same as walking
+      the tree of the table for every symbol, but reads the input stream
+      ahead, so the stream is left for this BitInputStream alone
+      params:
+        table: the decode table of the codes
+        symbols: the decoded symbols, room for n of them
+        n: the number of symbols */
+    void readCodes(const BitKernels::DecodeTable& table, byte* symbols,
+                   size_t n);
+
+    /* Read n codes of up to 16-bit symbols, such as byte pairs, the same
+      way */
+    void readCodes(const BitKernels::DecodeTable& table,
+                   unsigned short* symbols, size_t n);
+
+    /* Read the stream ahead for a decoder that takes the bits itself, such
+      as one mixing codes with plain bits: at least want bytes from the
+      next bit on when the stream has them, then AHEAD_PADDING zeros. Every
+      call must be followed by a skipAhead before the stream is read in
+      any other way, and the stream is left for this BitInputStream alone
+      params:
+        want: the number of bytes
+        size: set to the number of bytes of the stream, the zeros left out
+        bitPos: set to the position of the next bit in the bytes
+      return: the bytes */
+    const byte* readAhead(size_t want, size_t& size,
+                          unsigned long long& bitPos);
+
+    /* Take the bits of the bytes readAhead returned up to bitPos, the next
+      read starts there
+      param: the position of the next bit in the bytes */
+    void skipAhead(unsigned long long bitPos);
+
+    static const size_t AHEAD_PADDING;  // zeros behind what readAhead reads
+
+  private:
+    /* Helper method for readCodes and readAhead, put the byte of the next
+      bit back in front of the bytes read ahead
+      return: the position of the next bit in them */
+    unsigned long long takeBuffer();
+
+    /* Helper method for readCodes and skipAhead, drop the bytes read ahead
+      before bitPos and put the byte of bitPos back in the buffer
+      param: the position of the next bit in the bytes read ahead */
+    void giveBuffer(unsigned long long bitPos);
+
+    /* Helper method for readCodes, of either symbol width */
+    template <typename T>
+    void readCodesOf(const BitKernels::DecodeTable& table, T* symbols,
+                     size_t n);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,512 @@
+/**
+ * This file shows the implementation of BitKernels class methods.
+ * Declaration can be found in 'BitKernels.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "BitKernels.hpp"
+
+#include <cstring>
+
+// the BMI2 and AVX2 variants are x86 code compiled for those targets
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HAS_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define HAS_X86_KERNELS 0
+#endif
+
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
+const int BitKernels::GENERIC = 0;
+const int BitKernels::BMI2 = 1;
+const int BitKernels::AVX2 = 2;
+const int BitKernels::MAX_CODE_LENGTH = 56;
+
+/* decode table entries: a leaf is (length << 16) | symbol, a sub table is
+   SUB_FLAG | (index bits << 24) | offset */
+static const unsigned int SUB_FLAG = 1u << 31;
+static const unsigned int BAD_ENTRY = 1u << 16;  // a 1 bit code of 0
+static const int ROOT_BITS = 10;
+static const int SUB_BITS = 8;
+static const int FAST_LOOP_CODES = 16;  // fewer are left to the tail loop
+
+/* countPairs: the bytes from which the 16-bit tables pay for their
+   clearing and merging */
+static const size_t PAIR_TABLE_MIN_BYTES = 1 << 18;
+
+/* the n low bits of a 64-bit value set */
+static ALWAYS_INLINE unsigned long long lowMask(int n) {
+    return n >= 64 ? ~0ULL : (1ULL << n) - 1;
+}
+
+/* the 8 bytes at p as a big endian number */
+static ALWAYS_INLINE unsigned long long load64(const byte* p) {
+    unsigned long long value;
+    memcpy(&value, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/* store the 4 bytes of value at p, big endian */
+static ALWAYS_INLINE void store32(byte* p, unsigned int value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    memcpy(p, &value, 4);
+}
+
+/* Helper loop of countBytes, with 4 tables so that a run of one byte does
+      not wait on its own count */
+static ALWAYS_INLINE void countLoop(const byte* data, size_t n,
+                                    unsigned int tables[4][256]) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned long long word = load64(data + i);
+        tables[0][word >> 56]++;
+        tables[1][(word >> 48) & 255]++;
+        tables[2][(word >> 40) & 255]++;
+        tables[3][(word >> 32) & 255]++;
+        tables[0][(word >> 24) & 255]++;
+        tables[1][(word >> 16) & 255]++;
+        tables[2][(word >> 8) & 255]++;
+        tables[3][word & 255]++;
+    }
+    for (; i < n; i++) {
+        tables[0][data[i]]++;
+    }
+}
+
+/* Helper loop of countPairs, the pairs of n bytes, n even, counted into
+      freqs */
+static ALWAYS_INLINE void pairLoop(const byte* data, size_t n,
+                                   unsigned int* freqs) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned long long word = load64(data + i);
+        freqs[word >> 48]++;
+        freqs[(word >> 32) & 65535]++;
+        freqs[(word >> 16) & 65535]++;
+        freqs[word & 65535]++;
+    }
+    for (; i < n; i += 2) {
+        freqs[(data[i] << 8) | data[i + 1]]++;
+    }
+}
+
+/* Helper loop of countPairs, the pairs of n bytes, n even, counted into
+      two 16-bit tables taking turns, so that a run of one pair does not
+      wait on its own count; a count that wraps to 0 adds 65536 to freqs */
+static ALWAYS_INLINE void pairLoop16(const byte* data, size_t n,
+                                     unsigned short* even,
+                                     unsigned short* odd,
+                                     unsigned int* freqs) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned long long word = load64(data + i);
+        unsigned int pairs[4] = {(unsigned int)(word >> 48),
+                                 (unsigned int)(word >> 32) & 65535,
+                                 (unsigned int)(word >> 16) & 65535,
+                                 (unsigned int)word & 65535};
+        if (__builtin_expect(++even[pairs[0]] == 0, 0)) {
+            freqs[pairs[0]] += 65536;
+        }
+        if (__builtin_expect(++odd[pairs[1]] == 0, 0)) {
+            freqs[pairs[1]] += 65536;
+        }
+        if (__builtin_expect(++even[pairs[2]] == 0, 0)) {
+            freqs[pairs[2]] += 65536;
+        }
+        if (__builtin_expect(++odd[pairs[3]] == 0, 0)) {
+            freqs[pairs[3]] += 65536;
+        }
+    }
+    for (; i < n; i += 2) {
+        freqs[(data[i] << 8) | data[i + 1]]++;
+    }
+}
+
+/* Helper of countPairs, the odd last byte of n, paired with 0 */
+static ALWAYS_INLINE void countLastPair(const byte* data, size_t n,
+                                        unsigned int* freqs) {
+    if (n % 2 == 1) {
+        freqs[data[n - 1] << 8]++;
+    }
+}
+
+/* Helper loop of packCodes, 4 bytes stored at once */
+static ALWAYS_INLINE size_t packLoop(const byte* symbols, size_t n,
+                                     const unsigned long long* codes,
+                                     const unsigned char* lengths,
+                                     unsigned long long& acc, int& accBits,
+                                     byte* out) {
+    unsigned long long bits = acc;
+    int count = accBits;
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        int length = lengths[symbols[i]];
+        // only a long code after many pending bits needs the bytes out
+        if (count > 64 - length) {
+            while (count >= 8) {
+                count -= 8;
+                out[k++] = (byte)(bits >> count);
+            }
+        }
+        bits = (bits << length) | codes[symbols[i]];
+        count += length;
+        if (count >= 32) {
+            count -= 32;
+            store32(out + k, (unsigned int)(bits >> count));
+            k += 4;
+        }
+    }
+    while (count >= 8) {
+        count -= 8;
+        out[k++] = (byte)(bits >> count);
+    }
+    acc = bits & lowMask(count);
+    accBits = count;
+    return k;
+}
+
+/* Helper for unpackLoop, decode the code at the top of window
+      return: the number of bits of the code */
+static ALWAYS_INLINE int decodeOne(unsigned long long window,
+                                   const unsigned int* entries, int rootBits,
+                                   unsigned int& symbol) {
+    // the root table, then the sub tables of a long code
+    int width = rootBits;
+    int used = 0;
+    unsigned int entry = entries[window >> (64 - width)];
+    while (entry & SUB_FLAG) {
+        used += width;
+        width = (entry >> 24) & 31;
+        unsigned long long index = (window << used) >> (64 - width);
+        entry = entries[(entry & 0xFFFFFF) + index];
+    }
+    symbol = entry & 0xFFFF;
+    return used + ((entry >> 16) & 255);
+}
+
+/* Helper loop of unpackCodes. The fast loop decodes, with no check per
+      code, as many codes as surely end 8 bytes before the end of in, from
+      one load as long as the longest code still fits in it. The tail loop
+      checks every code */
+template <typename T>
+static ALWAYS_INLINE size_t unpackLoop(const byte* in, size_t inBytes,
+                                       unsigned long long& bitPos,
+                                       const BitKernels::DecodeTable& table,
+                                       T* out, size_t n) {
+    const unsigned int* entries = table.entries.data();
+    int rootBits = table.rootBits;
+    int maxLength = table.maxLength;
+    unsigned long long pos = bitPos;
+    size_t i = 0;
+    unsigned int symbol;
+    while (i < n && inBytes >= 8 && pos < (inBytes - 8) * 8) {
+        unsigned long long safe = ((inBytes - 8) * 8 - pos) / maxLength;
+        if (safe < FAST_LOOP_CODES) break;
+        size_t end = safe < n - i ? i + safe : n;
+        while (i < end) {
+            unsigned long long window = load64(in + (pos >> 3)) << (pos & 7);
+            int valid = 64 - (int)(pos & 7);
+            do {
+                int used = decodeOne(window, entries, rootBits, symbol);
+                out[i++] = (T)symbol;
+                window <<= used;
+                valid -= used;
+                pos += used;
+            } while (i < end && valid >= maxLength);
+        }
+    }
+    while (i < n && (pos >> 3) + 8 <= inBytes) {
+        unsigned long long window = load64(in + (pos >> 3)) << (pos & 7);
+        pos += decodeOne(window, entries, rootBits, symbol);
+        out[i++] = (T)symbol;
+    }
+    bitPos = pos;
+    return i;
+}
+
+/* the generic variant, plain C++ */
+static void countBytesGeneric(const byte* data, size_t n,
+                              unsigned int* freqs) {
+    unsigned int tables[4][256] = {{0}};
+    countLoop(data, n, tables);
+    for (int i = 0; i < 256; i++) {
+        freqs[i] += tables[0][i] + tables[1][i] + tables[2][i] + tables[3][i];
+    }
+}
+
+static void mergePairsGeneric(unsigned short* tables, unsigned int* freqs) {
+    for (int i = 0; i < 65536; i++) {
+        freqs[i] += tables[i] + tables[65536 + i];
+    }
+    memset(tables, 0, 2 * 65536 * sizeof(unsigned short));
+}
+
+static size_t packCodesGeneric(const byte* symbols, size_t n,
+                               const unsigned long long* codes,
+                               const unsigned char* lengths,
+                               unsigned long long& acc, int& accBits,
+                               byte* out) {
+    return packLoop(symbols, n, codes, lengths, acc, accBits, out);
+}
+
+static size_t unpackCodesGeneric(const byte* in, size_t inBytes,
+                                 unsigned long long& bitPos,
+                                 const BitKernels::DecodeTable& table,
+                                 byte* out, size_t n) {
+    return unpackLoop(in, inBytes, bitPos, table, out, n);
+}
+
+static size_t unpackCodes16Generic(const byte* in, size_t inBytes,
+                                   unsigned long long& bitPos,
+                                   const BitKernels::DecodeTable& table,
+                                   unsigned short* out, size_t n) {
+    return unpackLoop(in, inBytes, bitPos, table, out, n);
+}
+
+#if HAS_X86_KERNELS
+/* The BMI2 variant, the bit loops compiled to shlx and shrx, variable
+   shifts that need not go through cl. The loops are shared with the
+   generic variant rather than written with _shrx_u64 and _bzhi_u64: an
+   intrinsic cannot be inlined into a template compiled for no target. The
+   byte and pair counts shift by constants, so they are the generic ones */
+__attribute__((target("bmi2"))) static size_t packCodesBmi2(
+    const byte* symbols, size_t n, const unsigned long long* codes,
+    const unsigned char* lengths, unsigned long long& acc, int& accBits,
+    byte* out) {
+    return packLoop(symbols, n, codes, lengths, acc, accBits, out);
+}
+
+__attribute__((target("bmi2"))) static size_t unpackCodesBmi2(
+    const byte* in, size_t inBytes, unsigned long long& bitPos,
+    const BitKernels::DecodeTable& table, byte* out, size_t n) {
+    return unpackLoop(in, inBytes, bitPos, table, out, n);
+}
+
+__attribute__((target("bmi2"))) static size_t unpackCodes16Bmi2(
+    const byte* in, size_t inBytes, unsigned long long& bitPos,
+    const BitKernels::DecodeTable& table, unsigned short* out, size_t n) {
+    return unpackLoop(in, inBytes, bitPos, table, out, n);
+}
+
+/* The AVX2 variant, the histogram tables merged 8 counts at a time. AVX2
+   has nothing for the bit loops, so its entry uses the BMI2 ones */
+__attribute__((target("avx2"))) static void countBytesAvx2(
+    const byte* data, size_t n, unsigned int* freqs) {
+    unsigned int tables[4][256] = {{0}};
+    countLoop(data, n, tables);
+    for (int i = 0; i < 256; i += 8) {
+        __m256i sum = _mm256_loadu_si256((const __m256i*)(freqs + i));
+        for (int t = 0; t < 4; t++) {
+            sum = _mm256_add_epi32(
+                sum, _mm256_loadu_si256((const __m256i*)(tables[t] + i)));
+        }
+        _mm256_storeu_si256((__m256i*)(freqs + i), sum);
+    }
+}
+
+__attribute__((target("avx2"))) static void mergePairsAvx2(
+    unsigned short* tables, unsigned int* freqs) {
+    const unsigned short* even16 = tables;
+    const unsigned short* odd16 = tables + 65536;
+    // the 16-bit tables widened and merged 8 counts at a time
+    for (int i = 0; i < 65536; i += 8) {
+        __m256i sum = _mm256_loadu_si256((const __m256i*)(freqs + i));
+        sum = _mm256_add_epi32(sum, _mm256_cvtepu16_epi32(_mm_loadu_si128(
+                                        (const __m128i*)(even16 + i))));
+        sum = _mm256_add_epi32(sum, _mm256_cvtepu16_epi32(_mm_loadu_si128(
+                                        (const __m128i*)(odd16 + i))));
+        _mm256_storeu_si256((__m256i*)(freqs + i), sum);
+    }
+    memset(tables, 0, 2 * 65536 * sizeof(unsigned short));
+}
+#endif
+
+/** The loops of one variant */
+struct KernelVariant {
+    const char* name;
+    void (*countBytes)(const byte*, size_t, unsigned int*);
+    void (*mergePairs)(unsigned short*, unsigned int*);
+    size_t (*packCodes)(const byte*, size_t, const unsigned long long*,
+                        const unsigned char*, unsigned long long&, int&,
+                        byte*);
+    size_t (*unpackCodes)(const byte*, size_t, unsigned long long&,
+                          const BitKernels::DecodeTable&, byte*, size_t);
+    size_t (*unpackCodes16)(const byte*, size_t, unsigned long long&,
+                            const BitKernels::DecodeTable&, unsigned short*,
+                            size_t);
+};
+
+static const KernelVariant VARIANTS[] = {
+    {"generic", countBytesGeneric, mergePairsGeneric, packCodesGeneric,
+     unpackCodesGeneric, unpackCodes16Generic},
+#if HAS_X86_KERNELS
+    {"bmi2", countBytesGeneric, mergePairsGeneric, packCodesBmi2,
+     unpackCodesBmi2, unpackCodes16Bmi2},
+    {"avx2", countBytesAvx2, mergePairsAvx2, packCodesBmi2, unpackCodesBmi2,
+     unpackCodes16Bmi2},
+#endif
+};
+
+/* the variant in use, the best one unless select changes it */
+static int& activeLevel() {
+    static int level = BitKernels::getBestLevel();
+    return level;
+}
+
+/* chosen when the program starts rather than by the first coder */
+static const int STARTUP_LEVEL = activeLevel();
+
+/* return the variant in use */
+int BitKernels::getLevel() { return activeLevel(); }
+
+/* return the name of the variant in use */
+string BitKernels::getLevelName() { return VARIANTS[activeLevel()].name; }
+
+/* return the best variant the CPU supports */
+int BitKernels::getBestLevel() {
+#if HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("bmi2")) {
+        return __builtin_cpu_supports("avx2") ? AVX2 : BMI2;
+    }
+#endif
+    return GENERIC;
+}
+
+/* Use the given variant, or the best one the CPU supports below it */
+int BitKernels::select(int level) {
+    int best = getBestLevel();
+    activeLevel() = level < GENERIC ? GENERIC : level > best ? best : level;
+    return activeLevel();
+}
+
+/* Add the count of every byte of data to freqs */
+void BitKernels::countBytes(const byte* data, size_t n, unsigned int* freqs) {
+    VARIANTS[activeLevel()].countBytes(data, n, freqs);
+}
+
+/* Add the count of every aligned pair of bytes of data to freqs */
+void BitKernels::countPairs(const byte* data, size_t n, unsigned int* freqs) {
+    if (n < PAIR_TABLE_MIN_BYTES) {
+        pairLoop(data, n & ~(size_t)1, freqs);
+        countLastPair(data, n, freqs);
+        return;
+    }
+    PairTables tables;
+    countPairs(data, n, tables, freqs);
+    mergePairs(tables, freqs);
+}
+
+/* Count the aligned pairs of n bytes into tables kept from call to call */
+void BitKernels::countPairs(const byte* data, size_t n, PairTables& tables,
+                            unsigned int* freqs) {
+    unsigned short* even = tables.counts.data();
+    pairLoop16(data, n & ~(size_t)1, even, even + 65536, freqs);
+    countLastPair(data, n, freqs);
+}
+
+/* Add the counts of tables to freqs and clear them */
+void BitKernels::mergePairs(PairTables& tables, unsigned int* freqs) {
+    VARIANTS[activeLevel()].mergePairs(tables.counts.data(), freqs);
+}
+
+/* Pack the codes of n symbols behind the bits of acc */
+size_t BitKernels::packCodes(const byte* symbols, size_t n,
+                             const unsigned long long* codes,
+                             const unsigned char* lengths,
+                             unsigned long long& acc, int& accBits,
+                             byte* out) {
+    return VARIANTS[activeLevel()].packCodes(symbols, n, codes, lengths, acc,
+                                             accBits, out);
+}
+
+/* Decode up to n symbols from the bits of in, from bitPos on */
+size_t BitKernels::unpackCodes(const byte* in, size_t inBytes,
+                               unsigned long long& bitPos,
+                               const DecodeTable& table, byte* out,
+                               size_t n) {
+    return VARIANTS[activeLevel()].unpackCodes(in, inBytes, bitPos, table,
+                                               out, n);
+}
+
+/* Decode up to n 16-bit symbols from the bits of in, from bitPos on */
+size_t BitKernels::unpackCodes(const byte* in, size_t inBytes,
+                               unsigned long long& bitPos,
+                               const DecodeTable& table, unsigned short* out,
+                               size_t n) {
+    return VARIANTS[activeLevel()].unpackCodes16(in, inBytes, bitPos, table,
+                                                 out, n);
+}
+
+/* Helper method for buildDecodeTable, fill the table of width index bits
+      at offset with the codes of symbols, depth bits of which the tables
+      before it took */
+static void fillTable(vector<unsigned int>& entries, unsigned int offset,
+                      int width, int depth, const vector<unsigned int>& symbols,
+                      const unsigned long long* codes,
+                      const unsigned char* lengths) {
+    vector<vector<unsigned int>> groups(1u << width);
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        unsigned int s = symbols[i];
+        int rest = lengths[s] - depth;
+        unsigned long long bits = codes[s] & lowMask(rest);
+        if (rest <= width) {
+            // every index starting with the code
+            unsigned int first = (unsigned int)(bits << (width - rest));
+            for (unsigned int j = 0; j < (1u << (width - rest)); j++) {
+                entries[offset + first + j] = ((unsigned int)rest << 16) | s;
+            }
+        } else {
+            groups[bits >> (rest - width)].push_back(s);
+        }
+    }
+    for (unsigned int index = 0; index < groups.size(); index++) {
+        if (groups[index].empty()) continue;
+        int longest = 0;
+        for (unsigned int i = 0; i < groups[index].size(); i++) {
+            int rest = lengths[groups[index][i]] - depth - width;
+            longest = rest > longest ? rest : longest;
+        }
+        int subWidth = longest < SUB_BITS ? longest : SUB_BITS;
+        unsigned int subOffset = entries.size();
+        entries.resize(subOffset + (1u << subWidth), BAD_ENTRY);
+        entries[offset + index] =
+            SUB_FLAG | ((unsigned int)subWidth << 24) | subOffset;
+        fillTable(entries, subOffset, subWidth, depth + width, groups[index],
+                  codes, lengths);
+    }
+}
+
+/* Decode the one code at the top of window */
+int BitKernels::decodeCode(unsigned long long window,
+                           const DecodeTable& table, unsigned int& symbol) {
+    return decodeOne(window, table.entries.data(), table.rootBits, symbol);
+}
+
+/* Build the decode table of a prefix code */
+void BitKernels::buildDecodeTable(const unsigned long long* codes,
+                                  const unsigned char* lengths,
+                                  unsigned int count, DecodeTable& table) {
+    vector<unsigned int> symbols;
+    table.maxLength = 0;
+    for (unsigned int s = 0; s < count; s++) {
+        if (lengths[s] > 0) {
+            symbols.push_back(s);
+            table.maxLength =
+                lengths[s] > table.maxLength ? lengths[s] : table.maxLength;
+        }
+    }
+    table.rootBits = table.maxLength < ROOT_BITS ? table.maxLength : ROOT_BITS;
+    if (table.rootBits == 0) {
+        table.rootBits = 1;
+    }
+    table.entries.assign(1u << table.rootBits, BAD_ENTRY);
+    fillTable(table.entries, 0, table.rootBits, 0, symbols, codes, lengths);
+}
@@ -0,0 +1,168 @@
+/**
+ * This file declares the BitKernels class, the bit packing, unpacking and
+ * histogram loops in several variants, one of which is picked at startup
+ * from the features of the CPU
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef BITKERNELS_HPP
+#define BITKERNELS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+/** The loops that touch every byte of a file, in variants for the CPU
+ * generations we run on:
+ *   GENERIC: plain C++ for any target, words of 8 bytes at a time
+ *   BMI2: the generic bit loops compiled to shlx/shrx shifts
+ *   AVX2: the BMI2 bit loops, and 256-bit merges of the histogram tables
+ * The best variant the CPU supports is selected once, when the program
+ * starts, with CPUID. Every variant gives the same results */
+class BitKernels {
+  public:
+    /* the variants, each one needing the features of those before it */
+    static const int GENERIC;
+    static const int BMI2;
+    static const int AVX2;
+
+    /* the longest code packCodes and unpackCodes take, so that a code and
+      the bits left of the byte before it fit in 64 bits */
+    static const int MAX_CODE_LENGTH;
+
+    /** A table decoding prefix codes several bits at a time. The next
+     * rootBits bits of the stream index the root table, an entry is either
+     * a symbol and the length of the rest of its code, or a sub table
+     * indexed by the bits after those, for longer codes */
+    struct DecodeTable {
+        vector<unsigned int> entries;  // the root table, then sub tables
+        int rootBits;                  // index bits of the root table
+        int maxLength;                 // the longest code
+        DecodeTable() : rootBits(0), maxLength(0) {}
+    };
+
+    /** Two 16-bit tables counting pairs over several calls of countPairs,
+     * half the cache of a 32-bit one. A count that wraps is carried into
+     * the 32-bit counts at once, the rest are added by mergePairs */
+    struct PairTables {
+        vector<unsigned short> counts;  // 2 tables of 65536, taking turns
+        PairTables() : counts(2 * 65536, 0) {}
+    };
+
+    /* return the variant in use */
+    static int getLevel();
+
+    /* return the name of the variant in use */
+    static string getLevelName();
+
+    /* return the best variant the CPU supports */
+    static int getBestLevel();
+
+    /* Use the given variant, or the best one the CPU supports below it,
+      such as for tests and benchmarks. Not to be called while coding
+      return: the variant in use */
+    static int select(int level);
+
+    /* Add the count of every byte of data to freqs
+      params:
+        data: the bytes
+        n: the number of bytes
+        freqs: 256 counts */
+    static void countBytes(const byte* data, size_t n, unsigned int* freqs);
+
+    /* Add the count of every aligned pair of bytes of data to freqs, the
+      first byte the high one, an odd last byte paired with 0. Large inputs
+      are counted into 16-bit tables, half the cache of a 32-bit one, every
+      count that wraps carried into freqs at once
+      params:
+        data: the bytes
+        n: the number of bytes
+        freqs: 65536 counts */
+    static void countPairs(const byte* data, size_t n, unsigned int* freqs);
+
+    /* Count the aligned pairs of n bytes the same way into tables, which
+      keep their counts from call to call, such as for the pieces of one
+      thread
+      params:
+        data: the bytes
+        n: the number of bytes
+        tables: the 16-bit counts
+        freqs: 65536 counts, the counts that wrap and an odd last byte */
+    static void countPairs(const byte* data, size_t n, PairTables& tables,
+                           unsigned int* freqs);
+
+    /* Add the counts of tables to freqs and clear them
+      params:
+        tables: the 16-bit counts
+        freqs: 65536 counts */
+    static void mergePairs(PairTables& tables, unsigned int* freqs);
+
+    /* Pack the codes of n symbols behind the bits of acc, most significant
+      bit first, and store every full byte
+      params:
+        symbols: the symbols to pack
+        n: the number of symbols
+        codes: the code of every symbol, root bit first
+        lengths: the length of every code, at most MAX_CODE_LENGTH
+        acc: the pending bits, the last accBits bits are kept, set to the
+          bits left at the end
+        accBits: the number of pending bits, 0 to 8, set to the bits left,
+          0 to 7
+        out: the full bytes, room for n * (longest code) / 8 + 8 bytes
+      return: the number of bytes stored */
+    static size_t packCodes(const byte* symbols, size_t n,
+                            const unsigned long long* codes,
+                            const unsigned char* lengths,
+                            unsigned long long& acc, int& accBits, byte* out);
+
+    /* Decode up to n symbols from the bits of in, from bitPos on, while 8
+      bytes can be loaded at the byte of bitPos. Codes that surely end 8
+      bytes before the end of in are decoded with no check per code
+      params:
+        in: the coded bytes
+        inBytes: the number of bytes of in
+        bitPos: the position of the next bit, set to the bit after the last
+          code decoded
+        table: the table of the codes, maxLength at most MAX_CODE_LENGTH
+        out: the symbols, room for n of them
+        n: the number of symbols wanted
+      return: the number of symbols decoded */
+    static size_t unpackCodes(const byte* in, size_t inBytes,
+                              unsigned long long& bitPos,
+                              const DecodeTable& table, byte* out, size_t n);
+
+    /* Decode up to n symbols of up to 16 bits, such as byte pairs, the
+      same way */
+    static size_t unpackCodes(const byte* in, size_t inBytes,
+                              unsigned long long& bitPos,
+                              const DecodeTable& table, unsigned short* out,
+                              size_t n);
+
+    /* Decode the one code at the top of window, for a decoder that mixes
+      codes with other bits
+      params:
+        window: the next bits, the first one the highest, at least
+          maxLength of them
+        table: the table of the codes, maxLength at most MAX_CODE_LENGTH
+        symbol: set to the symbol decoded
+      return: the number of bits of the code */
+    static int decodeCode(unsigned long long window, const DecodeTable& table,
+                          unsigned int& symbol);
+
+    /* Build the decode table of a prefix code
+      params:
+        codes: the code of every symbol, root bit first
+        lengths: the length of every code, 0 for a symbol with no code
+        count: the number of symbols, at most 65536
+        table: set to the table */
+    static void buildDecodeTable(const unsigned long long* codes,
+                                 const unsigned char* lengths,
+                                 unsigned int count, DecodeTable& table);
+};
+
+#endif  // BITKERNELS_HPP
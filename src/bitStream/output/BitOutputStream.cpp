@@ -7,6 +7,11 @@
  */
 #include "BitOutputStream.hpp"
 
+#include <vector>
+
+/* the number of symbols packed between two writes to the stream */
+static const size_t PACK_BLOCK_SIZE = 1 << 16;
+
 /* Sends the buffer to the output stream, and then
       clear the buffer to allow further use. */
 void BitOutputStream::flush() {
@@ -20,8 +25,114 @@ void BitOutputStream::flush() {
       if the buffer is full, then flush it */
 void BitOutputStream::writeBit(int i) {
     if (nbits == -1) {
-        flush();
+        putByte();
     }
     buf = buf + (i << nbits);
     nbits--;
 }
+
+/* Writes the n least significant bits of the given value to the bit
+      buffer, most significant one first. Same as n calls of writeBit */
+void BitOutputStream::writeBits(unsigned long long bits, int n) {
+    while (n > 0) {
+        if (nbits == -1) {
+            putByte();
+        }
+        // fill as much of the buffer as possible at once
+        int take = n < nbits + 1 ? n : nbits + 1;
+        unsigned int chunk = (bits >> (n - take)) & ((1u << take) - 1);
+        buf = buf + (chunk << (nbits + 1 - take));
+        nbits -= take;
+        n -= take;
+    }
+}
+
+/* Writes the codes of n symbols, packed by BitKernels. Same as a
+      writeBits of the code of every symbol */
+void BitOutputStream::writeCodes(const byte* symbols, size_t n,
+                                 const unsigned long long* codes,
+                                 const unsigned char* lengths) {
+    int longest = 0;
+    for (int i = 0; i < 256; i++) {
+        longest = lengths[i] > longest ? lengths[i] : longest;
+    }
+    if (n == 0 || longest > BitKernels::MAX_CODE_LENGTH) {
+        for (size_t i = 0; i < n; i++) {
+            writeBits(codes[symbols[i]], lengths[symbols[i]]);
+        }
+        return;
+    }
+
+    // the bits of the buffer go first
+    unsigned long long acc = (unsigned char)buf >> (nbits + 1);
+    int accBits = 7 - nbits;
+    vector<byte> block(PACK_BLOCK_SIZE * longest / 8 + 16);
+    // the last full byte stays in the buffer, as writeBits leaves it
+    byte last = 0;
+    bool held = false;
+    for (size_t i = 0; i < n; i += PACK_BLOCK_SIZE) {
+        size_t count = n - i < PACK_BLOCK_SIZE ? n - i : PACK_BLOCK_SIZE;
+        size_t bytes = BitKernels::packCodes(symbols + i, count, codes,
+                                             lengths, acc, accBits,
+                                             block.data());
+        if (bytes > 0) {
+            if (held) {
+                out.put(last);
+            }
+            out.write((const char*)block.data(), bytes - 1);
+            last = block[bytes - 1];
+            held = true;
+        }
+    }
+    if (held && accBits == 0) {
+        buf = last;
+        nbits = -1;
+        return;
+    }
+    if (held) {
+        out.put(last);
+    }
+    buf = (char)(acc << (8 - accBits));
+    nbits = 7 - accBits;
+}
+
+/* return the number of bits written to the buffer and not sent yet */
+int BitOutputStream::getBufferedBits() const { return 7 - nbits; }
+
+/* Writes bits packed behind those of the buffer. Same as writeBits of
+      them */
+void BitOutputStream::writePacked(const byte* bytes,
+                                  unsigned long long bits) {
+    if (bits <= (unsigned long long)getBufferedBits()) {
+        return;
+    }
+    byte first = (byte)buf | bytes[0];
+    size_t full = bits / 8;
+    int rest = bits % 8;
+    if (full == 0) {
+        buf = first;
+        nbits = 7 - rest;
+        return;
+    }
+    // the last full byte stays in the buffer when no bit follows it, as
+    // writeBits leaves it
+    if (rest == 0) {
+        full--;
+        rest = 8;
+    }
+    if (full > 0) {
+        out.put(first);
+        out.write((const char*)bytes + 1, full - 1);
+        first = bytes[full];
+    }
+    buf = first;
+    nbits = 7 - rest;
+}
+
+/* Sends the full buffer to the output stream without flushing the
+      stream itself, and then clear the buffer */
+void BitOutputStream::putByte() {
+    out.put(buf);
+    buf = 0;
+    nbits = 7;
+}
@@ -9,6 +9,7 @@
 #define BITOUTPUTSTREAM_HPP
 
 #include <iostream>
+#include "BitKernels.hpp"
 
 typedef unsigned char byte;
 
@@ -32,6 +33,42 @@ class BitOutputStream {
     /* Writes the least significant bit of the given int to the bit buffer.
       if the buffer is full, then flush it */
     void writeBit(int i);
+
+    /* Writes the n least significant bits of the given value to the bit
+      buffer, most significant one first. Same as n calls of writeBit
+      params:
+        bits: the value holding the bits to write
+        n: the number of bits, from 0 to 64 */
+    void writeBits(unsigned long long bits, int n);
+
+    /* Writes the codes of n symbols, packed by BitKernels. Same as a
+      writeBits of the code of every symbol
+      params:
+        symbols: the symbols to write
+        n: the number of symbols
+        codes: the code of every byte, root bit first
+        lengths: the length of every code, 0 writes nothing */
+    void writeCodes(const byte* symbols, size_t n,
+                    const unsigned long long* codes,
+                    const unsigned char* lengths);
+
+    /* return the number of bits written to the buffer and not sent yet,
+      0 to 8 */
+    int getBufferedBits() const;
+
+    /* Writes bits packed behind those of the buffer, such as by
+      HCTree::pack: the first getBufferedBits bits of bytes are zeros
+      standing for the buffer, the bits after them are written. Same as
+      writeBits of them
+      params:
+        bytes: the packed bits, most significant bit first
+        bits: the number of bits of bytes, those of the buffer included */
+    void writePacked(const byte* bytes, unsigned long long bits);
+
+  private:
+    /* Sends the full buffer to the output stream without flushing the
+      stream itself, and then clear the buffer */
+    void putByte();
 };
 
 #endif
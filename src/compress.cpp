@@ -5,14 +5,35 @@
  * Author: Yuening YANG
  * Email: y3yang@ucsd.edu
  */
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 #include "FileUtils.hpp"
+#include "ArchiveWriter.hpp"
+#include "BitKernels.hpp"
+#include "BlockSplitter.hpp"
+#include "WorkStealingPool.hpp"
+#include "ContextHCTree.hpp"
+#include "FrameWriter.hpp"
+#include "GlobalTree.hpp"
 #include "HCNode.hpp"
 #include "HCNode2.hpp"
 #include "HCTree.hpp"
 #include "HCTree2.hpp"
+#include "HCTreeN.hpp"
+#include "HistogramSampler.hpp"
+#include "InputFile.hpp"
+#include "LZCodec.hpp"
+#include "OutputFile.hpp"
+#include "PairHistogram.hpp"
+#include "ParallelEncoder.hpp"
+#include "SizeEstimator.hpp"
+#include "TunstallCode.hpp"
 #include "cxxopts.hpp"
 
 /* add pseudo compression with ascii encoding and naive header
@@ -61,38 +82,44 @@ void pseudoCompression(string inFileName, string outFileName) {
     delete hctree;
 }
 
+/* the number of bytes blockCompression and trueCompression count or code
+ * at once, even so that no pair is cut */
+static const unsigned int CODING_BLOCK_SIZE = 1 << 16;
+
 /* compression of encoding two symbols, also with bitwise i/o and small header
- * (final) */
-void blockCompression(string inFileName, string outFileName) {
+ * (final). An odd last byte is paired with 0, when counted and coded alike.
+ * The pairs are counted by threads, 0 for one per core */
+void blockCompression(string inFileName, string outFileName,
+                      unsigned int threads = 1) {
     vector<unsigned int> freqs(65536);
+    PairHistogram histogram(threads);
+    vector<byte> block(histogram.getBatchSize());
 
     // open the input file
     ifstream inFile;
     inFile.open(inFileName);
-    // read the input file
-    unsigned char first, second;
-    unsigned short symbol;
+    // read the input file, counted a batch of pairs at a time
     unsigned int total = 0;
-    bool half = false;
-    while (1) {
-        if (!half) {
-            first = inFile.get();
-        } else {
-            second = inFile.get();
-            if (inFile.eof()) {
-                second = 0;
-            }
-            symbol = (first << 8) + second;
-            freqs[symbol]++;
-        }
-        if (inFile.eof()) break;
-        half = !half;
-        total++;
+    while (inFile) {
+        inFile.read((char*)block.data(), block.size());
+        unsigned int n = inFile.gcount();
+        histogram.count(block.data(), n);
+        total += n;
     }
+    histogram.merge(freqs.data());
+    block.resize(CODING_BLOCK_SIZE);
 
-    // build HCTree
+    // build HCTree from the pairs that occur only
+    vector<byte2> symbols;
+    vector<unsigned int> counts;
+    for (unsigned int i = 0; i < freqs.size(); i++) {
+        if (freqs[i] > 0) {
+            symbols.push_back(i);
+            counts.push_back(freqs[i]);
+        }
+    }
     HCTree2* hctree = new HCTree2();
-    hctree->build(freqs);
+    hctree->build(symbols, counts);
 
     // open the output file
     ofstream outFile;
@@ -112,6 +139,7 @@ void blockCompression(string inFileName, string outFileName) {
     if (total == 0) {
         inFile.close();
         outFile.close();
+        delete hctree;
         return;
     }
 
@@ -129,17 +157,13 @@ void blockCompression(string inFileName, string outFileName) {
     inFile.clear();
     inFile.seekg(0, ios::beg);
     // write encoded text
-    half = false;
-    while (1) {
-        if (!half) {
-            first = inFile.get();
-        } else {
-            second = inFile.get();
-            symbol = (first << 8) + second;
-            hctree->encode(symbol, bitOut);
+    while (inFile) {
+        inFile.read((char*)block.data(), block.size());
+        unsigned int n = inFile.gcount();
+        for (unsigned int i = 0; i < n; i += 2) {
+            byte second = i + 1 < n ? block[i + 1] : 0;
+            hctree->encode((block[i] << 8) + second, bitOut);
         }
-        if (inFile.eof()) break;
-        half = !half;
     }
     bitOut.flush();
     // close files
@@ -150,26 +174,380 @@ void blockCompression(string inFileName, string outFileName) {
     delete hctree;
 }
 
-/* True compression with bitwise i/o and small header (final) */
-void trueCompression(string inFileName, string outFileName) {
+/* Close an output file written behind the coder
+ *      params: the file and its name
+ *      return: false if a write failed, reported, the output is incomplete
+ */
+bool closeOutput(OutputFile& outFile, string outFileName) {
+    if (outFile.close()) {
+        return true;
+    }
+    cerr << outFileName << ": write failed, output is incomplete" << endl;
+    return false;
+}
+
+/* chunks per window of framedCompression --split */
+static const unsigned int SPLIT_WINDOW_CHUNKS = 4;
+
+/* Framed compression: the input is cut into chunks coded on their own,
+ * each one in the mode with the smallest output among those the level
+ * allows to try, stored verbatim when no mode makes it smaller
+ *      params: names of the input file and the output file, the number of
+ *              bytes per chunk, the level of the mode selection, whether
+ *              to store every chunk, whether to keep both files out of
+ *              the page cache, the tree shared by every shard of a
+ *              data set, if any, referenced by its ID, whether chunks
+ *              may repeat the tree of an earlier one, and whether to cut
+ *              the chunks where the statistics change, at most chunkSize
+ *              bytes each, rather than every chunkSize bytes
+ *      return: false if the output cannot be written */
+bool framedCompression(string inFileName, string outFileName,
+                       unsigned int chunkSize, int level,
+                       bool storeAll = false, bool direct = false,
+                       const GlobalTree* globalTree = 0,
+                       bool reuseTrees = false, bool split = false) {
+    // open the input file, read ahead of the coder
+    unsigned long long total = FileUtils::getFileSize(inFileName);
+    InputFile inFile(inFileName, true, direct);
+    istream& in = inFile.getStream();
+
+    // open the output file, written behind the coder
+    OutputFile outFile(outFileName, true, direct);
+    ostream& out = outFile.getStream();
+    FrameWriter writer(out, total, chunkSize, level,
+                       globalTree ? &globalTree->getTree() : 0,
+                       globalTree ? globalTree->getId() : 0);
+    writer.setTreeReuse(reuseTrees);
+
+    if (split) {
+        // split a window of chunks at a time, the last segment of a window
+        // carried over as it may go on in the next one
+        BlockSplitter splitter(chunkSize);
+        vector<byte> window;
+        vector<unsigned int> lengths;
+        size_t capacity = (size_t)SPLIT_WINDOW_CHUNKS * chunkSize;
+        bool eof = false;
+        while (!eof) {
+            size_t kept = window.size();
+            window.resize(capacity);
+            in.read((char*)window.data() + kept, capacity - kept);
+            window.resize(kept + in.gcount());
+            eof = window.size() < capacity;
+            splitter.split(window.data(), window.size(), lengths);
+            size_t last = eof ? lengths.size() : lengths.size() - 1;
+            size_t start = 0;
+            for (size_t i = 0; i < last; i++) {
+                writer.writeChunk(vector<byte>(
+                    window.begin() + start,
+                    window.begin() + start + lengths[i]));
+                start += lengths[i];
+            }
+            window.erase(window.begin(), window.begin() + start);
+        }
+        writer.close();
+        inFile.close();
+        return closeOutput(outFile, outFileName);
+    }
+
+    // write every chunk, while the next one is read and the last written
+    vector<byte> chunk(chunkSize);
+    while (1) {
+        in.read((char*)chunk.data(), chunkSize);
+        chunk.resize(in.gcount());
+        if (chunk.empty()) break;
+        if (storeAll) {
+            writer.writeChunk(chunk, FrameFormat::STORED);
+        } else {
+            writer.writeChunk(chunk);
+        }
+        chunk.resize(chunkSize);
+    }
+    writer.close();
+    // close files
+    inFile.close();
+    return closeOutput(outFile, outFileName);
+}
+
+/* Histogram export: the first phase of a distributed compression, every
+ * shard counts its bytes, the counts are merged, then every shard is
+ * compressed with the tree of the merged counts (--tree)
+ *      params: names of the input files and the histogram file
+ *      return: false if the histogram cannot be written */
+bool exportHistogram(const vector<string>& inFileNames,
+                     string histogramName) {
+    vector<unsigned long long> freqs(256, 0);
+    for (unsigned int i = 0; i < inFileNames.size(); i++) {
+        GlobalTree::countFile(inFileNames[i], freqs);
+    }
+    return GlobalTree::writeHistogram(histogramName, freqs);
+}
+
+/* Histogram merge: the counts of many histogram files added up into one,
+ * a local stand-in for the reduce step of a cluster
+ *      params: names of the histogram files and the merged file
+ *      return: false if an input is not a histogram or the output cannot
+ *              be written */
+bool mergeHistograms(const vector<string>& histogramNames,
+                     string mergedName) {
+    vector<unsigned long long> freqs(256, 0);
+    for (unsigned int i = 0; i < histogramNames.size(); i++) {
+        if (!GlobalTree::readHistogram(histogramNames[i], freqs)) {
+            cerr << histogramNames[i] << " is not a histogram" << endl;
+            return false;
+        }
+    }
+    return GlobalTree::writeHistogram(mergedName, freqs);
+}
+
+/* Archive compression: many files packed into one archive with a file
+ * table, the small ones may share one tree built from all of them
+ *      params: names of the input files and the archive, the number of
+ *              bytes per chunk, the level of the mode selection, and
+ *              whether to share a tree
+ *      return: false if a name cannot be stored or an input cannot be
+ *              read, nothing is written then, or if the archive cannot be
+ *              written */
+bool archiveCompression(const vector<string>& inFileNames,
+                        string outFileName, unsigned int chunkSize, int level,
+                        bool isSharedTree) {
+    for (unsigned int i = 0; i < inFileNames.size(); i++) {
+        string name = ArchiveFormat::normalizeName(inFileNames[i]);
+        if (name.empty() || name.size() > ArchiveFormat::MAX_NAME_LENGTH) {
+            cerr << inFileNames[i] << ": cannot be stored under this name"
+                 << endl;
+            return false;
+        }
+        ifstream inFile;
+        inFile.open(inFileNames[i], ios::binary);
+        if (!inFile.is_open()) {
+            cerr << inFileNames[i] << ": cannot be read" << endl;
+            return false;
+        }
+        inFile.close();
+    }
+    ofstream outFile;
+    outFile.open(outFileName, ios::binary);
+    if (!outFile.is_open()) {
+        cerr << outFileName << ": write failed, output is incomplete" << endl;
+        return false;
+    }
+    ArchiveWriter* writer;
+    if (isSharedTree) {
+        // the histogram of every small file, read once more to be written
+        vector<unsigned int> sharedFreqs(256, 0);
+        vector<byte> data;
+        for (unsigned int i = 0; i < inFileNames.size(); i++) {
+            FileUtils::readFile(inFileNames[i], data);
+            if (data.size() <= ArchiveWriter::SMALL_FILE_SIZE) {
+                for (unsigned int j = 0; j < data.size(); j++) {
+                    sharedFreqs[data[j]]++;
+                }
+            }
+        }
+        writer = new ArchiveWriter(outFile, chunkSize, level, sharedFreqs);
+    } else {
+        writer = new ArchiveWriter(outFile, chunkSize, level);
+    }
+
+    bool read = true;
+    vector<byte> data;
+    for (unsigned int i = 0; i < inFileNames.size(); i++) {
+        if (!FileUtils::readFile(inFileNames[i], data)) {
+            cerr << inFileNames[i] << ": cannot be read" << endl;
+            read = false;
+            break;
+        }
+        writer->addFile(inFileNames[i], data);
+    }
+    writer->close();
+    outFile.close();
+    bool written = !outFile.fail();
+    if (!written) {
+        cerr << outFileName << ": write failed, output is incomplete" << endl;
+    }
+
+    // release memory
+    delete writer;
+    return read && written;
+}
+
+/* Batch compression: every input file, and every file below an input
+ * directory, compressed on its own to the same path under the output
+ * directory. The files run on a work stealing pool, each thread starting
+ * with its largest ones
+ *      params: names of the inputs and of the output directory, the
+ *              number of threads, 0 for one per core, and the compression
+ *              of one file from an input name to an output name
+ *      return: false if an input cannot be read or an output cannot be
+ *              written, the others are written */
+bool batchCompression(const vector<string>& inNames, string outDirName,
+                      unsigned int threads,
+                      function<bool(string, string)> compressFile) {
+    vector<string> inFileNames;
+    for (unsigned int i = 0; i < inNames.size(); i++) {
+        if (FileUtils::isDirectory(inNames[i])) {
+            FileUtils::listFiles(inNames[i], inFileNames);
+        } else {
+            inFileNames.push_back(inNames[i]);
+        }
+    }
+
+    // smallest first, the newest task of a queue runs first
+    bool ok = true;
+    vector<pair<unsigned long long, string>> files;
+    for (unsigned int i = 0; i < inFileNames.size(); i++) {
+        // earlier outputs are not inputs
+        if (FileUtils::isInside(inFileNames[i], outDirName)) {
+            continue;
+        }
+        ifstream inFile;
+        inFile.open(inFileNames[i], ios::binary);
+        if (!inFile.is_open()) {
+            cerr << inFileNames[i] << ": cannot be read, skipped" << endl;
+            ok = false;
+            continue;
+        }
+        inFile.close();
+        files.push_back(make_pair(FileUtils::getFileSize(inFileNames[i]),
+                                  inFileNames[i]));
+    }
+    sort(files.begin(), files.end());
+
+    WorkStealingPool pool(threads);
+    atomic<bool> written(true);
+    for (unsigned int i = 0; i < files.size(); i++) {
+        string inFileName = files[i].second;
+        // the path below the output directory, as archives store it
+        string outFileName =
+            outDirName + "/" + ArchiveFormat::normalizeName(inFileName);
+        FileUtils::makeParentDirs(outFileName);
+        pool.submit([=, &written]() {
+            if (!compressFile(inFileName, outFileName)) {
+                written = false;
+            }
+        });
+    }
+    pool.run();
+    return ok && written;
+}
+
+/* True compression with bitwise i/o and small header (final)
+ *      params: names of the input file and the output file, the fraction
+ *              of the input the histogram is sampled from, all of it by
+ *              default, and the number of threads coding it, 0 for one
+ *              per core */
+bool trueCompression(string inFileName, string outFileName,
+                     double sampleRate = 1, unsigned int threads = 1) {
     vector<unsigned int> freqs(256);
+    vector<byte> block(CODING_BLOCK_SIZE);
+    unsigned int total = 0;
+
+    // a sampled histogram reads only its blocks, without read ahead
+    if (sampleRate < 1) {
+        total = FileUtils::getFileSize(inFileName);
+        ifstream sampleFile;
+        sampleFile.open(inFileName, ios::binary);
+        HistogramSampler::sample(sampleFile, total, sampleRate, freqs);
+        sampleFile.close();
+    }
+
+    // open the input file, read ahead of the coder
+    InputFile inFile(inFileName);
+    istream& in = inFile.getStream();
+    // read the input file, counted a block at a time
+    while (sampleRate >= 1 && in) {
+        in.read((char*)block.data(), CODING_BLOCK_SIZE);
+        BitKernels::countBytes(block.data(), in.gcount(), freqs.data());
+        total += in.gcount();
+    }
+
+    // build HCTree
+    HCTree* hctree = new HCTree();
+    hctree->build(freqs);
+
+    // incompressible input: when the header, tree and codes are not smaller
+    // than a frame of stored chunks, store the file instead
+    unsigned long long storedBytes =
+        total + FrameFormat::getOverhead(
+                    (total + FrameFormat::DEFAULT_CHUNK_SIZE - 1) /
+                    FrameFormat::DEFAULT_CHUNK_SIZE);
+    if (total > 0 && SizeEstimator::byteModeBytes(freqs) >= storedBytes) {
+        inFile.close();
+        delete hctree;
+        return framedCompression(inFileName, outFileName,
+                                 FrameFormat::DEFAULT_CHUNK_SIZE,
+                                 ChunkCodec::FASTEST_LEVEL, true);
+    }
+
+    // open the output file, written behind the coder
+    OutputFile outFile(outFileName);
+    ostream& out = outFile.getStream();
+    // prepare the bit output stream
+    BitOutputStream bitOut(out);
+
+    // write the header
+    byte bit;
+    // total number, can be up to 2ˆ32 = 4GB
+    for (int i = 3; i > -1; i--) {
+        bit = (total >> (8 * i)) & 255;
+        out << bit;
+    }
+
+    // check empty file
+    if (total == 0) {
+        inFile.close();
+        delete hctree;
+        return closeOutput(outFile, outFileName);
+    }
+
+    // distinct characters
+    byte count = 0;
+    count = ((hctree->getDistinctChars() - 1) & 255);
+    out << count;
+    hctree->getTree(bitOut);
+
+    // reset to read input file from beginning
+    in.clear();
+    in.seekg(0, ios::beg);
+    // write encoded text, packed a batch at a time, a piece per thread
+    ParallelEncoder encoder(*hctree, threads);
+    block.resize(max((size_t)CODING_BLOCK_SIZE, encoder.getBatchSize()));
+    while (in) {
+        in.read((char*)block.data(), block.size());
+        encoder.encode(block.data(), in.gcount(), bitOut);
+    }
+    bitOut.flush();
+    // close files
+    inFile.close();
+    bool written = closeOutput(outFile, outFileName);
+
+    // release memory
+    delete hctree;
+    return written;
+}
+
+/* Order-1 context compression: every byte is coded with the tree of the
+ * cluster its previous byte belongs to, with bitwise i/o (final) */
+void contextCompression(string inFileName, string outFileName) {
+    vector<vector<unsigned int>> freqs(256, vector<unsigned int>(256));
 
     // open the input file
     ifstream inFile;
     inFile.open(inFileName);
     // read the input file
-    unsigned char c;
+    unsigned char c, prev = 0;
     unsigned int total = 0;
     while (1) {
         c = inFile.get();
         if (inFile.eof()) break;
-        freqs[c]++;
+        freqs[prev][c]++;
+        prev = c;
         total++;
     }
 
-    // build HCTree
-    HCTree* hctree = new HCTree();
-    hctree->build(freqs);
+    // build the context model
+    ContextHCTree* model = new ContextHCTree();
+    model->build(freqs);
 
     // open the output file
     ofstream outFile;
@@ -189,23 +567,23 @@ void trueCompression(string inFileName, string outFileName) {
     if (total == 0) {
         inFile.close();
         outFile.close();
+        delete model;
         return;
     }
 
-    // distinct characters
-    byte count = 0;
-    count = ((hctree->getDistinctChars() - 1) & 255);
-    outFile << count;
-    hctree->getTree(bitOut);
+    // cluster map and one tree per cluster
+    model->getTree(bitOut);
 
     // reset to read input file from beginning
     inFile.clear();
     inFile.seekg(0, ios::beg);
     // write encoded text
+    prev = 0;
     while (1) {
         c = inFile.get();
         if (inFile.eof()) break;
-        hctree->encode(c, bitOut);
+        model->encode(prev, c, bitOut);
+        prev = c;
     }
     bitOut.flush();
     // close files
@@ -213,7 +591,208 @@ void trueCompression(string inFileName, string outFileName) {
     outFile.close();
 
     // release memory
-    delete hctree;
+    delete model;
+}
+
+/* LZ77 compression: back-references found with hash chains, then literals,
+ * lengths and distances coded with their own trees (final)
+ *      params: names of the input file and the output file, and the
+ *              match finder level from 1 (fastest) to 9 (best) */
+void lzCompression(string inFileName, string outFileName, int level) {
+    // the match finder needs the whole input at hand
+    vector<byte> data;
+    FileUtils::readFile(inFileName, data);
+    unsigned int total = data.size();
+
+    // open the output file
+    ofstream outFile;
+    outFile.open(outFileName);
+    // prepare the bit output stream
+    BitOutputStream bitOut(outFile);
+
+    // write the header
+    byte bit;
+    // total number, can be up to 2ˆ32 = 4GB
+    for (int i = 3; i > -1; i--) {
+        bit = (total >> (8 * i)) & 255;
+        outFile << bit;
+    }
+
+    // check empty file
+    if (total == 0) {
+        outFile.close();
+        return;
+    }
+
+    // both trees and the tokens
+    LZCodec::encode(data, level, bitOut);
+    bitOut.flush();
+    // close files
+    outFile.close();
+}
+
+/* Wide symbol compression: symbols of 1 to 4 bytes coded with the
+ * canonical code of the alphabet of those that occur, for records made of
+ * fields of that width (final)
+ *      params: names of the input file and the output file, and the bytes
+ *              per symbol */
+void wideCompression(string inFileName, string outFileName, int width) {
+    vector<byte> data;
+    FileUtils::readFile(inFileName, data);
+    unsigned int total = data.size();
+
+    // open the output file
+    ofstream outFile;
+    outFile.open(outFileName);
+    // prepare the bit output stream
+    BitOutputStream bitOut(outFile);
+
+    // write the header
+    byte bit;
+    // total number, can be up to 2ˆ32 = 4GB
+    for (int i = 3; i > -1; i--) {
+        bit = (total >> (8 * i)) & 255;
+        outFile << bit;
+    }
+
+    // check empty file
+    if (total == 0) {
+        outFile.close();
+        return;
+    }
+
+    // the width, the alphabet and the codes
+    outFile << (byte)width;
+    unordered_map<unsigned int, unsigned int> freqs;
+    HCTreeN::countSymbols(data.data(), data.size(), width, freqs);
+    HCTreeN hctree(width);
+    hctree.build(freqs);
+    hctree.getTree(bitOut);
+    hctree.encode(data.data(), data.size(), bitOut);
+    bitOut.flush();
+    // close files
+    outFile.close();
+}
+
+/* Tunstall compression: phrases of bytes coded as 16 bit codewords, from a
+ * dictionary built from the byte frequencies, for outputs that are decoded
+ * far more often than they are written
+ *      params: names of the input file and the output file */
+void tunstallCompression(string inFileName, string outFileName) {
+    vector<byte> data;
+    FileUtils::readFile(inFileName, data);
+    unsigned int total = data.size();
+
+    // open the output file
+    ofstream outFile;
+    outFile.open(outFileName);
+
+    // write the header
+    byte bit;
+    // total number, can be up to 2ˆ32 = 4GB
+    for (int i = 3; i > -1; i--) {
+        bit = (total >> (8 * i)) & 255;
+        outFile << bit;
+    }
+
+    // check empty file
+    if (total == 0) {
+        outFile.close();
+        return;
+    }
+
+    // the dictionary and the codewords
+    vector<unsigned int> freqs(256, 0);
+    BitKernels::countBytes(data.data(), data.size(), freqs.data());
+    TunstallCode code;
+    code.build(freqs);
+    code.writeDictionary(outFile);
+    vector<byte> codes;
+    code.encode(data.data(), data.size(), codes);
+    code.flush(codes);
+    outFile.write((const char*)codes.data(), codes.size());
+    // close files
+    outFile.close();
+}
+
+/* the bytes per block of the --analyze entropy profile when no
+ * --chunk-size is given */
+static const unsigned int ANALYZE_BLOCK_SIZE = 1 << 16;
+
+/* print one line of the analysis: the mode, its output bytes and the
+ * ratio of the output to the input */
+void printEstimate(string mode, unsigned long long bytes,
+                   unsigned long long total) {
+    cout << "  " << left << setw(10) << mode << right << setw(12) << bytes
+         << setw(9) << fixed << setprecision(3) << (double)bytes / total
+         << endl;
+}
+
+/* Analysis of the input without writing any output: the entropy, the
+ * exact output size of every Huffman mode from the histograms, the size of
+ * LZ and of the framed format, and the entropy of every block
+ *      params: name of the input file, the bytes per frame chunk, the bytes
+ *              per profile block, the level of the framed estimate and the
+ *              match finder level */
+void analyzeFile(string inFileName, unsigned int chunkSize,
+                 unsigned int blockSize, int level, int lzLevel) {
+    vector<byte> data;
+    FileUtils::readFile(inFileName, data);
+    unsigned long long total = data.size();
+    cout << inFileName << ": " << total << " bytes" << endl;
+    if (total == 0) {
+        return;
+    }
+
+    vector<unsigned int> freqs;
+    vector<unsigned int> pairFreqs;
+    vector<vector<unsigned int>> contextFreqs;
+    SizeEstimator::countBytes(data, freqs);
+    SizeEstimator::countPairs(data, pairFreqs);
+    SizeEstimator::countContexts(data, contextFreqs);
+    double order0 = SizeEstimator::entropy(freqs);
+    double order1 = SizeEstimator::contextEntropy(contextFreqs);
+    cout << fixed << setprecision(3);
+    cout << "order-0 entropy: " << order0 << " bits/byte, "
+         << (unsigned long long)(order0 * total / 8) << " bytes" << endl;
+    cout << "order-1 entropy: " << order1 << " bits/byte, "
+         << (unsigned long long)(order1 * total / 8) << " bytes" << endl;
+
+    cout << "  " << left << setw(10) << "mode" << right << setw(12) << "bytes"
+         << setw(9) << "ratio" << endl;
+    printEstimate("byte", SizeEstimator::byteModeBytes(freqs), total);
+    printEstimate("block", SizeEstimator::blockModeBytes(pairFreqs), total);
+    printEstimate("context", SizeEstimator::contextModeBytes(contextFreqs),
+                  total);
+    // LZ has no histogram before its tokens, it is encoded in memory
+    ostringstream lz;
+    BitOutputStream bitOut(lz);
+    LZCodec::encode(data, lzLevel, bitOut);
+    bitOut.flush();
+    printEstimate("lz", 4 + lz.str().size(), total);
+    // the frame: every chunk in the mode chosen for it, and the headers
+    unsigned long long framed = 0;
+    unsigned long long chunks = 0;
+    for (unsigned long long i = 0; i < total; i += chunkSize) {
+        vector<byte> chunk(data.begin() + i,
+                           data.begin() + min(i + chunkSize, total));
+        byte mode = ChunkCodec::chooseMode(chunk, level);
+        framed += ChunkCodec::estimate(chunk, mode, level);
+        chunks++;
+    }
+    framed += FrameFormat::getOverhead(chunks);
+    printEstimate("framed", framed, total);
+
+    cout << "entropy profile, " << blockSize << " bytes per block:" << endl;
+    for (unsigned long long i = 0; i < total; i += blockSize) {
+        vector<unsigned int> blockFreqs(256, 0);
+        unsigned long long end = min(i + blockSize, total);
+        for (unsigned long long j = i; j < end; j++) {
+            blockFreqs[data[j]]++;
+        }
+        cout << "  " << setw(12) << i << setw(8)
+             << SizeEstimator::entropy(blockFreqs) << endl;
+    }
 }
 
 /* Main program that runs the compress */
@@ -224,37 +803,251 @@ int main(int argc, char* argv[]) {
 
     bool isAsciiOutput = false;
     bool isBlockEncoding = false;
+    bool isContextEncoding = false;
+    bool isLZEncoding = false;
+    bool isTunstallEncoding = false;
+    int width = 0;
+    int lzLevel = LZMatcher::DEFAULT_LEVEL;
+    unsigned int chunkSize = 0;
+    int level = 0;
+    bool isAutoMode = false;
+    bool isAnalyzeMode = false;
+    string archiveName;
+    bool isSharedTree = false;
+    vector<string> moreFileNames;
+    string batchDirName;
+    string listFileName;
+    unsigned int threads = 0;
+    bool isDirect = false;
+    double sampleRate = 1;
+    string exportName;
+    string mergeName;
+    string treeName;
+    bool isTreeReuse = false;
+    bool isSplit = false;
     string inFileName, outFileName;
     options.allow_unrecognised_options().add_options()(
         "ascii", "Write output in ascii mode instead of bit strem",
         cxxopts::value<bool>(isAsciiOutput))(
         "block", "Encoding two byte symbols instead of one byte symbols",
         cxxopts::value<bool>(isBlockEncoding))(
+        "context", "Encoding each byte with a tree chosen by the previous byte",
+        cxxopts::value<bool>(isContextEncoding))(
+        "lz", "Finding repeated strings before the Huffman encoding",
+        cxxopts::value<bool>(isLZEncoding))(
+        "tunstall",
+        "Encoding phrases of bytes as fixed 16 bit codewords, larger than "
+        "Huffman but faster to decode",
+        cxxopts::value<bool>(isTunstallEncoding))(
+        "width",
+        "Encoding symbols of this many bytes, 1 to 4, for records of fields "
+        "that wide",
+        cxxopts::value<int>(width))(
+        "lz-level", "Match finder level for --lz, 1 (fastest) to 9 (best)",
+        cxxopts::value<int>(lzLevel))(
+        "chunk-size",
+        "Cutting the input into chunks of this many bytes, each one stored "
+        "verbatim when encoding does not make it smaller",
+        cxxopts::value<unsigned int>(chunkSize))(
+        "level",
+        "Picking the smallest mode of every chunk, trying more modes from "
+        "1 (stored or Huffman) to 9 (also pairs, contexts and LZ)",
+        cxxopts::value<int>(level))(
+        "auto", "Picking the smallest mode of every chunk at the default level",
+        cxxopts::value<bool>(isAutoMode))(
+        "analyze",
+        "Printing the entropy, the size of every mode and the entropy of "
+        "every chunk instead of compressing, no output file is needed",
+        cxxopts::value<bool>(isAnalyzeMode))(
+        "archive",
+        "Packing every input file into the given archive, with a file table",
+        cxxopts::value<string>(archiveName))(
+        "shared-tree",
+        "Letting the small files of an archive share one tree instead of "
+        "writing their own",
+        cxxopts::value<bool>(isSharedTree))(
+        "batch",
+        "Compressing every input file, and every file below an input "
+        "directory, to the same path under the given directory",
+        cxxopts::value<string>(batchDirName))(
+        "files-from",
+        "Adding the files listed one per line to the --batch inputs",
+        cxxopts::value<string>(listFileName))(
+        "threads",
+        "Number of --batch threads, or of threads coding one file of the "
+        "default mode or counting one of --block, one per core by default",
+        cxxopts::value<unsigned int>(threads))(
+        "direct",
+        "Reading and writing with O_DIRECT in chunks, keeping huge files "
+        "out of the page cache",
+        cxxopts::value<bool>(isDirect))(
+        "sample",
+        "Building the tree of the default mode from this fraction of the "
+        "input, such as 0.05, read in evenly spaced blocks; bytes left "
+        "out still get a code",
+        cxxopts::value<double>(sampleRate))(
+        "export-histogram",
+        "Writing the byte counts of every input file to the given histogram "
+        "instead of compressing",
+        cxxopts::value<string>(exportName))(
+        "merge-histograms",
+        "Adding up the histograms given as input files into the given one",
+        cxxopts::value<string>(mergeName))(
+        "tree",
+        "Compressing in chunks that may use the tree of the given merged "
+        "histogram, which uncompress needs too",
+        cxxopts::value<string>(treeName))(
+        "reuse-trees",
+        "Compressing in chunks that keep the tree of an earlier chunk until "
+        "a new one pays for its header, for long streams of stable "
+        "statistics",
+        cxxopts::value<bool>(isTreeReuse))(
+        "split",
+        "Compressing in chunks cut where the statistics change, each with "
+        "a tree of its own, for files mixing headers, tables and text",
+        cxxopts::value<bool>(isSplit))(
         "input", "", cxxopts::value<string>(inFileName))(
         "output", "", cxxopts::value<string>(outFileName))(
+        "files", "", cxxopts::value<vector<string>>(moreFileNames))(
         "h, help", "Print help and exit");
 
-    options.parse_positional({"input", "output"});
+    options.parse_positional({"input", "output", "files"});
     auto userOptions = options.parse(argc, argv);
 
-    if (userOptions.count("help") || !FileUtils::isValidFile(inFileName) ||
-        outFileName.empty()) {
+    bool isBatchMode = !batchDirName.empty();
+    bool isAllInputs =
+        !archiveName.empty() || !exportName.empty() || !mergeName.empty();
+    if (userOptions.count("help") ||
+        (!isBatchMode && !FileUtils::isValidFile(inFileName)) ||
+        (outFileName.empty() && !isAnalyzeMode && !isAllInputs &&
+         !isBatchMode) ||
+        width < 0 || width > HCTreeN::MAX_WIDTH) {
         cout << options.help({""}) << std::endl;
         exit(0);
     }
 
-    if (!FileUtils::isEmptyFile(inFileName)) {
-        if (isAsciiOutput) {
-            pseudoCompression(inFileName, outFileName);
-        } else if (isBlockEncoding) {
-            blockCompression(inFileName, outFileName);
+    // every positional argument is an input of the archive or histogram
+    vector<string> inFileNames;
+    if (isAllInputs) {
+        inFileNames.push_back(inFileName);
+        if (!outFileName.empty()) {
+            inFileNames.push_back(outFileName);
+        }
+        inFileNames.insert(inFileNames.end(), moreFileNames.begin(),
+                           moreFileNames.end());
+        for (unsigned int i = 0; i < inFileNames.size(); i++) {
+            if (!FileUtils::isValidFile(inFileNames[i])) {
+                return 1;
+            }
+        }
+    }
+
+    if (!exportName.empty()) {
+        return exportHistogram(inFileNames, exportName) ? 0 : 1;
+    }
+    if (!mergeName.empty()) {
+        return mergeHistograms(inFileNames, mergeName) ? 0 : 1;
+    }
+
+    if (!archiveName.empty()) {
+        if (!archiveCompression(
+                inFileNames, archiveName,
+                chunkSize > 0 ? chunkSize : FrameFormat::DEFAULT_CHUNK_SIZE,
+                level > 0 ? level : ChunkCodec::DEFAULT_LEVEL,
+                isSharedTree)) {
+            return 1;
+        }
+        return 0;
+    }
+
+    if (isAnalyzeMode) {
+        analyzeFile(
+            inFileName,
+            chunkSize > 0 ? chunkSize : FrameFormat::DEFAULT_CHUNK_SIZE,
+            chunkSize > 0 ? chunkSize : ANALYZE_BLOCK_SIZE,
+            level > 0 ? level : ChunkCodec::DEFAULT_LEVEL, lzLevel);
+        return 0;
+    }
+
+    if (isAutoMode && level == 0) {
+        level = ChunkCodec::DEFAULT_LEVEL;
+    }
+    // the tree of a data set, built once for all of its shards
+    GlobalTree* globalTree = 0;
+    if (!treeName.empty()) {
+        vector<unsigned long long> freqs(256, 0);
+        if (!GlobalTree::readHistogram(treeName, freqs)) {
+            cerr << treeName << " is not a histogram" << endl;
+            return 1;
+        }
+        globalTree = new GlobalTree(freqs);
+    }
+    if ((level > 0 || isDirect || globalTree || isTreeReuse || isSplit) &&
+        chunkSize == 0) {
+        chunkSize = FrameFormat::DEFAULT_CHUNK_SIZE;
+    }
+
+    // one file in the mode the options select
+    auto compressFile = [&](string inFileName, string outFileName) {
+        if (!FileUtils::isEmptyFile(inFileName)) {
+            if (isAsciiOutput) {
+                pseudoCompression(inFileName, outFileName);
+            } else if (isBlockEncoding) {
+                blockCompression(inFileName, outFileName,
+                                 isBatchMode ? 1 : threads);
+            } else if (isContextEncoding) {
+                contextCompression(inFileName, outFileName);
+            } else if (isLZEncoding) {
+                lzCompression(inFileName, outFileName, lzLevel);
+            } else if (width > 0) {
+                wideCompression(inFileName, outFileName, width);
+            } else if (isTunstallEncoding) {
+                tunstallCompression(inFileName, outFileName);
+            } else if (chunkSize > 0) {
+                return framedCompression(
+                    inFileName, outFileName, chunkSize,
+                    level > 0 ? level : ChunkCodec::FASTEST_LEVEL, false,
+                    isDirect, globalTree, isTreeReuse, isSplit);
+            } else {
+                return trueCompression(inFileName, outFileName, sampleRate,
+                                       isBatchMode ? 1 : threads);
+            }
         } else {
-            trueCompression(inFileName, outFileName);
+            ofstream outFile;
+            outFile.open(outFileName);
+            outFile.close();
         }
-    } else {
-        ofstream outFile;
-        outFile.open(outFileName);
-        outFile.close();
+        return true;
+    };
+
+    if (isBatchMode) {
+        vector<string> inNames;
+        if (!inFileName.empty()) {
+            inNames.push_back(inFileName);
+        }
+        if (!outFileName.empty()) {
+            inNames.push_back(outFileName);
+        }
+        inNames.insert(inNames.end(), moreFileNames.begin(),
+                       moreFileNames.end());
+        if (!listFileName.empty()) {
+            ifstream listFile;
+            listFile.open(listFileName);
+            string line;
+            while (getline(listFile, line)) {
+                if (!line.empty()) {
+                    inNames.push_back(line);
+                }
+            }
+            listFile.close();
+        }
+        bool ok =
+            batchCompression(inNames, batchDirName, threads, compressFile);
+        delete globalTree;
+        return ok ? 0 : 1;
     }
-    return 0;
+
+    bool written = compressFile(inFileName, outFileName);
+    delete globalTree;
+    return written ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,284 @@
+/**
+ * This file shows the implementation details of ContextHCTree class
+ * methods, which are declared in 'ContextHCTree.hpp' file.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "ContextHCTree.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+const unsigned int ContextHCTree::DEFAULT_CLUSTERS;
+
+/* Destructor, automatically call it to avoid memory leak */
+ContextHCTree::~ContextHCTree() { clear(); }
+
+/* Build the trees from the given order-1 frequency table
+      params:
+        freqs: freqs[prev][symbol] is the count of symbol following prev
+        maxClusters: upper bound of trees to build, between 1 and 256 */
+void ContextHCTree::build(const vector<vector<unsigned int>>& freqs,
+                          unsigned int maxClusters) {
+    clear();
+    if (maxClusters < 1) {
+        maxClusters = 1;
+    } else if (maxClusters > 256) {
+        maxClusters = 256;
+    }
+
+    // visit the used contexts from the heaviest to the lightest, so that
+    // the frequent contexts are the ones that open their own cluster
+    vector<unsigned long long> totals(256, 0);
+    vector<int> order;
+    for (int ctx = 0; ctx < 256; ctx++) {
+        for (int s = 0; s < 256; s++) {
+            totals[ctx] += freqs[ctx][s];
+        }
+        if (totals[ctx] > 0) {
+            order.push_back(ctx);
+        }
+    }
+    stable_sort(order.begin(), order.end(),
+                [&totals](int a, int b) { return totals[a] > totals[b]; });
+
+    // greedy pass: join the cheapest cluster, unless coding the context
+    // with its own tree (plus about 10 header bits per leaf and the growth
+    // of the cluster map) is cheaper
+    vector<vector<unsigned int>> models;
+    for (int ctx : order) {
+        int best = -1;
+        double bestCost = 0;
+        for (unsigned int k = 0; k < models.size(); k++) {
+            double cost = crossCost(freqs[ctx], models[k]);
+            if (best == -1 || cost < bestCost) {
+                best = k;
+                bestCost = cost;
+            }
+        }
+        unsigned int distinct = 0;
+        for (int s = 0; s < 256; s++) {
+            if (freqs[ctx][s] > 0) distinct++;
+        }
+        int width = 0, newWidth = 0;
+        while ((1u << width) < models.size()) width++;
+        while ((1u << newWidth) < models.size() + 1) newWidth++;
+        double ownCost = crossCost(freqs[ctx], freqs[ctx]) + 10 * distinct +
+                         8 + 256 * (newWidth - width);
+        if (best == -1 || (models.size() < maxClusters && ownCost < bestCost)) {
+            models.push_back(freqs[ctx]);
+            clusterOf[ctx] = byte(models.size() - 1);
+        } else {
+            for (int s = 0; s < 256; s++) {
+                models[best][s] += freqs[ctx][s];
+            }
+            clusterOf[ctx] = byte(best);
+        }
+    }
+
+    // one refinement pass: move every context to the cluster that codes it
+    // best now that the clusters are complete, then drop empty clusters
+    if (models.size() > 1) {
+        vector<int> assign(256, 0);
+        for (int ctx : order) {
+            int best = 0;
+            double bestCost = crossCost(freqs[ctx], models[0]);
+            for (unsigned int k = 1; k < models.size(); k++) {
+                double cost = crossCost(freqs[ctx], models[k]);
+                if (cost < bestCost) {
+                    best = k;
+                    bestCost = cost;
+                }
+            }
+            assign[ctx] = best;
+        }
+        vector<vector<unsigned int>> merged(models.size(),
+                                            vector<unsigned int>(256, 0));
+        for (int ctx : order) {
+            for (int s = 0; s < 256; s++) {
+                merged[assign[ctx]][s] += freqs[ctx][s];
+            }
+        }
+        vector<int> renumber(models.size(), -1);
+        models.clear();
+        for (unsigned int k = 0; k < merged.size(); k++) {
+            unsigned long long sum = 0;
+            for (int s = 0; s < 256; s++) {
+                sum += merged[k][s];
+            }
+            if (sum > 0) {
+                renumber[k] = models.size();
+                models.push_back(merged[k]);
+            }
+        }
+        for (int ctx : order) {
+            clusterOf[ctx] = byte(renumber[assign[ctx]]);
+        }
+    }
+
+    // empty input still gets one (empty) tree
+    if (models.empty()) {
+        models.push_back(vector<unsigned int>(256, 0));
+    }
+    for (unsigned int k = 0; k < models.size(); k++) {
+        HCTree* tree = new HCTree();
+        tree->build(models[k]);
+        trees.push_back(tree);
+        distincts.push_back(tree->getDistinctChars());
+    }
+}
+
+/* return the number of clusters (trees) in the model */
+unsigned int ContextHCTree::getClusters() const { return trees.size(); }
+
+/* return the cluster used to code symbols following prev */
+unsigned int ContextHCTree::getCluster(byte prev) const {
+    return clusterOf[prev];
+}
+
+/* Write the encoding bits of symbol in context prev to the given
+      BitOutputStream. For this function to work, must first build the model
+        prev: the byte before symbol (0 for the first byte)
+        symbol: a symbol to be encoded
+        out: the output stream, should be passed by reference */
+void ContextHCTree::encode(byte prev, byte symbol, BitOutputStream& out) const {
+    unsigned int k = clusterOf[prev];
+    // a one-leaf tree decodes without reading, so it must not write either
+    if (distincts[k] > 1) {
+        trees[k]->encode(symbol, out);
+    }
+}
+
+/* Get the sequence of bits from BitInputStream, decode, then return
+      params:
+        prev: the previously decoded byte (0 for the first byte)
+        in: the input stream, should be passed by reference
+      return:
+        the decoded symbol */
+byte ContextHCTree::decode(byte prev, BitInputStream& in) const {
+    return trees[clusterOf[prev]]->decode(in);
+}
+
+/* return the number of bits encode writes for the given order-1
+      frequencies, without writing them. For this function to work, must
+      first build the model
+      param: freqs[prev][symbol] is the count of symbol following prev */
+unsigned long long ContextHCTree::getEncodedBits(
+    const vector<vector<unsigned int>>& freqs) const {
+    unsigned long long bits = 0;
+    for (int ctx = 0; ctx < 256; ctx++) {
+        unsigned int k = clusterOf[ctx];
+        if (distincts[k] > 1) {
+            bits += trees[k]->getEncodedBits(freqs[ctx]);
+        }
+    }
+    return bits;
+}
+
+/* return the number of bits getTree writes */
+unsigned int ContextHCTree::getTreeBits() const {
+    unsigned int clusters = trees.size();
+    int width = 0;
+    while ((1u << width) < clusters) {
+        width++;
+    }
+    unsigned int bits = 8 + 256 * width;
+    for (unsigned int k = 0; k < clusters; k++) {
+        bits += 8 + trees[k]->getTreeBits();
+    }
+    return bits;
+}
+
+/* write the cluster map and every tree. can be used to reconstruct */
+void ContextHCTree::getTree(BitOutputStream& out) const {
+    unsigned int clusters = trees.size();
+    for (int i = 7; i > -1; i--) {
+        out.writeBit(((clusters - 1) >> i) & 1);
+    }
+    // every context stores its cluster index in just enough bits
+    int width = 0;
+    while ((1u << width) < clusters) {
+        width++;
+    }
+    for (int ctx = 0; ctx < 256; ctx++) {
+        for (int i = width - 1; i > -1; i--) {
+            out.writeBit((clusterOf[ctx] >> i) & 1);
+        }
+    }
+    for (unsigned int k = 0; k < clusters; k++) {
+        for (int i = 7; i > -1; i--) {
+            out.writeBit(((distincts[k] - 1) >> i) & 1);
+        }
+        trees[k]->getTree(out);
+    }
+}
+
+/* reconstruct the model according to the encoding header */
+bool ContextHCTree::reconstructTree(BitInputStream& in) {
+    clear();
+    unsigned int clusters = 0;
+    for (int i = 7; i > -1; i--) {
+        clusters = clusters + (in.readBit() << i);
+    }
+    clusters++;
+    int width = 0;
+    while ((1u << width) < clusters) {
+        width++;
+    }
+    for (int ctx = 0; ctx < 256; ctx++) {
+        unsigned int k = 0;
+        for (int i = width - 1; i > -1; i--) {
+            k = k + (in.readBit() << i);
+        }
+        if (k >= clusters) {
+            clear();
+            return false;
+        }
+        clusterOf[ctx] = byte(k);
+    }
+    for (unsigned int k = 0; k < clusters; k++) {
+        unsigned int count = 0;
+        for (int i = 7; i > -1; i--) {
+            count = count + (in.readBit() << i);
+        }
+        count++;
+        HCTree* tree = new HCTree();
+        bool valid = tree->reconstructTree(in, count);
+        trees.push_back(tree);
+        distincts.push_back(count);
+        if (!valid) {
+            clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Helper method for build, the estimated bits to code the counts of one
+      context with the (merged) counts of one cluster */
+double ContextHCTree::crossCost(const vector<unsigned int>& counts,
+                                const vector<unsigned int>& model) {
+    double total = 0;
+    for (int s = 0; s < 256; s++) {
+        total += model[s];
+    }
+    // half a count for every symbol, so unseen symbols are not free
+    double cost = 0;
+    for (int s = 0; s < 256; s++) {
+        if (counts[s] > 0) {
+            cost -= counts[s] * log2((model[s] + 0.5) / (total + 128.0));
+        }
+    }
+    return cost;
+}
+
+/* Helper method for build and the destructor, release all trees */
+void ContextHCTree::clear() {
+    for (unsigned int k = 0; k < trees.size(); k++) {
+        delete trees[k];
+    }
+    trees.clear();
+    distincts.clear();
+    clusterOf.assign(256, 0);
+}
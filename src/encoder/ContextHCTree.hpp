@@ -0,0 +1,91 @@
+/**
+ * This file declares the structure of ContextHCTree class, an order-1
+ * context model that keeps one HCTree per cluster of previous-byte contexts
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef CONTEXTHCTREE_HPP
+#define CONTEXTHCTREE_HPP
+
+#include <vector>
+#include "BitInputStream.hpp"
+#include "BitOutputStream.hpp"
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** This class defines a set of Huffman-encoding Trees selected by the
+ * previous byte. Similar contexts share one tree to bound the header size */
+class ContextHCTree {
+  private:
+    vector<byte> clusterOf;          // maps each previous byte to its cluster
+    vector<HCTree*> trees;           // one HCTree per cluster
+    vector<unsigned int> distincts;  // number of leaves of each tree
+
+  public:
+    /* the number of clusters used when none is given to build */
+    static const unsigned int DEFAULT_CLUSTERS = 16;
+
+    /* Constructor that initialize a ContextHCTree */
+    ContextHCTree() : clusterOf(256, 0) {}
+
+    /* Destructor, automatically call it to avoid memory leak */
+    ~ContextHCTree();
+
+    /* Build the trees from the given order-1 frequency table
+      params:
+        freqs: freqs[prev][symbol] is the count of symbol following prev
+        maxClusters: upper bound of trees to build, between 1 and 256 */
+    void build(const vector<vector<unsigned int>>& freqs,
+               unsigned int maxClusters = DEFAULT_CLUSTERS);
+
+    /* return the number of clusters (trees) in the model */
+    unsigned int getClusters() const;
+
+    /* return the cluster used to code symbols following prev */
+    unsigned int getCluster(byte prev) const;
+
+    /* Write the encoding bits of symbol in context prev to the given
+      BitOutputStream. For this function to work, must first build the model
+        prev: the byte before symbol (0 for the first byte)
+        symbol: a symbol to be encoded
+        out: the output stream, should be passed by reference */
+    void encode(byte prev, byte symbol, BitOutputStream& out) const;
+
+    /* Get the sequence of bits from BitInputStream, decode, then return
+      params:
+        prev: the previously decoded byte (0 for the first byte)
+        in: the input stream, should be passed by reference
+      return:
+        the decoded symbol */
+    byte decode(byte prev, BitInputStream& in) const;
+
+    /* return the number of bits encode writes for the given order-1
+      frequencies, without writing them. For this function to work, must
+      first build the model
+      param: freqs[prev][symbol] is the count of symbol following prev */
+    unsigned long long getEncodedBits(
+        const vector<vector<unsigned int>>& freqs) const;
+
+    /* return the number of bits getTree writes */
+    unsigned int getTreeBits() const;
+
+    /* write the cluster map and every tree. can be used to reconstruct */
+    void getTree(BitOutputStream& out) const;
+
+    /* reconstruct the model according to the encoding header
+      return: false if the header is corrupt, then the model is cleared */
+    bool reconstructTree(BitInputStream& in);
+
+  private:
+    /* Helper method for build, the estimated bits to code the counts of one
+      context with the (merged) counts of one cluster */
+    static double crossCost(const vector<unsigned int>& counts,
+                            const vector<unsigned int>& model);
+
+    /* Helper method for build and the destructor, release all trees */
+    void clear();
+};
+
+#endif  // CONTEXTHCTREE_HPP
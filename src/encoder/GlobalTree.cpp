@@ -0,0 +1,120 @@
+/**
+ * This file shows the implementation of GlobalTree class methods.
+ * Declaration can be found in 'GlobalTree.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "GlobalTree.hpp"
+
+#include <fstream>
+#include <sstream>
+#include "BitKernels.hpp"
+#include "BitOutputStream.hpp"
+
+/* the first line of a histogram file */
+static const string HISTOGRAM_MAGIC = "hc-histogram 1";
+
+/* Constructor of GlobalTree, builds the tree */
+GlobalTree::GlobalTree(const vector<unsigned long long>& freqs) : id(0) {
+    // HCNode counts are 32 bits, and so is the sum at the root
+    unsigned long long sum = 0;
+    for (unsigned int i = 0; i < freqs.size(); i++) {
+        sum += freqs[i];
+    }
+    unsigned long long divisor = sum / 0xFFFFFF00ULL + 1;
+    vector<unsigned int> counts(256, 0);
+    for (unsigned int i = 0; i < freqs.size() && i < 256; i++) {
+        counts[i] = freqs[i] / divisor;
+        if (freqs[i] > 0 && counts[i] == 0) {
+            counts[i] = 1;
+        }
+    }
+    tree.build(counts);
+    tree.buildDecodeTable();
+
+    // serialize the tree as a frame of the byte mode does, and hash it
+    ostringstream serialized;
+    unsigned int count = tree.getDistinctChars();
+    if (count > 0) {
+        BitOutputStream bitOut(serialized);
+        bitOut.writeBits(count - 1, 8);
+        tree.getTree(bitOut);
+        bitOut.flush();
+    }
+    string bytes = serialized.str();
+    id = 0xCBF29CE484222325ULL;
+    for (unsigned int i = 0; i < bytes.size(); i++) {
+        id = (id ^ (unsigned char)bytes[i]) * 0x100000001B3ULL;
+    }
+}
+
+/* return the tree */
+const HCTree& GlobalTree::getTree() const { return tree; }
+
+/* return the ID of the tree */
+unsigned long long GlobalTree::getId() const { return id; }
+
+/* Add the count of every byte of a file to freqs */
+void GlobalTree::countFile(string fileName,
+                           vector<unsigned long long>& freqs) {
+    freqs.resize(256, 0);
+    ifstream inFile;
+    inFile.open(fileName, ios::binary);
+    vector<byte> block(1 << 16);
+    while (inFile) {
+        inFile.read((char*)block.data(), block.size());
+        // a block is counted in 32 bits, the file in 64
+        vector<unsigned int> counts(256, 0);
+        BitKernels::countBytes(block.data(), inFile.gcount(), counts.data());
+        for (int i = 0; i < 256; i++) {
+            freqs[i] += counts[i];
+        }
+    }
+    inFile.close();
+}
+
+/* Add the counts of a histogram file to freqs */
+bool GlobalTree::readHistogram(string fileName,
+                               vector<unsigned long long>& freqs) {
+    freqs.resize(256, 0);
+    ifstream inFile;
+    inFile.open(fileName);
+    string line;
+    if (!getline(inFile, line) || line != HISTOGRAM_MAGIC) {
+        return false;
+    }
+    // the counts are checked before any is added
+    vector<unsigned long long> counts(256, 0);
+    while (getline(inFile, line)) {
+        if (line.empty()) continue;
+        istringstream fields(line);
+        unsigned int symbol;
+        unsigned long long count;
+        string rest;
+        if (!(fields >> symbol >> count) || symbol > 255 ||
+            (fields >> rest)) {
+            return false;
+        }
+        counts[symbol] += count;
+    }
+    for (int i = 0; i < 256; i++) {
+        freqs[i] += counts[i];
+    }
+    return true;
+}
+
+/* Write freqs as a histogram file */
+bool GlobalTree::writeHistogram(string fileName,
+                                const vector<unsigned long long>& freqs) {
+    ofstream outFile;
+    outFile.open(fileName);
+    outFile << HISTOGRAM_MAGIC << endl;
+    for (unsigned int i = 0; i < freqs.size() && i < 256; i++) {
+        if (freqs[i] > 0) {
+            outFile << i << " " << freqs[i] << endl;
+        }
+    }
+    outFile.close();
+    return !outFile.fail();
+}
@@ -0,0 +1,56 @@
+/**
+ * This file declares the GlobalTree class, a Huffman tree shared by many
+ * files, built from their merged byte histograms
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef GLOBALTREE_HPP
+#define GLOBALTREE_HPP
+
+#include <string>
+#include <vector>
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** A tree for the shards of a data set, which count their bytes apart,
+ * merge the counts, then all code with the one tree. Histograms are kept
+ * in text files:
+ *   hc-histogram 1
+ *   <byte> <count>   for every byte counted, one per line
+ * so merging is adding counts. The ID of the tree is the 64-bit FNV-1a
+ * hash of its serialized form, the distinct count and getTree, so equal
+ * decode tables have equal IDs */
+class GlobalTree {
+  private:
+    HCTree tree;           // the tree of the merged histogram
+    unsigned long long id;  // the hash of the serialized tree
+
+  public:
+    /* Constructor of GlobalTree, builds the tree, counts above 32 bits
+      are scaled down alike
+      param: the frequency of every byte, 256 of them */
+    explicit GlobalTree(const vector<unsigned long long>& freqs);
+
+    /* return the tree */
+    const HCTree& getTree() const;
+
+    /* return the ID of the tree */
+    unsigned long long getId() const;
+
+    /* Add the count of every byte of a file to freqs, resized to 256 */
+    static void countFile(string fileName, vector<unsigned long long>& freqs);
+
+    /* Add the counts of a histogram file to freqs, resized to 256
+      return: false if the file is not a histogram */
+    static bool readHistogram(string fileName,
+                              vector<unsigned long long>& freqs);
+
+    /* Write freqs as a histogram file
+      return: false if the file cannot be written */
+    static bool writeHistogram(string fileName,
+                               const vector<unsigned long long>& freqs);
+};
+
+#endif  // GLOBALTREE_HPP
@@ -7,6 +7,8 @@
  */
 #include "HCTree.hpp"
 
+#include <cstring>
+
 /* Destructor, automatically call it to avoid memory leak */
 HCTree::~HCTree() {
     // since deleteAll() will delete all nodes, no need to free
@@ -36,6 +38,7 @@ void HCTree::build(const vector<unsigned int>& freqs) {
         return;
     } else if (pq.size() == 1) {
         root = pq.top();
+        buildCodes();
         return;
     }
 
@@ -61,6 +64,7 @@ void HCTree::build(const vector<unsigned int>& freqs) {
     }
     // set root
     root = pq.top();
+    buildCodes();
 }
 
 /* return the number of leaves of HCTree */
@@ -85,24 +89,7 @@ void HCTree::encode(byte symbol, BitOutputStream& out) const {
     if (root == 0) {
         return;
     }
-    if (root->c0 == 0 && root->c1 == 0) {
-        out.writeBit(0);
-        return;
-    }
-
-    HCNode* ptr = leaves[symbol];
-    string buffer = "";
-    while (ptr != root) {
-        if (ptr->isZeroChild) {
-            buffer = '0' + buffer;
-        } else {
-            buffer = '1' + buffer;
-        }
-        ptr = ptr->p;
-    }
-    for (int i = 0; i < buffer.length(); i++) {
-        out.writeBit(buffer[i] - '0');
-    }
+    out.writeBits(codes[symbol], codeLengths[symbol]);
 }
 
 /* Write the encoding bits of given symbol to ostream. For
@@ -131,6 +118,48 @@ void HCTree::encode(byte symbol, ostream& out) const {
     out << buffer.c_str();
 }
 
+/* return the length of the code of the given symbol, 0 if the symbol
+      is not in the tree. For this function to work, must first build the
+      tree */
+unsigned int HCTree::getCodeLength(byte symbol) const {
+    return codeLengths[symbol];
+}
+
+/* return the code of the given symbol, root bit first */
+unsigned long long HCTree::getCode(byte symbol) const { return codes[symbol]; }
+
+/* return the number of bits encode writes for the given frequencies,
+      without writing them. For this function to work, must first build
+      the tree
+      param: a vector contains the frequency of charactors to be encoded */
+unsigned long long HCTree::getEncodedBits(
+    const vector<unsigned int>& freqs) const {
+    unsigned long long bits = 0;
+    for (int i = 0; i < 256; i++) {
+        bits += (unsigned long long)freqs[i] * codeLengths[i];
+    }
+    return bits;
+}
+
+/* return the number of bits getTree writes */
+unsigned int HCTree::getTreeBits() const {
+    if (root == 0) {
+        return 0;
+    }
+    // a lone leaf is written twice: 8 bits, then '1' + 8 bits
+    if (root->c0 == 0 && root->c1 == 0) {
+        return 17;
+    }
+    // every leaf is '1' + 8 bits, every inner node but the root is a '0'
+    unsigned int count = 0;
+    for (int i = 0; i < 256; i++) {
+        if (leaves[i] != 0) {
+            count++;
+        }
+    }
+    return 9 * count + (count - 2);
+}
+
 /* Get the sequence of bits from BitInputStream, decode, then return
       param:
         in: the input stream, should be passed by reference
@@ -183,6 +212,67 @@ byte HCTree::decode(istream& in) const {
     return ptr->symbol;
 }
 
+/* Write the encoding bits of n symbols at once */
+void HCTree::encode(const byte* symbols, size_t n,
+                    BitOutputStream& out) const {
+    if (root == 0) {
+        return;
+    }
+    out.writeCodes(symbols, n, codes.data(), codeLengths.data());
+}
+
+/* Pack the codes of n symbols into bytes, the same bits encode writes */
+size_t HCTree::pack(const byte* symbols, size_t n, int startBit,
+                    byte* out) const {
+    unsigned long long acc = 0;
+    int accBits = startBit;
+    size_t count = 0;
+    if (root != 0) {
+        count = BitKernels::packCodes(symbols, n, codes.data(),
+                                      codeLengths.data(), acc, accBits, out);
+    }
+    // the bits after the last full byte, zeros behind them
+    if (accBits > 0) {
+        out[count++] = (byte)(acc << (8 - accBits));
+    }
+    return count;
+}
+
+/* Decode n symbols at once */
+void HCTree::decode(BitInputStream& in, byte* symbols, size_t n) const {
+    if (root == 0) {
+        memset(symbols, ' ', n);
+        return;
+    }
+    // a one-leaf tree decodes without reading
+    if (root->c0 == 0 && root->c1 == 0) {
+        memset(symbols, root->symbol, n);
+        return;
+    }
+    if (decodeTable.entries.empty() ||
+        decodeTable.maxLength > BitKernels::MAX_CODE_LENGTH) {
+        for (size_t i = 0; i < n; i++) {
+            symbols[i] = decode(in);
+        }
+        return;
+    }
+    in.readCodes(decodeTable, symbols, n);
+}
+
+/* Build the table the decoding of many symbols at once takes */
+void HCTree::buildDecodeTable() {
+    if (root == 0 || (root->c0 == 0 && root->c1 == 0)) {
+        return;
+    }
+    BitKernels::buildDecodeTable(codes.data(), codeLengths.data(), 256,
+                                 decodeTable);
+}
+
+/* return the table buildDecodeTable built */
+const BitKernels::DecodeTable& HCTree::getDecodeTable() const {
+    return decodeTable;
+}
+
 /* Helper function for destructor. Recursively deletes all the nodes.
         argument: a pointer pointing to the root of the subtree to be deleted.
      */
@@ -234,9 +324,12 @@ void HCTree::getTree(BitOutputStream& out) const {
 };
 
 /* reconstruct the tree according to the encoding header */
-void HCTree::reconstructTree(BitInputStream& in, int total) {
+bool HCTree::reconstructTree(BitInputStream& in, int total) {
     if (total == 0) {
-        return;
+        return true;
+    }
+    if (total < 0 || total > 256) {
+        return false;
     }
     if (total == 1) {
         byte character = 0;
@@ -245,12 +338,19 @@ void HCTree::reconstructTree(BitInputStream& in, int total) {
         }
         root = new HCNode(0, character);
         leaves[character] = root;
-        return;
+        // getTree also writes the single leaf as '1' + 8 bits, skip it so
+        // that whatever follows the header is read from the right place
+        for (int i = 0; i < 9; i++) {
+            in.readBit();
+        }
+        buildCodes();
+        return true;
     }
 
     int c;
     byte character;
     int count = 0;
+    int inner = 1;  // a tree of total leaves has total - 1 inner nodes
     root = new HCNode(0, ' ');
     HCNode* ptr = root;
 
@@ -259,6 +359,10 @@ void HCTree::reconstructTree(BitInputStream& in, int total) {
     while (count < total) {
         // bit 0
         if (c == 0) {
+            if (inner == total - 1) {
+                return dropTree();
+            }
+            inner++;
             // create node
             if (ptr->c0 == 0) {
                 ptr->c0 = new HCNode(0, ' ');
@@ -278,6 +382,10 @@ void HCTree::reconstructTree(BitInputStream& in, int total) {
             for (int i = 7; i > -1; i--) {
                 character = character + (in.readBit() << i);
             }
+            // every symbol has one leaf
+            if (leaves[character] != 0) {
+                return dropTree();
+            }
             count++;
             leaf = new HCNode(0, character);
             // add to the leaves list
@@ -292,13 +400,61 @@ void HCTree::reconstructTree(BitInputStream& in, int total) {
             } else {
                 ptr->c1 = leaf;
                 ptr->c1->p = ptr;
-                if (count == total) break;
                 while (ptr != 0 && ptr->c1 != 0) {
                     ptr = ptr->p;
                 }
+                // the tree is complete once the last leaf is placed
+                if ((ptr == 0) != (count == total)) {
+                    return dropTree();
+                }
+                if (count == total) break;
             }
         }
         // get next
         c = in.readBit();
     }
+    if (ptr != 0) {
+        return dropTree();
+    }
+    buildCodes();
+    return true;
+}
+
+/* Helper method for reconstructTree, drop the nodes of a header that is
+      not a tree */
+bool HCTree::dropTree() {
+    deleteAll(root);
+    root = 0;
+    leaves.assign(256, 0);
+    return false;
+}
+
+/* Helper method for build and reconstructTree, fill the code table by
+      walking every leaf up to the root, so encode is one table lookup */
+void HCTree::buildCodes() {
+    if (root == 0) {
+        return;
+    }
+    // a one-leaf tree still writes a '0' for every symbol
+    if (root->c0 == 0 && root->c1 == 0) {
+        codes[root->symbol] = 0;
+        codeLengths[root->symbol] = 1;
+        return;
+    }
+    for (unsigned int i = 0; i < codes.size(); i++) {
+        codes[i] = 0;
+        codeLengths[i] = 0;
+        if (leaves[i] == 0) {
+            continue;
+        }
+        unsigned char length = 0;
+        // reconstructTree links children without isZeroChild
+        for (HCNode* ptr = leaves[i]; ptr != root; ptr = ptr->p) {
+            if (ptr->p->c1 == ptr) {
+                codes[i] |= 1ULL << length;
+            }
+            length++;
+        }
+        codeLengths[i] = length;
+    }
 }
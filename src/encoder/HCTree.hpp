@@ -24,9 +24,14 @@ class HCTree {
     HCNode* root;            // the root of HCTree
     vector<HCNode*> leaves;  // a vector storing pointers to all leaf HCNodes
 
+    vector<unsigned long long> codes;   // code of every leaf, root bit first
+    vector<unsigned char> codeLengths;  // length of every code, 0 if no leaf
+    BitKernels::DecodeTable decodeTable;  // empty until buildDecodeTable
+
   public:
     /* Constructor that initialize a HCTree */
-    HCTree() : root(0) { leaves.reserve(256); }
+    HCTree()
+        : root(0), leaves(256, 0), codes(256, 0), codeLengths(256, 0) {}
 
     /* Destructor, automatically call it to avoid memory leak */
     ~HCTree();
@@ -51,6 +56,28 @@ class HCTree {
         out: the output stream, should be passed by reference */
     void encode(byte symbol, ostream& out) const;
 
+    /* Write the encoding bits of n symbols at once, same as encoding them
+      one by one. For this function to work, must first build the tree
+      params:
+        symbols: the symbols to be encoded
+        n: the number of symbols
+        out: the output stream, should be passed by reference */
+    void encode(const byte* symbols, size_t n, BitOutputStream& out) const;
+
+    /* Pack the codes of n symbols into bytes, the same bits encode writes,
+      the first code startBit bits into out[0] and every other bit zero.
+      For this function to work, must first build the tree, with no code
+      longer than BitKernels::MAX_CODE_LENGTH
+      params:
+        symbols: the symbols to be encoded
+        n: the number of symbols
+        startBit: the number of zero bits before the first code, 0 to 7
+        out: the bytes, room for n * (longest code) / 8 + 9 of them
+      return: the number of bytes packed, the last one holding the last
+        bit */
+    size_t pack(const byte* symbols, size_t n, int startBit,
+                byte* out) const;
+
     /* Get the sequence of bits from BitInputStream, decode, then return
       param:
         in: the input stream, should be passed by reference
@@ -65,11 +92,53 @@ class HCTree {
         the decoded symbol */
     byte decode(istream& in) const;
 
+    /* Decode n symbols at once, same as decoding them one by one. Takes
+      the decode table when it is built, then the input stream is read
+      ahead and left for this BitInputStream alone
+      params:
+        in: the input stream, should be passed by reference
+        symbols: the decoded symbols, room for n of them
+        n: the number of symbols */
+    void decode(BitInputStream& in, byte* symbols, size_t n) const;
+
+    /* Build the table the decoding of many symbols at once takes, after
+      build or reconstructTree. Not built by them, for trees decoding a
+      few symbols at a time */
+    void buildDecodeTable();
+
+    /* return the table buildDecodeTable built, empty before it and for a
+      tree of one leaf */
+    const BitKernels::DecodeTable& getDecodeTable() const;
+
+    /* return the length of the code of the given symbol, 0 if the symbol
+      is not in the tree. For this function to work, must first build the
+      tree */
+    unsigned int getCodeLength(byte symbol) const;
+
+    /* return the code of the given symbol, root bit first, the lowest
+      getCodeLength bits of it. For this function to work, must first
+      build the tree */
+    unsigned long long getCode(byte symbol) const;
+
+    /* return the number of bits encode writes for the given frequencies,
+      without writing them. For this function to work, must first build
+      the tree
+      param: a vector contains the frequency of charactors to be encoded */
+    unsigned long long getEncodedBits(const vector<unsigned int>& freqs) const;
+
+    /* return the number of bits getTree writes */
+    unsigned int getTreeBits() const;
+
     /* get the tree structure. can be used to reconstruct the tree */
     void getTree(BitOutputStream& out) const;
 
-    /* reconstruct the tree according to the encoding header */
-    void reconstructTree(BitInputStream& in, int total);
+    /* reconstruct the tree according to the encoding header
+      params:
+        in: the input stream, should be passed by reference
+        total: the number of leaves, as getDistinctChars gave it
+      return: false, with no tree, if the header is not one of a tree of
+        total distinct leaves, as a corrupt input gives */
+    bool reconstructTree(BitInputStream& in, int total);
 
   private:
     /* Helper function for destructor. Recursively deletes all the nodes.
@@ -77,6 +146,15 @@ class HCTree {
      */
     void deleteAll(HCNode* ptr);
 
+    /* Helper method for reconstructTree, drop the nodes of a header that
+      is not a tree
+      return: false */
+    bool dropTree();
+
+    /* Helper method for build and reconstructTree, fill the code table by
+      walking every leaf up to the root, so encode is one table lookup */
+    void buildCodes();
+
     /* Helper method for getTree, in order traverse the tree */
     void getTreeHelper(HCNode* ptr, BitOutputStream& out) const;
 };
@@ -7,6 +7,8 @@
  */
 #include "HCTree2.hpp"
 
+#include <algorithm>
+
 /* Destructor, automatically call it to avoid memory leak */
 HCTree2::~HCTree2() {
     // since deleteAll() will delete all nodes, no need to free
@@ -17,26 +19,41 @@ HCTree2::~HCTree2() {
 /* Build the HCTree2 from the given frequency vector
       param: a vector contains the frequency of charactors to be encoded */
 void HCTree2::build(const vector<unsigned int>& freqs) {
-    priority_queue<HCNode2*, vector<HCNode2*>, HCNode2PtrComp> pq;
-    HCNode2* ptr;
+    // only the symbols that occur
+    vector<byte2> symbols;
+    vector<unsigned int> counts;
     for (int i = 0; i < freqs.size(); i++) {
         if (freqs[i] > 0) {
-            // create new node
-            ptr = new HCNode2(freqs[i], byte2(i));
-            byte2 symbol = byte2(i);
-            // store it to the leaves vector
-            leaves[i] = ptr;
-            // push into minHeap to prepare building the tree
-            pq.push(ptr);
-        } else {
-            leaves[i] = 0;
+            symbols.push_back(byte2(i));
+            counts.push_back(freqs[i]);
         }
     }
+    build(symbols, counts);
+}
+
+/* Build the HCTree2 from the symbols that occur only */
+void HCTree2::build(const vector<byte2>& symbols,
+                    const vector<unsigned int>& counts) {
+    priority_queue<HCNode2*, vector<HCNode2*>, HCNode2PtrComp> pq;
+    HCNode2* ptr;
+    leaves.clear();
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        // create new node
+        ptr = new HCNode2(counts[i], symbols[i]);
+        // store it to the leaves vector
+        leaves.push_back(ptr);
+        // push into minHeap to prepare building the tree, in the order of
+        // the symbols so that ties break as they always have
+        pq.push(ptr);
+    }
     // check if no empty input
     if (pq.size() == 0) {
         return;
-    } else if (pq.size() == 1) {
+    }
+    buildIds();
+    if (pq.size() == 1) {
         root = pq.top();
+        buildCodes();
         return;
     }
 
@@ -62,6 +79,7 @@ void HCTree2::build(const vector<unsigned int>& freqs) {
     }
     // set root
     root = pq.top();
+    buildCodes();
 }
 
 /* return the number of leaves of HCTree2 */
@@ -69,13 +87,7 @@ unsigned int HCTree2::getDistinctChars() {
     if (root == 0) {
         return 0;
     }
-    unsigned int count = 0;
-    for (int i = 0; i < 65536; i++) {
-        if (leaves[i] != 0) {
-            count++;
-        }
-    }
-    return count;
+    return alphabet.size();
 }
 
 /* Write the encoding bits of given symbol to the given BitOutputStream. For
@@ -83,27 +95,40 @@ unsigned int HCTree2::getDistinctChars() {
         symbol: a symbol to be encoded
         out: the output stream, should be passed by reference */
 void HCTree2::encode(byte2 symbol, BitOutputStream& out) const {
-    if (root == 0) {
-        return;
-    }
-    if (root->c0 == 0 && root->c1 == 0) {
-        out.writeBit(0);
+    int id = getId(symbol);
+    if (root == 0 || id < 0) {
         return;
     }
+    out.writeBits(codes[id], codeLengths[id]);
+}
 
-    HCNode2* ptr = leaves[symbol];
-    string buffer = "";
-    while (ptr != root) {
-        if (ptr->isZeroChild) {
-            buffer = '0' + buffer;
-        } else {
-            buffer = '1' + buffer;
+/* return the number of bits encode writes for the given frequencies,
+      without writing them. For this function to work, must first build
+      the tree
+      param: a vector contains the frequency of symbols to be encoded */
+unsigned long long HCTree2::getEncodedBits(
+    const vector<unsigned int>& freqs) const {
+    unsigned long long bits = 0;
+    for (unsigned int i = 0; i < alphabet.size(); i++) {
+        if (alphabet[i] < freqs.size()) {
+            bits += (unsigned long long)freqs[alphabet[i]] * codeLengths[i];
         }
-        ptr = ptr->p;
     }
-    for (int i = 0; i < buffer.length(); i++) {
-        out.writeBit(buffer[i] - '0');
+    return bits;
+}
+
+/* return the number of bits getTree writes */
+unsigned int HCTree2::getTreeBits() const {
+    if (root == 0) {
+        return 0;
+    }
+    // a lone leaf is written twice: 16 bits, then '1' + 16 bits
+    if (root->c0 == 0 && root->c1 == 0) {
+        return 33;
     }
+    // every leaf is '1' + 16 bits, every inner node but the root is a '0'
+    unsigned int count = alphabet.size();
+    return 17 * count + (count - 2);
 }
 
 /* Get the sequence of bits from BitInputStream, decode, then return
@@ -132,6 +157,60 @@ byte2 HCTree2::decode(BitInputStream& in) const {
     return ptr->symbol;
 }
 
+/* Decode n symbols at once */
+void HCTree2::decode(BitInputStream& in, byte2* symbols, size_t n) const {
+    if (root == 0) {
+        fill_n(symbols, n, ' ');
+        return;
+    }
+    // a one-leaf tree decodes without reading
+    if (root->c0 == 0 && root->c1 == 0) {
+        fill_n(symbols, n, root->symbol);
+        return;
+    }
+    if (decodeTable.entries.empty() ||
+        decodeTable.maxLength > BitKernels::MAX_CODE_LENGTH) {
+        for (size_t i = 0; i < n; i++) {
+            symbols[i] = decode(in);
+        }
+        return;
+    }
+    // the table gives IDs
+    in.readCodes(decodeTable, symbols, n);
+    for (size_t i = 0; i < n; i++) {
+        symbols[i] = alphabet[symbols[i]];
+    }
+}
+
+/* Build the table the decoding of many symbols at once takes */
+void HCTree2::buildDecodeTable() {
+    if (root == 0 || (root->c0 == 0 && root->c1 == 0)) {
+        return;
+    }
+    BitKernels::buildDecodeTable(codes.data(), codeLengths.data(),
+                                 alphabet.size(), decodeTable);
+}
+
+/* return the table buildDecodeTable built */
+const BitKernels::DecodeTable& HCTree2::getDecodeTable() const {
+    return decodeTable;
+}
+
+/* return the symbol of an ID */
+byte2 HCTree2::getSymbol(unsigned int id) const { return alphabet[id]; }
+
+/* return the length of the code of the given symbol, 0 if none */
+unsigned int HCTree2::getCodeLength(byte2 symbol) const {
+    int id = getId(symbol);
+    return root == 0 || id < 0 ? 0 : codeLengths[id];
+}
+
+/* return the code of the given symbol, root bit first */
+unsigned long long HCTree2::getCode(byte2 symbol) const {
+    int id = getId(symbol);
+    return root == 0 || id < 0 ? 0 : codes[id];
+}
+
 /* Helper function for destructor. Recursively deletes all the nodes.
         argument: a pointer pointing to the root of the subtree to be deleted.
      */
@@ -183,9 +262,12 @@ void HCTree2::getTree(BitOutputStream& out) const {
 };
 
 /* reconstruct the tree according to the encoding header */
-void HCTree2::reconstructTree(BitInputStream& in, int total) {
+bool HCTree2::reconstructTree(BitInputStream& in, int total) {
     if (total == 0) {
-        return;
+        return true;
+    }
+    if (total < 0 || total > 65536) {
+        return false;
     }
     if (total == 1) {
         byte2 character = 0;
@@ -193,13 +275,22 @@ void HCTree2::reconstructTree(BitInputStream& in, int total) {
             character = character + (in.readBit() << i);
         }
         root = new HCNode2(0, character);
-        leaves[character] = root;
-        return;
+        leaves.assign(1, root);
+        buildIds();
+        // getTree also writes the single leaf as '1' + 16 bits, skip it so
+        // that whatever follows the header is read from the right place
+        for (int i = 0; i < 17; i++) {
+            in.readBit();
+        }
+        buildCodes();
+        return true;
     }
 
     int c;
     byte2 character;
     int count = 0;
+    int inner = 1;  // a tree of total leaves has total - 1 inner nodes
+    leaves.clear();
     root = new HCNode2(0, ' ');
     HCNode2* ptr = root;
 
@@ -208,6 +299,10 @@ void HCTree2::reconstructTree(BitInputStream& in, int total) {
     while (count < total) {
         // bit 0
         if (c == 0) {
+            if (inner == total - 1) {
+                return dropTree();
+            }
+            inner++;
             // create node
             if (ptr->c0 == 0) {
                 ptr->c0 = new HCNode2(0, ' ');
@@ -230,10 +325,7 @@ void HCTree2::reconstructTree(BitInputStream& in, int total) {
             count++;
             leaf = new HCNode2(0, character);
             // add to the leaves list
-            leaves[character] = leaf;
-
-            unsigned char first = ((character >> 8) & 255);
-            unsigned char second = (character & 255);
+            leaves.push_back(leaf);
 
             // construct the tree
             if (ptr->c0 == 0) {
@@ -244,13 +336,96 @@ void HCTree2::reconstructTree(BitInputStream& in, int total) {
             } else {
                 ptr->c1 = leaf;
                 ptr->c1->p = ptr;
-                if (count == total) break;
                 while (ptr != 0 && ptr->c1 != 0) {
                     ptr = ptr->p;
                 }
+                // the tree is complete once the last leaf is placed
+                if ((ptr == 0) != (count == total)) {
+                    return dropTree();
+                }
+                if (count == total) break;
             }
         }
         // get next
         c = in.readBit();
     }
+    if (ptr != 0) {
+        return dropTree();
+    }
+    buildIds();
+    // every symbol has one leaf
+    for (unsigned int i = 1; i < alphabet.size(); i++) {
+        if (alphabet[i] == alphabet[i - 1]) {
+            return dropTree();
+        }
+    }
+    buildCodes();
+    return true;
+}
+
+/* Helper method for reconstructTree, drop the nodes of a header that is
+      not a tree */
+bool HCTree2::dropTree() {
+    deleteAll(root);
+    root = 0;
+    leaves.clear();
+    alphabet.clear();
+    ids.assign(256, vector<unsigned short>());
+    return false;
+}
+
+/* Helper method for build and reconstructTree, fill the code table by
+      walking every leaf up to the root, so encode is one table lookup */
+void HCTree2::buildCodes() {
+    if (root == 0) {
+        return;
+    }
+    codes.assign(leaves.size(), 0);
+    codeLengths.assign(leaves.size(), 0);
+    // a one-leaf tree still writes a '0' for every symbol
+    if (root->c0 == 0 && root->c1 == 0) {
+        codeLengths[0] = 1;
+        return;
+    }
+    for (unsigned int i = 0; i < leaves.size(); i++) {
+        unsigned char length = 0;
+        // reconstructTree links children without isZeroChild
+        for (HCNode2* ptr = leaves[i]; ptr != root; ptr = ptr->p) {
+            if (ptr->p->c1 == ptr) {
+                codes[i] |= 1ULL << length;
+            }
+            length++;
+        }
+        codeLengths[i] = length;
+    }
+}
+
+/* Helper method for build and reconstructTree, sort the leaves by symbol,
+      number them, and fill the pages of IDs */
+void HCTree2::buildIds() {
+    sort(leaves.begin(), leaves.end(), [](HCNode2* a, HCNode2* b) {
+        return a->symbol < b->symbol;
+    });
+    alphabet.resize(leaves.size());
+    ids.assign(256, vector<unsigned short>());
+    for (unsigned int i = 0; i < leaves.size(); i++) {
+        byte2 symbol = leaves[i]->symbol;
+        alphabet[i] = symbol;
+        vector<unsigned short>& page = ids[symbol >> 8];
+        if (page.empty()) {
+            page.resize(256, 0);
+        }
+        page[symbol & 255] = i;
+    }
+}
+
+/* Helper method for encode, return the ID of a symbol, or -1 if the tree
+      has no leaf for it */
+int HCTree2::getId(byte2 symbol) const {
+    const vector<unsigned short>& page = ids[symbol >> 8];
+    if (page.empty()) {
+        return -1;
+    }
+    unsigned short id = page[symbol & 255];
+    return alphabet[id] == symbol ? id : -1;
 }
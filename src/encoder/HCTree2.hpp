@@ -18,15 +18,26 @@
 
 using namespace std;
 
-/** This class defines the Huffman-encoding Tree */
+/** This class defines the Huffman-encoding Tree. Of the 65536 symbols only
+ * those that occur are kept, each under a dense ID, its rank among them:
+ * the leaves, the codes and the decode table are sized by the distinct
+ * symbols, and the IDs of the symbols are looked up in pages of 256, one
+ * for every first byte that occurs */
 class HCTree2 {
   private:
     HCNode2* root;            // the root of HCTree2
-    vector<HCNode2*> leaves;  // a vector storing pointers to all leaf HCNodes
+    vector<byte2> alphabet;   // the symbol of every ID, ascending
+    vector<HCNode2*> leaves;  // the leaf of every ID
+
+    vector<unsigned long long> codes;   // code of every ID, root bit first
+    vector<unsigned char> codeLengths;  // length of every code
+    vector<vector<unsigned short>> ids;   // the ID of every symbol, a page
+                                          // per first byte, empty if none
+    BitKernels::DecodeTable decodeTable;  // empty until buildDecodeTable
 
   public:
     /* Constructor that initialize a HCTree2 */
-    HCTree2() : root(0) { leaves.reserve(65536); }
+    HCTree2() : root(0), ids(256) {}
 
     /* Destructor, automatically call it to avoid memory leak */
     ~HCTree2();
@@ -35,6 +46,14 @@ class HCTree2 {
       param: a vector contains the frequency of charactors to be encoded */
     void build(const vector<unsigned int>& freqs);
 
+    /* Build the HCTree from the symbols that occur only, the same tree as
+      from the whole frequency vector
+      params:
+        symbols: the symbols that occur, ascending
+        counts: the frequency of each of them, none 0 */
+    void build(const vector<byte2>& symbols,
+               const vector<unsigned int>& counts);
+
     /* return the number of leaves of HCTree */
     unsigned int getDistinctChars();
 
@@ -51,11 +70,56 @@ class HCTree2 {
         the decoded symbol */
     byte2 decode(BitInputStream& in) const;
 
+    /* Decode n symbols at once, same as decoding them one by one. Takes
+      the decode table when it is built, then the input stream is read
+      ahead and left for this BitInputStream alone
+      params:
+        in: the input stream, should be passed by reference
+        symbols: the decoded symbols, room for n of them
+        n: the number of symbols */
+    void decode(BitInputStream& in, byte2* symbols, size_t n) const;
+
+    /* Build the table the decoding of many symbols at once takes, after
+      build or reconstructTree */
+    void buildDecodeTable();
+
+    /* return the table buildDecodeTable built, empty before it and for a
+      tree of one leaf. It decodes IDs, getSymbol gives their symbols */
+    const BitKernels::DecodeTable& getDecodeTable() const;
+
+    /* return the symbol of an ID, the rank of the symbol among those of
+      the tree */
+    byte2 getSymbol(unsigned int id) const;
+
+    /* return the length of the code of the given symbol, 0 if the symbol
+      is not in the tree. For this function to work, must first build the
+      tree */
+    unsigned int getCodeLength(byte2 symbol) const;
+
+    /* return the code of the given symbol, root bit first, the lowest
+      getCodeLength bits of it */
+    unsigned long long getCode(byte2 symbol) const;
+
+    /* return the number of bits encode writes for the given frequencies,
+      without writing them. For this function to work, must first build
+      the tree
+      param: a vector contains the frequency of symbols to be encoded,
+        long enough for every symbol of the tree */
+    unsigned long long getEncodedBits(const vector<unsigned int>& freqs) const;
+
+    /* return the number of bits getTree writes */
+    unsigned int getTreeBits() const;
+
     /* get the tree structure. can be used to reconstruct the tree */
     void getTree(BitOutputStream& out) const;
 
-    /* reconstruct the tree according to the encoding header */
-    void reconstructTree(BitInputStream& in, int total);
+    /* reconstruct the tree according to the encoding header
+      params:
+        in: the input stream, should be passed by reference
+        total: the number of leaves, as getDistinctChars gave it
+      return: false, with no tree, if the header is not one of a tree of
+        total distinct leaves, as a corrupt input gives */
+    bool reconstructTree(BitInputStream& in, int total);
 
   private:
     /* Helper function for destructor. Recursively deletes all the nodes.
@@ -63,6 +127,23 @@ class HCTree2 {
      */
     void deleteAll(HCNode2* ptr);
 
+    /* Helper method for reconstructTree, drop the nodes of a header that
+      is not a tree
+      return: false */
+    bool dropTree();
+
+    /* Helper method for build and reconstructTree, fill the code table by
+      walking every leaf up to the root, so encode is one table lookup */
+    void buildCodes();
+
+    /* Helper method for build and reconstructTree, sort the leaves by
+      symbol, number them, and fill the pages of IDs */
+    void buildIds();
+
+    /* Helper method for encode, return the ID of a symbol, or -1 if the
+      tree has no leaf for it */
+    int getId(byte2 symbol) const;
+
     /* Helper method for getTree, in order traverse the tree */
     void getTreeHelper(HCNode2* ptr, BitOutputStream& out) const;
 };
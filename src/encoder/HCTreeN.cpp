@@ -0,0 +1,260 @@
+/**
+ * This file shows the implementation of HCTreeN class methods.
+ * Declaration can be found in 'HCTreeN.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "HCTreeN.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+const int HCTreeN::MAX_WIDTH = 4;
+
+/* the symbols decode takes from the decode table at once */
+static const unsigned int DECODING_SYMBOLS = 4096;
+
+/* Helper method, return the symbol of width bytes at data, the bytes past
+      n read as zeros */
+static unsigned int readSymbol(const byte* data, size_t n, int width) {
+    unsigned int symbol = 0;
+    for (int i = 0; i < width; i++) {
+        symbol = (symbol << 8) | ((size_t)i < n ? data[i] : 0);
+    }
+    return symbol;
+}
+
+/* Helper method, store the bytes of a symbol of width bytes, at most n */
+static void writeSymbol(unsigned int symbol, int width, byte* data,
+                        size_t n) {
+    for (int i = 0; i < width && (size_t)i < n; i++) {
+        data[i] = (symbol >> (8 * (width - 1 - i))) & 255;
+    }
+}
+
+/* Helper method, return the bits of the Elias gamma code of v, v > 0 */
+static unsigned int gammaBits(unsigned long long v) {
+    unsigned int bits = 0;
+    while (v >> (bits + 1)) {
+        bits++;
+    }
+    return 2 * bits + 1;
+}
+
+/* Count the symbols of n bytes */
+void HCTreeN::countSymbols(const byte* data, size_t n, int width,
+                           unordered_map<unsigned int, unsigned int>& freqs) {
+    for (size_t i = 0; i < n; i += width) {
+        freqs[readSymbol(data + i, n - i, width)]++;
+    }
+}
+
+/* Build the code from the count of every symbol that occurs */
+void HCTreeN::build(const unordered_map<unsigned int, unsigned int>& freqs) {
+    alphabet.clear();
+    for (auto it = freqs.begin(); it != freqs.end(); it++) {
+        if (it->second > 0) {
+            alphabet.push_back(it->first);
+        }
+    }
+    sort(alphabet.begin(), alphabet.end());
+    unsigned int count = alphabet.size();
+    codeLengths.assign(count, 0);
+    if (count == 1) {
+        codeLengths[0] = 1;
+    } else if (count > 1) {
+        // merge the two least frequent nodes until one is left, the leaves
+        // first, then the inner nodes, each pointing to its parent
+        typedef pair<unsigned long long, unsigned int> Node;
+        priority_queue<Node, vector<Node>, greater<Node>> pq;
+        for (unsigned int i = 0; i < count; i++) {
+            pq.push(Node(freqs.find(alphabet[i])->second, i));
+        }
+        vector<unsigned int> parents(2 * count - 1, 0);
+        unsigned int next = count;
+        while (pq.size() > 1) {
+            Node a = pq.top();
+            pq.pop();
+            Node b = pq.top();
+            pq.pop();
+            parents[a.second] = next;
+            parents[b.second] = next;
+            pq.push(Node(a.first + b.first, next++));
+        }
+        // the depth of every node, the root last
+        vector<unsigned char> depths(next, 0);
+        for (unsigned int i = next - 1; i-- > 0;) {
+            depths[i] = depths[parents[i]] + 1;
+        }
+        copy(depths.begin(), depths.begin() + count, codeLengths.begin());
+    }
+    buildCodes();
+}
+
+/* Helper method for build and reconstructTree, assign the canonical codes
+      and build the decode tables */
+void HCTreeN::buildCodes() {
+    unsigned int count = alphabet.size();
+    ranks.clear();
+    ranks.reserve(count);
+    for (unsigned int i = 0; i < count; i++) {
+        ranks[alphabet[i]] = i;
+    }
+    // shorter codes first, the symbols of a length in order
+    byCode.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        byCode[i] = i;
+    }
+    stable_sort(byCode.begin(), byCode.end(),
+                [&](unsigned int a, unsigned int b) {
+                    return codeLengths[a] < codeLengths[b];
+                });
+    int maxLength = count > 0 ? codeLengths[byCode.back()] : 0;
+    firstCodes.assign(maxLength + 1, 0);
+    firstIndexes.assign(maxLength + 1, 0);
+    lengthCounts.assign(maxLength + 1, 0);
+    codes.assign(count, 0);
+    unsigned long long code = 0;
+    int length = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int index = byCode[i];
+        if (codeLengths[index] > length) {
+            code <<= codeLengths[index] - length;
+            length = codeLengths[index];
+            firstCodes[length] = code;
+            firstIndexes[length] = i;
+        }
+        codes[index] = code++;
+        lengthCounts[length]++;
+    }
+    // the table decodes indexes of 16 bits
+    decodeTable = BitKernels::DecodeTable();
+    if (count > 1 && count <= 65536 &&
+        maxLength <= BitKernels::MAX_CODE_LENGTH) {
+        BitKernels::buildDecodeTable(codes.data(), codeLengths.data(), count,
+                                     decodeTable);
+    }
+}
+
+/* return the bytes per symbol */
+int HCTreeN::getWidth() const { return width; }
+
+/* return the number of symbols of the alphabet */
+unsigned int HCTreeN::getDistinctSymbols() const { return alphabet.size(); }
+
+/* Write the codes of the symbols of n bytes */
+void HCTreeN::encode(const byte* data, size_t n, BitOutputStream& out) const {
+    for (size_t i = 0; i < n; i += width) {
+        unsigned int index =
+            ranks.find(readSymbol(data + i, n - i, width))->second;
+        out.writeBits(codes[index], codeLengths[index]);
+    }
+}
+
+/* Decode the symbols of n bytes, the last one cut to the bytes left */
+void HCTreeN::decode(BitInputStream& in, byte* data, size_t n) const {
+    size_t symbols = (n + width - 1) / width;
+    if (alphabet.empty()) return;
+    if (alphabet.size() == 1) {
+        // a one-leaf tree decodes without reading
+        for (size_t i = 0; i < symbols; i++) {
+            writeSymbol(alphabet[0], width, data + i * width, n - i * width);
+        }
+        return;
+    }
+    if (!decodeTable.entries.empty()) {
+        vector<unsigned short> indexes(DECODING_SYMBOLS);
+        for (size_t i = 0; i < symbols; i += indexes.size()) {
+            size_t count = min(indexes.size(), symbols - i);
+            in.readCodes(decodeTable, indexes.data(), count);
+            for (size_t j = 0; j < count; j++) {
+                size_t pos = (i + j) * width;
+                writeSymbol(alphabet[indexes[j]], width, data + pos, n - pos);
+            }
+        }
+        return;
+    }
+    // a bit at a time, until the code is one of its length
+    for (size_t i = 0; i < symbols; i++) {
+        unsigned long long code = 0;
+        unsigned int index = 0;
+        for (unsigned int length = 1; length < firstCodes.size(); length++) {
+            code = (code << 1) | in.readBit();
+            if (code - firstCodes[length] < lengthCounts[length]) {
+                index = byCode[firstIndexes[length] + code -
+                               firstCodes[length]];
+                break;
+            }
+        }
+        writeSymbol(alphabet[index], width, data + i * width, n - i * width);
+    }
+}
+
+/* return the number of bits encode writes for the given counts */
+unsigned long long HCTreeN::getEncodedBits(
+    const unordered_map<unsigned int, unsigned int>& freqs) const {
+    unsigned long long bits = 0;
+    for (auto it = freqs.begin(); it != freqs.end(); it++) {
+        auto rank = ranks.find(it->first);
+        if (rank != ranks.end()) {
+            bits += (unsigned long long)it->second *
+                    codeLengths[rank->second];
+        }
+    }
+    return bits;
+}
+
+/* Write the alphabet and the code lengths */
+void HCTreeN::getTree(BitOutputStream& out) const {
+    if (alphabet.empty()) return;
+    out.writeBits(alphabet.size() - 1, 32);
+    unsigned long long previous = 0;  // one more than the symbol before
+    for (unsigned int i = 0; i < alphabet.size(); i++) {
+        unsigned long long gap = alphabet[i] + 1ULL - previous;
+        unsigned int bits = gammaBits(gap);
+        out.writeBits(0, bits / 2);
+        out.writeBits(gap, bits / 2 + 1);
+        previous = alphabet[i] + 1ULL;
+    }
+    for (unsigned int i = 0; i < alphabet.size(); i++) {
+        out.writeBits(codeLengths[i], 6);
+    }
+}
+
+/* return the number of bits getTree writes */
+unsigned long long HCTreeN::getTreeBits() const {
+    if (alphabet.empty()) return 0;
+    unsigned long long bits = 32;
+    unsigned long long previous = 0;
+    for (unsigned int i = 0; i < alphabet.size(); i++) {
+        bits += gammaBits(alphabet[i] + 1ULL - previous) + 6;
+        previous = alphabet[i] + 1ULL;
+    }
+    return bits;
+}
+
+/* Read what getTree wrote and rebuild the code */
+void HCTreeN::reconstructTree(BitInputStream& in) {
+    unsigned int count = in.readBits(32) + 1;
+    alphabet.resize(count);
+    unsigned long long previous = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        // the zeros give the bits after the leading 1
+        unsigned int bits = 0;
+        while (in.readBit() == 0 && bits < 32) {
+            bits++;
+        }
+        unsigned long long gap = 1ULL << bits;
+        gap |= in.readBits(bits);
+        previous += gap;
+        alphabet[i] = previous - 1;
+    }
+    codeLengths.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        codeLengths[i] = in.readBits(6);
+    }
+    buildCodes();
+}
@@ -0,0 +1,102 @@
+/**
+ * This file declares the HCTreeN class, a Huffman code of symbols 1 to 4
+ * bytes wide over the sparse alphabet of the symbols that occur
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef HCTREEN_HPP
+#define HCTREEN_HPP
+
+#include <unordered_map>
+#include <vector>
+#include "BitInputStream.hpp"
+#include "BitOutputStream.hpp"
+
+using namespace std;
+
+/** A class coding the bytes of an input as symbols of 1 to 4 bytes, the
+ * first byte the most significant, an incomplete last symbol padded with
+ * zeros. Only the symbols that occur are kept: they are sorted into an
+ * alphabet and every table is indexed by their rank in it, so memory and
+ * time grow with the distinct symbols and not with 256 to the width. The
+ * codes are canonical, which is why the header only holds the alphabet,
+ * as gaps between symbols, and the length of every code */
+class HCTreeN {
+  private:
+    int width;                              // bytes per symbol
+    vector<unsigned int> alphabet;          // the symbols, ascending
+    unordered_map<unsigned int, unsigned int> ranks;  // symbol to index
+    vector<unsigned long long> codes;       // code of every index, root
+                                            // bit first
+    vector<unsigned char> codeLengths;      // length of every code
+    vector<unsigned int> byCode;            // the indexes in code order
+    vector<unsigned long long> firstCodes;  // the first code of a length
+    vector<unsigned int> firstIndexes;      // where its codes are in byCode
+    vector<unsigned int> lengthCounts;      // the codes of a length
+    BitKernels::DecodeTable decodeTable;    // empty when not usable
+
+    /* Helper method for build and reconstructTree, assign the canonical
+      codes from the lengths and build the decode tables */
+    void buildCodes();
+
+  public:
+    static const int MAX_WIDTH;  // bytes of the widest symbol
+
+    /* Constructor that initialize an empty HCTreeN
+      param: the bytes per symbol, 1 to MAX_WIDTH */
+    explicit HCTreeN(int width) : width(width) {}
+
+    /* Count the symbols of n bytes
+      params:
+        data: the bytes
+        n: the number of bytes
+        width: the bytes per symbol
+        freqs: the count of every symbol, added to */
+    static void countSymbols(const byte* data, size_t n, int width,
+                             unordered_map<unsigned int, unsigned int>& freqs);
+
+    /* Build the code from the count of every symbol that occurs
+      param: the counts, as countSymbols leaves them */
+    void build(const unordered_map<unsigned int, unsigned int>& freqs);
+
+    /* return the bytes per symbol */
+    int getWidth() const;
+
+    /* return the number of symbols of the alphabet */
+    unsigned int getDistinctSymbols() const;
+
+    /* Write the codes of the symbols of n bytes. For this function to
+      work, must first build the code from counts of the same bytes
+      params:
+        data: the bytes
+        n: the number of bytes
+        out: the output stream, should be passed by reference */
+    void encode(const byte* data, size_t n, BitOutputStream& out) const;
+
+    /* Decode the symbols of n bytes, the last one cut to the bytes left
+      params:
+        in: the input stream, should be passed by reference
+        data: the bytes, room for n of them
+        n: the number of bytes */
+    void decode(BitInputStream& in, byte* data, size_t n) const;
+
+    /* return the number of bits encode writes for the given counts */
+    unsigned long long getEncodedBits(
+        const unordered_map<unsigned int, unsigned int>& freqs) const;
+
+    /* Write the alphabet and the code lengths: the distinct count less one
+      in 32 bits, the gap from every symbol to the one before it, the first
+      from -1, as an Elias gamma code, then 6 bits per code length
+      param: the output stream, should be passed by reference */
+    void getTree(BitOutputStream& out) const;
+
+    /* return the number of bits getTree writes */
+    unsigned long long getTreeBits() const;
+
+    /* Read what getTree wrote and rebuild the code
+      param: the input stream, should be passed by reference */
+    void reconstructTree(BitInputStream& in);
+};
+
+#endif  // HCTREEN_HPP
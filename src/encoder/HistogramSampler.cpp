@@ -0,0 +1,58 @@
+/**
+ * This file shows the implementation of HistogramSampler class methods.
+ * Declaration can be found in 'HistogramSampler.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "HistogramSampler.hpp"
+
+#include "BitKernels.hpp"
+
+const unsigned int HistogramSampler::SAMPLE_BLOCK_SIZE = 1 << 16;
+
+/* Estimate the frequency of every byte of an input, reading about
+      rate x total bytes of it in evenly spaced blocks */
+unsigned long long HistogramSampler::sample(istream& in,
+                                            unsigned long long total,
+                                            double rate,
+                                            vector<unsigned int>& freqs) {
+    vector<unsigned long long> counts(256);
+    unsigned long long blocks =
+        (total + SAMPLE_BLOCK_SIZE - 1) / SAMPLE_BLOCK_SIZE;
+    // one block of every stride, the first one always
+    unsigned long long stride = 1;
+    if (rate > 0 && rate < 1) {
+        stride = (unsigned long long)(1 / rate + 0.5);
+    } else if (rate <= 0) {
+        stride = blocks;
+    }
+    unsigned long long read = 0;
+    vector<byte> block(SAMPLE_BLOCK_SIZE);
+    for (unsigned long long i = 0; i < blocks; i += stride) {
+        in.clear();
+        in.seekg(i * SAMPLE_BLOCK_SIZE, ios::beg);
+        in.read((char*)block.data(), SAMPLE_BLOCK_SIZE);
+        streamsize count = in.gcount();
+        // a block is counted in 32 bits, the sample in 64
+        vector<unsigned int> blockCounts(256, 0);
+        BitKernels::countBytes(block.data(), count, blockCounts.data());
+        for (int j = 0; j < 256; j++) {
+            counts[j] += blockCounts[j];
+        }
+        read += count;
+    }
+
+    // scale up to the input, unless all of it was read, and let every
+    // byte have a code
+    freqs.assign(256, 0);
+    for (int i = 0; i < 256; i++) {
+        unsigned long long freq = counts[i];
+        if (read < total) {
+            freq = read > 0 ? freq * (total / (double)read) + 0.5 : 0;
+            if (freq == 0) freq = 1;
+        }
+        freqs[i] = freq > 0xFFFFFFFFULL ? 0xFFFFFFFFU : freq;
+    }
+    return read;
+}
@@ -0,0 +1,37 @@
+/**
+ * This file declares the HistogramSampler class, which estimates the byte
+ * histogram of a large input from evenly spaced blocks of it
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef HISTOGRAMSAMPLER_HPP
+#define HISTOGRAMSAMPLER_HPP
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/** A class that counts a fraction of an input instead of all of it. The
+ * counts of the blocks read are scaled up to the size of the input, and
+ * every byte no block holds gets a count of 1, so the tree built from the
+ * histogram has a code for any byte the rest of the input may hold: the
+ * escape costs a few long codes and a larger tree, never correctness */
+class HistogramSampler {
+  public:
+    static const unsigned int SAMPLE_BLOCK_SIZE;  // bytes per block read
+
+    /* Estimate the frequency of every byte of an input, reading about
+      rate x total bytes of it in evenly spaced blocks
+      params:
+        in: the input stream, seekable, should be passed by reference
+        total: the number of bytes of the input
+        rate: the fraction to read, every byte is counted from 1 up
+        freqs: the output, resized to 256
+      return: the number of bytes read */
+    static unsigned long long sample(istream& in, unsigned long long total,
+                                     double rate, vector<unsigned int>& freqs);
+};
+
+#endif  // HISTOGRAMSAMPLER_HPP
@@ -0,0 +1,67 @@
+/**
+ * This file shows the implementation of PairHistogram class methods.
+ * Declaration can be found in 'PairHistogram.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "PairHistogram.hpp"
+
+#include <thread>
+
+const unsigned int PairHistogram::PIECE_SIZE = 1 << 20;
+
+/* Constructor of PairHistogram */
+PairHistogram::PairHistogram(unsigned int threads) : threads(threads) {
+    if (this->threads == 0) {
+        this->threads = thread::hardware_concurrency();
+    }
+    if (this->threads == 0) {
+        this->threads = 1;
+    }
+}
+
+/* return the number of bytes that keeps every thread busy */
+size_t PairHistogram::getBatchSize() const {
+    return (size_t)threads * PIECE_SIZE;
+}
+
+/* Count every aligned pair of n bytes */
+void PairHistogram::count(const byte* data, size_t n) {
+    size_t pieces = (n + PIECE_SIZE - 1) / PIECE_SIZE;
+    unsigned int used = pieces < threads ? pieces : threads;
+    if (tables.size() < used) {
+        tables.resize(used);
+        wraps.resize(used, vector<unsigned int>(65536, 0));
+    }
+    // the pieces taking turns over the threads, the tables of each kept
+    auto work = [&](unsigned int id) {
+        for (size_t i = id; i < pieces; i += used) {
+            size_t start = i * PIECE_SIZE;
+            size_t length = i + 1 < pieces ? PIECE_SIZE : n - start;
+            BitKernels::countPairs(data + start, length, tables[id],
+                                   wraps[id].data());
+        }
+    };
+    vector<thread> workers;
+    for (unsigned int i = 1; i < used; i++) {
+        workers.push_back(thread(work, i));
+    }
+    if (used > 0) {
+        work(0);
+    }
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+/* Add the counts of every call of count since the last merge to freqs */
+void PairHistogram::merge(unsigned int* freqs) {
+    for (unsigned int i = 0; i < tables.size(); i++) {
+        BitKernels::mergePairs(tables[i], freqs);
+        for (unsigned int j = 0; j < 65536; j++) {
+            freqs[j] += wraps[i][j];
+        }
+        wraps[i].assign(65536, 0);
+    }
+}
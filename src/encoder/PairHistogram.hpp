@@ -0,0 +1,50 @@
+/**
+ * This file declares the PairHistogram class, which counts the aligned
+ * pairs of bytes of an input on several threads
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef PAIRHISTOGRAM_HPP
+#define PAIRHISTOGRAM_HPP
+
+#include <vector>
+#include "BitKernels.hpp"
+
+using namespace std;
+
+/** A class counting the pairs of bytes HCTree2 codes, the same counts as
+ * BitKernels::countPairs. The bytes are cut into pieces of an even length,
+ * the pieces take turns over the threads and every thread counts its own
+ * into 16-bit tables of its own, kept over all the pieces it is given, so
+ * no count is shared while counting; the tables are added up once, by
+ * merge */
+class PairHistogram {
+  private:
+    unsigned int threads;                   // the number of threads
+    vector<BitKernels::PairTables> tables;  // the 16-bit counts per thread
+    vector<vector<unsigned int>> wraps;     // the wrapped counts per thread
+
+  public:
+    static const unsigned int PIECE_SIZE;  // bytes per piece, even
+
+    /* Constructor of PairHistogram
+      param: the number of threads, 0 for one per core */
+    explicit PairHistogram(unsigned int threads);
+
+    /* return the number of bytes that keeps every thread busy, a piece
+      for each */
+    size_t getBatchSize() const;
+
+    /* Count every aligned pair of n bytes, an odd last byte paired with 0
+      params:
+        data: the bytes
+        n: the number of bytes, even unless the last of the input */
+    void count(const byte* data, size_t n);
+
+    /* Add the counts of every call of count since the last merge to freqs
+      param: 65536 counts */
+    void merge(unsigned int* freqs);
+};
+
+#endif  // PAIRHISTOGRAM_HPP
@@ -0,0 +1,118 @@
+/**
+ * This file shows the implementation of ParallelEncoder class methods.
+ * Declaration can be found in 'ParallelEncoder.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "ParallelEncoder.hpp"
+
+#include <cstring>
+#include <functional>
+#include <thread>
+
+const unsigned int ParallelEncoder::PIECE_SIZE = 1 << 20;
+
+/* the part of the bytes one thread codes */
+struct PackedPiece {
+    const byte* data;          // the bytes of the piece
+    size_t n;                  // the number of them
+    unsigned long long start;  // the bit its codes start at
+    unsigned long long bits;   // the length of its codes
+    size_t count;              // the bytes its codes touch
+    byte first;                // the first of them, maybe shared
+    byte last;                 // the last of them, maybe shared
+};
+
+/* Helper method of encode, run task for every piece, the pieces taking
+      turns over the threads */
+static void forEachPiece(unsigned int threads, size_t count,
+                         const function<void(size_t)>& task) {
+    unsigned int used = count < threads ? count : threads;
+    auto work = [&](unsigned int id) {
+        for (size_t i = id; i < count; i += used) {
+            task(i);
+        }
+    };
+    vector<thread> workers;
+    for (unsigned int i = 1; i < used; i++) {
+        workers.push_back(thread(work, i));
+    }
+    work(0);
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+/* Constructor of ParallelEncoder */
+ParallelEncoder::ParallelEncoder(const HCTree& tree, unsigned int threads)
+    : tree(tree), threads(threads), longest(0) {
+    if (this->threads == 0) {
+        this->threads = thread::hardware_concurrency();
+    }
+    if (this->threads == 0) {
+        this->threads = 1;
+    }
+    for (int i = 0; i < 256; i++) {
+        int length = tree.getCodeLength(i);
+        longest = length > longest ? length : longest;
+    }
+}
+
+/* return the number of bytes that keeps every thread busy */
+size_t ParallelEncoder::getBatchSize() const {
+    return (size_t)threads * PIECE_SIZE;
+}
+
+/* Write the codes of n bytes, the same bits as tree.encode */
+void ParallelEncoder::encode(const byte* data, size_t n,
+                             BitOutputStream& out) {
+    if (threads == 1 || n <= PIECE_SIZE ||
+        longest > BitKernels::MAX_CODE_LENGTH) {
+        tree.encode(data, n, out);
+        return;
+    }
+    size_t count = (n + PIECE_SIZE - 1) / PIECE_SIZE;
+    vector<PackedPiece> pieces(count);
+    for (size_t i = 0; i < count; i++) {
+        pieces[i].data = data + i * PIECE_SIZE;
+        pieces[i].n = i + 1 < count ? PIECE_SIZE : n - i * PIECE_SIZE;
+    }
+
+    // the length of the codes of every piece, from its histogram
+    forEachPiece(threads, count, [&](size_t i) {
+        vector<unsigned int> freqs(256, 0);
+        BitKernels::countBytes(pieces[i].data, pieces[i].n, freqs.data());
+        pieces[i].bits = tree.getEncodedBits(freqs);
+    });
+    // where they start, behind the bits of the buffer
+    unsigned long long bitPos = out.getBufferedBits();
+    for (size_t i = 0; i < count; i++) {
+        pieces[i].start = bitPos;
+        bitPos += pieces[i].bits;
+    }
+    packed.assign((bitPos + 7) / 8, 0);
+
+    // pack every piece at its bit, the bytes only it touches in place
+    forEachPiece(threads, count, [&](size_t i) {
+        PackedPiece& piece = pieces[i];
+        vector<byte> scratch(piece.n * longest / 8 + 9);
+        piece.count = tree.pack(piece.data, piece.n, piece.start % 8,
+                                scratch.data());
+        if (piece.count == 0) return;
+        piece.first = scratch[0];
+        piece.last = scratch[piece.count - 1];
+        if (piece.count > 2) {
+            memcpy(packed.data() + piece.start / 8 + 1, scratch.data() + 1,
+                   piece.count - 2);
+        }
+    });
+    // the bytes neighbours may share
+    for (size_t i = 0; i < count; i++) {
+        PackedPiece& piece = pieces[i];
+        if (piece.count == 0) continue;
+        packed[piece.start / 8] |= piece.first;
+        packed[piece.start / 8 + piece.count - 1] |= piece.last;
+    }
+    out.writePacked(packed.data(), bitPos);
+}
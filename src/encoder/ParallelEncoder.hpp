@@ -0,0 +1,52 @@
+/**
+ * This file declares the ParallelEncoder class, which codes bytes with one
+ * tree on several threads into one stream
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef PARALLELENCODER_HPP
+#define PARALLELENCODER_HPP
+
+#include <vector>
+#include "BitOutputStream.hpp"
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** A class writing the same bits as HCTree::encode, on several threads.
+ * The bytes are cut into pieces, every piece is counted and the length of
+ * its codes found from its histogram, and the prefix sums of the lengths
+ * give the bit where every piece starts. The pieces are then packed at
+ * once into one buffer, a thread each; only the first and last byte of a
+ * piece may hold bits of its neighbours, and those are merged once every
+ * thread is done */
+class ParallelEncoder {
+  private:
+    const HCTree& tree;     // the tree of the codes
+    unsigned int threads;   // the number of threads
+    int longest;            // the longest code of the tree
+    vector<byte> packed;    // the codes of the bytes of one call
+
+  public:
+    static const unsigned int PIECE_SIZE;  // bytes per piece
+
+    /* Constructor of ParallelEncoder
+      params:
+        tree: the tree, built
+        threads: the number of threads, 0 for one per core */
+    ParallelEncoder(const HCTree& tree, unsigned int threads);
+
+    /* return the number of bytes that keeps every thread busy, a piece
+      for each */
+    size_t getBatchSize() const;
+
+    /* Write the codes of n bytes, the same bits as tree.encode
+      params:
+        data: the bytes
+        n: the number of bytes
+        out: the output stream, should be passed by reference */
+    void encode(const byte* data, size_t n, BitOutputStream& out);
+};
+
+#endif  // PARALLELENCODER_HPP
@@ -0,0 +1,120 @@
+/**
+ * This file shows the implementation of SizeEstimator class methods.
+ * Declaration can be found in 'SizeEstimator.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "SizeEstimator.hpp"
+
+#include <cmath>
+#include "BitKernels.hpp"
+#include "ContextHCTree.hpp"
+#include "HCTree2.hpp"
+
+/* count every byte of data into freqs */
+void SizeEstimator::countBytes(const vector<byte>& data,
+                               vector<unsigned int>& freqs) {
+    freqs.assign(256, 0);
+    BitKernels::countBytes(data.data(), data.size(), freqs.data());
+}
+
+/* count every aligned pair of bytes of data into freqs */
+void SizeEstimator::countPairs(const vector<byte>& data,
+                               vector<unsigned int>& freqs) {
+    freqs.assign(65536, 0);
+    BitKernels::countPairs(data.data(), data.size(), freqs.data());
+}
+
+/* count every byte of data by the byte before it into freqs */
+void SizeEstimator::countContexts(const vector<byte>& data,
+                                  vector<vector<unsigned int>>& freqs) {
+    freqs.assign(256, vector<unsigned int>(256, 0));
+    byte prev = 0;
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[prev][data[i]]++;
+        prev = data[i];
+    }
+}
+
+/* return the Shannon entropy of the frequencies in bits per symbol */
+double SizeEstimator::entropy(const vector<unsigned int>& freqs) {
+    double total = 0;
+    for (unsigned int i = 0; i < freqs.size(); i++) {
+        total += freqs[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    double bits = 0;
+    for (unsigned int i = 0; i < freqs.size(); i++) {
+        if (freqs[i] > 0) {
+            double p = freqs[i] / total;
+            bits -= p * log2(p);
+        }
+    }
+    return bits;
+}
+
+/* return the entropy of each symbol given the one before it */
+double SizeEstimator::contextEntropy(
+    const vector<vector<unsigned int>>& freqs) {
+    // the entropy of every context, weighted by how often it occurs
+    double total = 0;
+    double bits = 0;
+    for (unsigned int prev = 0; prev < freqs.size(); prev++) {
+        double count = 0;
+        for (unsigned int i = 0; i < freqs[prev].size(); i++) {
+            count += freqs[prev][i];
+        }
+        total += count;
+        bits += count * entropy(freqs[prev]);
+    }
+    return total == 0 ? 0 : bits / total;
+}
+
+/* return the exact number of bytes of the byte mode output */
+unsigned long long SizeEstimator::byteModeBytes(
+    const vector<unsigned int>& freqs) {
+    HCTree tree;
+    tree.build(freqs);
+    if (tree.getDistinctChars() == 0) {
+        return 4;
+    }
+    // total, distinct count, tree and codes
+    unsigned long long bits =
+        8 + tree.getTreeBits() + tree.getEncodedBits(freqs);
+    return 4 + (bits + 7) / 8;
+}
+
+/* return the exact number of bytes of the --block output */
+unsigned long long SizeEstimator::blockModeBytes(
+    const vector<unsigned int>& freqs) {
+    HCTree2 tree;
+    tree.build(freqs);
+    if (tree.getDistinctChars() == 0) {
+        return 4;
+    }
+    unsigned long long bits =
+        16 + tree.getTreeBits() + tree.getEncodedBits(freqs);
+    return 4 + (bits + 7) / 8;
+}
+
+/* return the exact number of bytes of the --context output */
+unsigned long long SizeEstimator::contextModeBytes(
+    const vector<vector<unsigned int>>& freqs) {
+    unsigned long long total = 0;
+    for (unsigned int prev = 0; prev < freqs.size(); prev++) {
+        for (unsigned int i = 0; i < freqs[prev].size(); i++) {
+            total += freqs[prev][i];
+        }
+    }
+    if (total == 0) {
+        return 4;
+    }
+    ContextHCTree model;
+    model.build(freqs);
+    unsigned long long bits =
+        model.getTreeBits() + model.getEncodedBits(freqs);
+    return 4 + (bits + 7) / 8;
+}
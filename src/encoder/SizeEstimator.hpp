@@ -0,0 +1,61 @@
+/**
+ * This file declares the SizeEstimator class, which predicts the size of
+ * the single stream outputs from symbol histograms, without writing them
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef SIZEESTIMATOR_HPP
+#define SIZEESTIMATOR_HPP
+
+#include <vector>
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** A class that sizes Huffman outputs from histograms. Every Huffman tree of
+ * the same frequencies gives the same sum of freq x code length, so building
+ * the tree once is enough to know the exact number of bytes compress writes
+ * for the byte, block and context modes */
+class SizeEstimator {
+  public:
+    /* count every byte of data into freqs, resized to 256 */
+    static void countBytes(const vector<byte>& data,
+                           vector<unsigned int>& freqs);
+
+    /* count every aligned pair of bytes of data into freqs, resized to
+      65536, an odd last byte is paired with 0 */
+    static void countPairs(const vector<byte>& data,
+                           vector<unsigned int>& freqs);
+
+    /* count every byte of data by the byte before it, 0 before the first,
+      into freqs, resized to 256 x 256 */
+    static void countContexts(const vector<byte>& data,
+                              vector<vector<unsigned int>>& freqs);
+
+    /* return the Shannon entropy of the frequencies in bits per symbol,
+      0 if there is no symbol */
+    static double entropy(const vector<unsigned int>& freqs);
+
+    /* return the entropy of each symbol given the one before it, in bits
+      per symbol, the lower bound of any order-1 model
+      param: freqs[prev][symbol] is the count of symbol following prev */
+    static double contextEntropy(const vector<vector<unsigned int>>& freqs);
+
+    /* return the exact number of bytes of the byte mode output: the 4 byte
+      total, the distinct count, the tree and the codes
+      param: the frequency of every byte */
+    static unsigned long long byteModeBytes(const vector<unsigned int>& freqs);
+
+    /* return the exact number of bytes of the --block output
+      param: the frequency of every pair of bytes, as countPairs counts */
+    static unsigned long long blockModeBytes(
+        const vector<unsigned int>& freqs);
+
+    /* return the exact number of bytes of the --context output
+      param: freqs[prev][symbol] is the count of symbol following prev */
+    static unsigned long long contextModeBytes(
+        const vector<vector<unsigned int>>& freqs);
+};
+
+#endif  // SIZEESTIMATOR_HPP
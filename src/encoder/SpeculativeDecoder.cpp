@@ -0,0 +1,170 @@
+/**
+ * This file shows the implementation of SpeculativeDecoder class methods.
+ * Declaration can be found in 'SpeculativeDecoder.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "SpeculativeDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+const unsigned int SpeculativeDecoder::MIN_PIECE_BYTES = 1 << 20;
+const unsigned int SpeculativeDecoder::SYNC_CODES = 1024;
+
+/* the part of the stream one thread decodes */
+struct Piece {
+    unsigned long long start;  // the first bit of the piece
+    unsigned long long end;    // the first bit of the next piece
+    unsigned long long stop;   // the bit after the last code decoded
+    vector<unsigned long long> marks;  // where the first codes start
+    vector<byte> symbols;              // the symbols decoded
+};
+
+/* Helper method of decode, decode the codes starting before end, or
+      limit symbols in all, appended to symbols
+      params: the stream, padded, the position of the next code, set to
+        the bit after the last one, the table, the end, the symbols and
+        their limit */
+static void decodeUntil(const byte* in, size_t paddedBytes,
+                        unsigned long long& pos,
+                        const BitKernels::DecodeTable& table,
+                        unsigned long long end, vector<byte>& symbols,
+                        size_t limit) {
+    while (pos < end && symbols.size() < limit) {
+        // as many codes as surely end before end, at least one
+        size_t count = (end - pos) / table.maxLength;
+        count = max(count, (size_t)1);
+        count = min(count, limit - symbols.size());
+        size_t size = symbols.size();
+        symbols.resize(size + count);
+        size_t done = BitKernels::unpackCodes(in, paddedBytes, pos, table,
+                                              symbols.data() + size, count);
+        symbols.resize(size + done);
+        if (done == 0) break;
+    }
+}
+
+/* Helper method of decode, decode one piece from its first bit, keeping
+      where its first SYNC_CODES codes start when it is speculative */
+static void decodePiece(const byte* in, size_t paddedBytes,
+                        const BitKernels::DecodeTable& table, Piece& piece,
+                        bool speculative, size_t limit) {
+    unsigned long long pos = piece.start;
+    if (speculative) {
+        piece.marks.reserve(SpeculativeDecoder::SYNC_CODES);
+        byte symbol;
+        while (piece.marks.size() < SpeculativeDecoder::SYNC_CODES &&
+               pos < piece.end && piece.symbols.size() < limit) {
+            piece.marks.push_back(pos);
+            if (BitKernels::unpackCodes(in, paddedBytes, pos, table, &symbol,
+                                        1) == 0) {
+                piece.marks.pop_back();
+                break;
+            }
+            piece.symbols.push_back(symbol);
+        }
+    }
+    decodeUntil(in, paddedBytes, pos, table, piece.end, piece.symbols,
+                limit);
+    piece.stop = pos;
+}
+
+/* return the number of pieces to cut a stream into */
+unsigned int SpeculativeDecoder::getPieceCount(size_t inBytes,
+                                               unsigned int threads) {
+    if (threads == 0) {
+        threads = thread::hardware_concurrency();
+    }
+    size_t pieces = inBytes / MIN_PIECE_BYTES;
+    pieces = min(pieces, (size_t)threads);
+    return pieces == 0 ? 1 : pieces;
+}
+
+/* Decode n symbols, a thread per piece */
+unsigned int SpeculativeDecoder::decode(const byte* in, size_t inBytes,
+                                        unsigned long long bitPos,
+                                        const BitKernels::DecodeTable& table,
+                                        byte* symbols, size_t n,
+                                        unsigned int pieces) {
+    vector<byte> decoded;
+    unsigned int redone = decodeWindow(in, inBytes, bitPos, inBytes * 8ULL,
+                                       table, decoded, n, pieces);
+    memcpy(symbols, decoded.data(), decoded.size());
+    // a truncated stream
+    memset(symbols + decoded.size(), 0, n - decoded.size());
+    return redone;
+}
+
+/* Decode the codes starting before a bit, n symbols at most, a thread per
+      piece */
+unsigned int SpeculativeDecoder::decodeWindow(
+    const byte* in, size_t inBytes, unsigned long long& bitPos,
+    unsigned long long endPos, const BitKernels::DecodeTable& table,
+    vector<byte>& symbols, size_t n, unsigned int pieces) {
+    size_t paddedBytes = inBytes + 8;
+    symbols.clear();
+    if (bitPos > endPos) {
+        bitPos = endPos;
+    }
+    // pieces of equal bits, each longer than any code
+    unsigned long long bits = endPos - bitPos;
+    pieces = max(pieces, 1u);
+    while (pieces > 1 && bits / pieces <= (unsigned long long)table.maxLength) {
+        pieces--;
+    }
+    vector<Piece> parts(pieces);
+    for (unsigned int i = 0; i < pieces; i++) {
+        parts[i].start = bitPos + bits * i / pieces;
+        parts[i].end = bitPos + bits * (i + 1) / pieces;
+    }
+    vector<thread> threads;
+    for (unsigned int i = 1; i < pieces; i++) {
+        threads.push_back(thread(decodePiece, in, paddedBytes, cref(table),
+                                 ref(parts[i]), true, n));
+    }
+    decodePiece(in, paddedBytes, table, parts[0], false, n);
+    for (unsigned int i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    // stitch: the true decoding goes on from the stop of the piece before
+    // until it lands where the piece guessed a code starts
+    unsigned int redone = 0;
+    symbols.swap(parts[0].symbols);
+    unsigned long long pos = parts[0].stop;
+    vector<byte> lead;
+    for (unsigned int i = 1; i < pieces && symbols.size() < n; i++) {
+        Piece& piece = parts[i];
+        const vector<unsigned long long>& marks = piece.marks;
+        size_t j = lower_bound(marks.begin(), marks.end(), pos) - marks.begin();
+        size_t limit = n - symbols.size();
+        lead.clear();
+        while (pos < piece.end && j < marks.size() && marks[j] != pos) {
+            decodeUntil(in, paddedBytes, pos, table, pos + 1, lead, limit);
+            while (j < marks.size() && marks[j] < pos) {
+                j++;
+            }
+        }
+        bool synced = pos < piece.end && j < marks.size();
+        if (!synced) {
+            // never in step with the guesses, decoded again
+            if (pos < piece.end) {
+                redone++;
+            }
+            decodeUntil(in, paddedBytes, pos, table, piece.end, lead, limit);
+        }
+        size_t count = min(lead.size(), limit);
+        symbols.insert(symbols.end(), lead.begin(), lead.begin() + count);
+        if (synced) {
+            count = min(piece.symbols.size() - j, n - symbols.size());
+            symbols.insert(symbols.end(), piece.symbols.begin() + j,
+                           piece.symbols.begin() + j + count);
+            pos = piece.stop;
+        }
+    }
+    bitPos = pos;
+    return redone;
+}
@@ -0,0 +1,77 @@
+/**
+ * This file declares the SpeculativeDecoder class, which decodes one stream
+ * of prefix codes on several threads
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef SPECULATIVEDECODER_HPP
+#define SPECULATIVEDECODER_HPP
+
+#include <vector>
+#include "BitKernels.hpp"
+
+using namespace std;
+
+/** A decoder for streams with no index of where codes start, such as the
+ * files of trueCompression. The stream is cut into pieces at arbitrary
+ * bits, and every piece but the first is decoded from its first bit as if
+ * a code started there. The guess is usually wrong, but prefix codes
+ * resynchronize: after a few codes the guessed boundaries fall on true
+ * ones, and the symbols are right from there on. Each piece keeps where
+ * its first SYNC_CODES codes start, then the pieces are stitched in order,
+ * the true decoding of the piece before going on into the piece until it
+ * lands on one of them. A piece that has not resynchronized by then is
+ * decoded again serially, so the symbols are always those of a serial
+ * decoding */
+class SpeculativeDecoder {
+  public:
+    static const unsigned int MIN_PIECE_BYTES;  // coded bytes per piece
+    static const unsigned int SYNC_CODES;  // boundaries a piece keeps
+
+    /* return the number of pieces to cut a stream into
+      params:
+        inBytes: the number of coded bytes
+        threads: the number of threads, 0 for one per core */
+    static unsigned int getPieceCount(size_t inBytes, unsigned int threads);
+
+    /* Decode n symbols, a thread per piece
+      params:
+        in: the coded bytes, followed by 8 bytes of zeros
+        inBytes: the number of coded bytes, the zeros left out
+        bitPos: the position of the first code
+        table: the decode table of the codes, maxLength at most
+          BitKernels::MAX_CODE_LENGTH
+        symbols: the decoded symbols, room for n of them, 0 past the end
+          of in
+        n: the number of symbols
+        pieces: the number of pieces, at least 1
+      return: the number of pieces that had to be decoded again */
+    static unsigned int decode(const byte* in, size_t inBytes,
+                               unsigned long long bitPos,
+                               const BitKernels::DecodeTable& table,
+                               byte* symbols, size_t n, unsigned int pieces);
+
+    /* Decode the codes starting before a bit, n symbols at most, a thread
+      per piece, so a long stream is decoded a window at a time
+      params:
+        in: the coded bytes, followed by 8 more, of the stream or zeros
+        inBytes: the number of coded bytes, the 8 left out
+        bitPos: the position of the first code, set to the bit after the
+          last code, exact unless n symbols are decoded
+        endPos: the bit the codes decoded start before, the codes that
+          cross it must lie in in
+        table: the decode table of the codes, see decode
+        symbols: set to the decoded symbols
+        n: the number of symbols at most
+        pieces: the number of pieces, at least 1
+      return: the number of pieces that had to be decoded again */
+    static unsigned int decodeWindow(const byte* in, size_t inBytes,
+                                     unsigned long long& bitPos,
+                                     unsigned long long endPos,
+                                     const BitKernels::DecodeTable& table,
+                                     vector<byte>& symbols, size_t n,
+                                     unsigned int pieces);
+};
+
+#endif  // SPECULATIVEDECODER_HPP
@@ -0,0 +1,215 @@
+/**
+ * This file shows the implementation of TunstallCode class methods.
+ * Declaration can be found in 'TunstallCode.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "TunstallCode.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <utility>
+
+const unsigned int TunstallCode::MAX_CODEWORDS = 1 << 16;
+const unsigned int TunstallCode::MAX_PHRASE_LENGTH = 32;
+
+/* the bytes decode copies at once, a phrase at most this long is one copy */
+static const unsigned int COPY_BYTES = 16;
+
+/* Build the dictionary from the frequency of every byte */
+void TunstallCode::build(const vector<unsigned int>& freqs) {
+    symbols.clear();
+    double total = 0;
+    for (unsigned int i = 0; i < freqs.size() && i < 256; i++) {
+        if (freqs[i] == 0) continue;
+        symbols.push_back((byte)i);
+        total += freqs[i];
+    }
+    unsigned int k = symbols.size();
+    if (k == 0) {
+        shape.clear();
+        buildNodes();
+        return;
+    }
+
+    // grow the most probable phrase while the codewords last, in a tree
+    // numbered in the order its nodes are made; node 0 is the root
+    vector<unsigned int> first(1, 0);  // first child, 0 for a leaf
+    vector<unsigned int> depths(1, 0);
+    priority_queue<pair<double, unsigned int>> open;
+    open.push(make_pair(1.0, 0));
+    while (!open.empty() && first.size() - 1 + k <= MAX_CODEWORDS) {
+        double probability = open.top().first;
+        unsigned int node = open.top().second;
+        open.pop();
+        first[node] = first.size();
+        for (unsigned int i = 0; i < k; i++) {
+            first.push_back(0);
+            depths.push_back(depths[node] + 1);
+            if (depths.back() < MAX_PHRASE_LENGTH) {
+                open.push(make_pair(probability * freqs[symbols[i]] / total,
+                                    first.size() - 1));
+            }
+        }
+    }
+
+    // the shape in breadth-first order
+    shape.clear();
+    queue<unsigned int> nodes;
+    nodes.push(0);
+    while (!nodes.empty()) {
+        unsigned int node = nodes.front();
+        nodes.pop();
+        if (first[node] == 0) continue;
+        for (unsigned int i = 0; i < k; i++) {
+            unsigned int child = first[node] + i;
+            shape.push_back(first[child] != 0);
+            nodes.push(child);
+        }
+    }
+    buildNodes();
+}
+
+/* Helper method of build and readDictionary, lay out the nodes */
+void TunstallCode::buildNodes() {
+    unsigned int k = symbols.size();
+    ranks.assign(256, 0);
+    for (unsigned int i = 0; i < k; i++) {
+        ranks[symbols[i]] = i;
+    }
+    // the root, then the children of every inner node in turn
+    children.assign(1, k > 0 ? 1 : 0);
+    table.assign(1, Phrase());
+    table[0].offset = 0;
+    table[0].length = 0;
+    phrases.clear();
+    for (unsigned int node = 0; node < children.size(); node++) {
+        if (node > 0) {
+            children[node] = shape[node - 1] ? children.size() : 0;
+        }
+        if (children[node] == 0) continue;
+        for (unsigned int i = 0; i < k; i++) {
+            // the phrase of the parent and one more byte
+            Phrase phrase;
+            phrase.offset = phrases.size();
+            phrase.length = table[node].length + 1;
+            phrases.resize(phrase.offset + phrase.length);
+            copy(phrases.begin() + table[node].offset,
+                 phrases.begin() + table[node].offset + table[node].length,
+                 phrases.begin() + phrase.offset);
+            phrases.back() = symbols[i];
+            table.push_back(phrase);
+            children.push_back(0);
+        }
+    }
+    // the codeword of node i is i - 1, those past the nodes decode to
+    // nothing
+    table.erase(table.begin());
+    table.resize(MAX_CODEWORDS, Phrase{0, 0});
+    phrases.resize(phrases.size() + COPY_BYTES, 0);
+    cursor = 0;
+}
+
+/* return the number of codewords of the dictionary */
+unsigned int TunstallCode::getCodewordCount() const {
+    return children.size() - 1;
+}
+
+/* Write the dictionary */
+void TunstallCode::writeDictionary(ostream& out) const {
+    out << (byte)(symbols.size() - 1);
+    out.write((const char*)symbols.data(), symbols.size());
+    byte bits = 0;
+    for (unsigned int i = 0; i < shape.size(); i++) {
+        bits |= shape[i] << (7 - i % 8);
+        if (i % 8 == 7 || i + 1 == shape.size()) {
+            out << bits;
+            bits = 0;
+        }
+    }
+}
+
+/* Read a dictionary that writeDictionary wrote */
+bool TunstallCode::readDictionary(istream& in) {
+    int count = in.get();
+    if (count == EOF) return false;
+    symbols.resize(count + 1);
+    in.read((char*)symbols.data(), symbols.size());
+    if (in.gcount() != (streamsize)symbols.size()) return false;
+    // the bits of the shape, as many as the nodes they make
+    unsigned int k = symbols.size();
+    shape.clear();
+    unsigned int nodes = k, bits = 0;
+    for (unsigned int i = 0; i < nodes; i++) {
+        if (i % 8 == 0) {
+            int c = in.get();
+            if (c == EOF) return false;
+            bits = c;
+        }
+        shape.push_back((bits >> (7 - i % 8)) & 1);
+        if (shape.back()) {
+            nodes += k;
+            if (nodes > MAX_CODEWORDS) return false;
+        }
+    }
+    buildNodes();
+    return true;
+}
+
+/* Append the codewords of n bytes to out */
+void TunstallCode::encode(const byte* data, size_t n, vector<byte>& out) {
+    size_t size = out.size();
+    out.resize(size + 2 * n);
+    byte* codes = out.data() + size;
+    const unsigned int* first = children.data();
+    const unsigned char* rank = ranks.data();
+    unsigned int node = cursor;
+    for (size_t i = 0; i < n; i++) {
+        node = first[node] + rank[data[i]];
+        if (first[node] == 0) {
+            // a leaf, the whole phrase
+            codes[0] = (node - 1) & 255;
+            codes[1] = (node - 1) >> 8;
+            codes += 2;
+            node = 0;
+        }
+    }
+    cursor = node;
+    out.resize(codes - out.data());
+}
+
+/* Append the codeword of the phrase the parse stopped inside, if any */
+void TunstallCode::flush(vector<byte>& out) {
+    if (cursor == 0) return;
+    out.push_back((cursor - 1) & 255);
+    out.push_back((cursor - 1) >> 8);
+    cursor = 0;
+}
+
+/* Decode codewords until n bytes are written or the codewords run out */
+size_t TunstallCode::decode(const byte* in, size_t count, byte* out,
+                            size_t n) const {
+    const Phrase* phrase = table.data();
+    const byte* bytes = phrases.data();
+    size_t pos = 0, i = 0;
+    // a fixed copy per codeword while the longest phrase surely fits
+    for (; i < count && pos + MAX_PHRASE_LENGTH + COPY_BYTES <= n; i++) {
+        const Phrase& p = phrase[in[2 * i] | in[2 * i + 1] << 8];
+        memcpy(out + pos, bytes + p.offset, COPY_BYTES);
+        if (p.length > COPY_BYTES) {
+            memcpy(out + pos + COPY_BYTES, bytes + p.offset + COPY_BYTES,
+                   p.length - COPY_BYTES);
+        }
+        pos += p.length;
+    }
+    // the tail, copied exactly
+    for (; i < count && pos < n; i++) {
+        const Phrase& p = phrase[in[2 * i] | in[2 * i + 1] << 8];
+        size_t length = p.length < n - pos ? p.length : n - pos;
+        memcpy(out + pos, bytes + p.offset, length);
+        pos += length;
+    }
+    return pos;
+}
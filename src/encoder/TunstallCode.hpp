@@ -0,0 +1,95 @@
+/**
+ * This file declares the TunstallCode class, a variable-to-fixed code that
+ * maps phrases of input bytes to 16 bit codewords
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef TUNSTALLCODE_HPP
+#define TUNSTALLCODE_HPP
+
+#include <iostream>
+#include <vector>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+/** A class coding phrases of bytes as 16 bit codewords. The dictionary is a
+ * tree over the bytes that occur: built from the same byte frequencies as
+ * an HCTree, the most probable phrase is grown by every byte in turn while
+ * the codewords last, so every node of the tree is a phrase and has a
+ * codeword. Phrases are parsed greedily down to a leaf; only the last one
+ * of an input may end at an inner node. Decoding is one aligned load and
+ * one copy per codeword, with no bit-level work at all */
+class TunstallCode {
+  private:
+    /* one codeword of the decoder */
+    struct Phrase {
+        unsigned int offset;  // where its bytes start in phrases
+        unsigned int length;  // the number of them
+    };
+
+    vector<byte> symbols;            // the bytes that occur, ascending
+    vector<unsigned char> ranks;     // the index of every byte in symbols
+    vector<bool> shape;              // per node past the root, inner or not
+    vector<unsigned int> children;   // the first child of every node, 0 for
+                                     // a leaf; the children of a node are
+                                     // consecutive, in the order of symbols
+    vector<Phrase> table;            // the phrase of every codeword
+    vector<byte> phrases;            // the bytes of every phrase
+    unsigned int cursor;             // the node the parse stopped at
+
+    /* Helper method of build and readDictionary, lay out the nodes from
+      symbols and shape, the nodes numbered in breadth-first order */
+    void buildNodes();
+
+  public:
+    static const unsigned int MAX_CODEWORDS;      // codewords of 16 bits
+    static const unsigned int MAX_PHRASE_LENGTH;  // bytes of a phrase
+
+    /* Constructor that initialize an empty TunstallCode */
+    TunstallCode() : ranks(256, 0), cursor(0) {}
+
+    /* Build the dictionary from the frequency of every byte
+      param: the frequency of every byte, some of them not 0 */
+    void build(const vector<unsigned int>& freqs);
+
+    /* return the number of codewords of the dictionary */
+    unsigned int getCodewordCount() const;
+
+    /* Write the dictionary: the number of bytes that occur less one, the
+      bytes, and a bit per node in breadth-first order, 1 for an inner
+      node, packed into bytes with the first bit the highest
+      param: the output stream, should be passed by reference */
+    void writeDictionary(ostream& out) const;
+
+    /* Read a dictionary that writeDictionary wrote
+      param: the input stream, should be passed by reference
+      return: false if the stream ends before the dictionary does */
+    bool readDictionary(istream& in);
+
+    /* Append the codewords of n bytes to out, 2 bytes each with the lower
+      byte first; the parse goes on from where the last call stopped
+      params:
+        data: the bytes, all of them in the dictionary
+        n: the number of bytes
+        out: the codewords, appended to */
+    void encode(const byte* data, size_t n, vector<byte>& out);
+
+    /* Append the codeword of the phrase the parse stopped inside, if any
+      param: the codewords, appended to */
+    void flush(vector<byte>& out);
+
+    /* Decode codewords until n bytes are written or the codewords run out
+      params:
+        in: the codewords, 2 bytes each
+        count: the number of codewords
+        out: the output, room for n bytes
+        n: the number of bytes to decode
+      return: the number of bytes decoded, fewer than n for a truncated or
+        corrupt input */
+    size_t decode(const byte* in, size_t count, byte* out, size_t n) const;
+};
+
+#endif  // TUNSTALLCODE_HPP
@@ -0,0 +1,135 @@
+/**
+ * This file shows the implementation of BlockSplitter class methods.
+ * Declaration can be found in 'BlockSplitter.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "BlockSplitter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "BitKernels.hpp"
+#include "ChunkCodec.hpp"
+#include "SizeEstimator.hpp"
+
+const unsigned int BlockSplitter::MIN_UNIT_SIZE = 4096;
+const unsigned long long BlockSplitter::DEFAULT_BUDGET = 1 << 16;
+
+/* the bytes every segment costs besides its payload */
+static const unsigned int SEGMENT_OVERHEAD =
+    FrameFormat::CHUNK_HEADER_SIZE + FrameFormat::INDEX_ENTRY_SIZE;
+
+/* Helper method of split and estimateBits, return the bits of a segment
+      given n log2 n - sum c log2 c of its counts, its distinct bytes and
+      its length, the smaller of coded and stored */
+static double segmentBits(double codeBits, unsigned int distinct,
+                          unsigned long long n) {
+    double coded = codeBits + ChunkCodec::getTreeHeaderBits(distinct);
+    double stored = n * 8.0;
+    return (coded < stored ? coded : stored) + SEGMENT_OVERHEAD * 8;
+}
+
+/* Constructor of BlockSplitter */
+BlockSplitter::BlockSplitter(unsigned int maxLength,
+                             unsigned long long budget)
+    : maxLength(maxLength), budget(budget) {
+    countBits.resize(min(maxLength, 1u << 16) + 1, 0);
+    for (unsigned int c = 2; c < countBits.size(); c++) {
+        countBits[c] = c * log2((double)c);
+    }
+}
+
+/* Helper method of split, return c log2 c */
+double BlockSplitter::getCountBits(unsigned long long c) const {
+    return c < countBits.size() ? countBits[c] : c * log2((double)c);
+}
+
+/* return the size of the units split cuts n bytes into */
+unsigned int BlockSplitter::getUnitSize(size_t n) const {
+    if (maxLength < MIN_UNIT_SIZE) {
+        return maxLength;
+    }
+    // every unit ends the segments of up to maxLength / unit units
+    unsigned int unit = MIN_UNIT_SIZE;
+    while (unit * 2ULL <= maxLength) {
+        unsigned long long units = (n + unit - 1) / unit;
+        if (units * (maxLength / unit) <= budget) break;
+        unit *= 2;
+    }
+    return unit;
+}
+
+/* Cut n bytes into the segments of least estimated size */
+void BlockSplitter::split(const byte* data, size_t n,
+                          vector<unsigned int>& lengths) {
+    lengths.clear();
+    if (n == 0 || maxLength == 0) return;
+    unsigned int unit = getUnitSize(n);
+    size_t units = (n + unit - 1) / unit;
+    size_t longest = maxLength / unit;
+
+    // the histogram of every unit, as the bytes it has and their counts
+    vector<vector<byte>> symbols(units);
+    vector<vector<unsigned int>> counts(units);
+    vector<unsigned int> freqs(256);
+    for (size_t i = 0; i < units; i++) {
+        size_t start = i * unit;
+        size_t length = min((size_t)unit, n - start);
+        freqs.assign(256, 0);
+        BitKernels::countBytes(data + start, length, freqs.data());
+        for (int c = 0; c < 256; c++) {
+            if (freqs[c] == 0) continue;
+            symbols[i].push_back((byte)c);
+            counts[i].push_back(freqs[c]);
+        }
+    }
+
+    // best[j] is the least size of the first j units, from[j] where the
+    // last segment of it starts
+    vector<double> best(units + 1, 0);
+    vector<size_t> from(units + 1, 0);
+    for (size_t j = 1; j <= units; j++) {
+        // the segments ending at unit j, grown a unit at a time to the left
+        freqs.assign(256, 0);
+        double sumBits = 0;  // sum of c log2 c over the counts
+        unsigned int distinct = 0;
+        size_t end = min(j * unit, n);
+        best[j] = -1;
+        for (size_t i = j; i > 0 && j - i < longest; i--) {
+            const vector<byte>& unitSymbols = symbols[i - 1];
+            const vector<unsigned int>& unitCounts = counts[i - 1];
+            for (size_t k = 0; k < unitSymbols.size(); k++) {
+                unsigned int& count = freqs[unitSymbols[k]];
+                if (count == 0) distinct++;
+                sumBits -= getCountBits(count);
+                count += unitCounts[k];
+                sumBits += getCountBits(count);
+            }
+            unsigned long long length = end - (i - 1) * unit;
+            double bits = best[i - 1] +
+                          segmentBits(getCountBits(length) - sumBits, distinct,
+                                      length);
+            if (best[j] < 0 || bits < best[j]) {
+                best[j] = bits;
+                from[j] = i - 1;
+            }
+        }
+    }
+
+    // walk back from the last unit
+    for (size_t j = units; j > 0; j = from[j]) {
+        lengths.push_back(min(j * unit, n) - from[j] * unit);
+    }
+    reverse(lengths.begin(), lengths.end());
+}
+
+/* return the estimated bits of a segment coded with a tree of its own */
+double BlockSplitter::estimateBits(const vector<unsigned int>& freqs,
+                                   unsigned long long n) {
+    unsigned int distinct = 0;
+    for (unsigned int i = 0; i < freqs.size(); i++) {
+        distinct += freqs[i] > 0;
+    }
+    return segmentBits(SizeEstimator::entropy(freqs) * n, distinct, n);
+}
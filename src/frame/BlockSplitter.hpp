@@ -0,0 +1,67 @@
+/**
+ * This file declares the BlockSplitter class, which cuts an input into
+ * segments of different statistics, each coded with a tree of its own
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef BLOCKSPLITTER_HPP
+#define BLOCKSPLITTER_HPP
+
+#include <vector>
+#include "FrameFormat.hpp"
+
+using namespace std;
+
+/** A class finding where a tree per segment codes an input smallest. The
+ * input is seen as units of equal size, each counted once; a segment of
+ * units is sized from the sum of their histograms as its entropy, plus
+ * the header of its tree and of its chunk, or as stored bytes if that is
+ * smaller. The split of least total size is found by dynamic programming
+ * over the unit boundaries, trying every segment up to the longest one.
+ * The number of segments sized is the CPU budget: when the input has more
+ * units than the budget allows, the units are made larger */
+class BlockSplitter {
+  private:
+    unsigned int maxLength;        // the longest segment, in bytes
+    unsigned long long budget;     // the most segments sized per split
+    vector<double> countBits;      // c log2 c of the smaller counts c
+
+    /* Helper method of split, return c log2 c, from the table when c is
+      in it */
+    double getCountBits(unsigned long long c) const;
+
+  public:
+    static const unsigned int MIN_UNIT_SIZE;   // the finest boundary step
+    static const unsigned long long DEFAULT_BUDGET;
+
+    /* Constructor of BlockSplitter
+      params:
+        maxLength: the longest segment, in bytes, such as the chunk size
+        budget: the most segments sized by one split */
+    BlockSplitter(unsigned int maxLength,
+                  unsigned long long budget = DEFAULT_BUDGET);
+
+    /* return the size of the units split cuts n bytes into, a power of
+      two, larger than MIN_UNIT_SIZE when the budget requires it
+      param: the number of bytes */
+    unsigned int getUnitSize(size_t n) const;
+
+    /* Cut n bytes into the segments of least estimated size
+      params:
+        data: the bytes
+        n: the number of bytes
+        lengths: set to the length of every segment, in order, each at
+          most maxLength */
+    void split(const byte* data, size_t n, vector<unsigned int>& lengths);
+
+    /* return the estimated bits of a segment coded with a tree of its own,
+      its chunk header and index entry included
+      params:
+        freqs: the frequency of every byte of the segment
+        n: the number of bytes of the segment */
+    static double estimateBits(const vector<unsigned int>& freqs,
+                               unsigned long long n);
+};
+
+#endif  // BLOCKSPLITTER_HPP
@@ -0,0 +1,273 @@
+/**
+ * This file shows the implementation of ChunkCodec class methods.
+ * Declaration can be found in 'ChunkCodec.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "ChunkCodec.hpp"
+
+#include <cstring>
+#include <sstream>
+#include "BitInputStream.hpp"
+#include "BitOutputStream.hpp"
+#include "ContextHCTree.hpp"
+#include "HCTree.hpp"
+#include "HCTree2.hpp"
+#include "LZCodec.hpp"
+#include "SizeEstimator.hpp"
+
+const int ChunkCodec::FASTEST_LEVEL = 1;
+const int ChunkCodec::DEFAULT_LEVEL = 6;
+const int ChunkCodec::BEST_LEVEL = 9;
+// the distinct count, then 9 bits a leaf and 1 an inner node
+const unsigned int ChunkCodec::TREE_HEADER_SIZE = 1 + (256 * 10 - 2 + 7) / 8;
+
+/* the first level that tries every mode below */
+static const int BLOCK_LEVEL = 3;
+static const int CONTEXT_LEVEL = 5;
+static const int LZ_LEVEL = 7;
+
+/* return the number of payload bytes encode would write for data in
+      the given mode. All modes but LZ are sized from histograms, without
+      writing anything; LZ is encoded at the given level and measured */
+unsigned long long ChunkCodec::estimate(const vector<byte>& data, byte mode,
+                                        int level) {
+    unsigned long long bits = 0;
+    if (mode == FrameFormat::HUFFMAN) {
+        vector<unsigned int> freqs;
+        SizeEstimator::countBytes(data, freqs);
+        HCTree tree;
+        tree.build(freqs);
+        // distinct count, tree, and codes unless there is a single leaf
+        bits = 8 + tree.getTreeBits();
+        if (tree.getDistinctChars() > 1) {
+            bits += tree.getEncodedBits(freqs);
+        }
+    } else if (mode == FrameFormat::BLOCK) {
+        vector<unsigned int> freqs;
+        SizeEstimator::countPairs(data, freqs);
+        HCTree2 tree;
+        tree.build(freqs);
+        bits = 16 + tree.getTreeBits();
+        if (tree.getDistinctChars() > 1) {
+            bits += tree.getEncodedBits(freqs);
+        }
+    } else if (mode == FrameFormat::CONTEXT) {
+        vector<vector<unsigned int>> freqs;
+        SizeEstimator::countContexts(data, freqs);
+        ContextHCTree model;
+        model.build(freqs);
+        bits = model.getTreeBits() + model.getEncodedBits(freqs);
+    } else if (mode == FrameFormat::LZ) {
+        ostringstream payload;
+        encode(data, mode, payload, level);
+        return payload.str().size();
+    } else {
+        return data.size();
+    }
+    return (bits + 7) / 8;
+}
+
+/* return the mode with the smallest estimated payload for data among
+      the modes the level allows, stored unless another one is smaller */
+byte ChunkCodec::chooseMode(const vector<byte>& data, int level) {
+    unsigned long long size;
+    return chooseMode(data, level, size);
+}
+
+/* Helper method for chooseMode and encodeBest, also sets size to the
+      estimated payload bytes of the mode returned */
+byte ChunkCodec::chooseMode(const vector<byte>& data, int level,
+                            unsigned long long& size) {
+    vector<byte> modes;
+    modes.push_back(FrameFormat::HUFFMAN);
+    if (level >= BLOCK_LEVEL) modes.push_back(FrameFormat::BLOCK);
+    if (level >= CONTEXT_LEVEL) modes.push_back(FrameFormat::CONTEXT);
+    if (level >= LZ_LEVEL) modes.push_back(FrameFormat::LZ);
+
+    byte best = FrameFormat::STORED;
+    unsigned long long bestSize = data.size();
+    for (unsigned int i = 0; i < modes.size(); i++) {
+        unsigned long long modeSize = estimate(data, modes[i], level);
+        if (modeSize < bestSize) {
+            best = modes[i];
+            bestSize = modeSize;
+        }
+    }
+    size = bestSize;
+    return best;
+}
+
+/* Write the payload of data in the mode chooseMode picks, without
+      running the LZ match finder twice */
+byte ChunkCodec::encodeBest(const vector<byte>& data, int level,
+                            ostream& out) {
+    // the histogram modes first, LZ is measured by encoding it
+    unsigned long long bestSize;
+    byte best =
+        chooseMode(data, level < LZ_LEVEL ? level : LZ_LEVEL - 1, bestSize);
+    if (level >= LZ_LEVEL) {
+        ostringstream lz;
+        encode(data, FrameFormat::LZ, lz, level);
+        if (lz.str().size() < bestSize) {
+            out << lz.str();
+            return FrameFormat::LZ;
+        }
+    }
+    encode(data, best, out, level);
+    return best;
+}
+
+/* Write the payload of data coded in the given mode */
+void ChunkCodec::encode(const vector<byte>& data, byte mode, ostream& out,
+                        int level) {
+    if (mode == FrameFormat::STORED) {
+        out.write((const char*)data.data(), data.size());
+        return;
+    }
+    BitOutputStream bitOut(out);
+    if (mode == FrameFormat::HUFFMAN) {
+        vector<unsigned int> freqs;
+        SizeEstimator::countBytes(data, freqs);
+        HCTree tree;
+        tree.build(freqs);
+        unsigned int count = tree.getDistinctChars();
+        bitOut.writeBits(count - 1, 8);
+        tree.getTree(bitOut);
+        // a one-leaf tree decodes without reading, so it writes nothing
+        if (count > 1) {
+            tree.encode(data.data(), data.size(), bitOut);
+        }
+    } else if (mode == FrameFormat::BLOCK) {
+        vector<unsigned int> freqs;
+        SizeEstimator::countPairs(data, freqs);
+        HCTree2 tree;
+        tree.build(freqs);
+        unsigned int count = tree.getDistinctChars();
+        bitOut.writeBits(count - 1, 16);
+        tree.getTree(bitOut);
+        if (count > 1) {
+            for (unsigned int i = 0; i < data.size(); i += 2) {
+                byte second = i + 1 < data.size() ? data[i + 1] : 0;
+                tree.encode((data[i] << 8) + second, bitOut);
+            }
+        }
+    } else if (mode == FrameFormat::CONTEXT) {
+        vector<vector<unsigned int>> freqs;
+        SizeEstimator::countContexts(data, freqs);
+        ContextHCTree model;
+        model.build(freqs);
+        model.getTree(bitOut);
+        byte prev = 0;
+        for (unsigned int i = 0; i < data.size(); i++) {
+            model.encode(prev, data[i], bitOut);
+            prev = data[i];
+        }
+    } else if (mode == FrameFormat::LZ) {
+        LZCodec::encode(data, level, bitOut);
+    }
+    bitOut.flush();
+}
+
+/* Decode a payload that encode wrote */
+bool ChunkCodec::decode(const string& payload, byte mode, unsigned int length,
+                        vector<byte>& data) {
+    data.resize(length);
+    if (mode == FrameFormat::STORED) {
+        // a plain copy
+        memcpy(data.data(), payload.data(),
+               payload.size() < length ? payload.size() : length);
+        return true;
+    }
+    istringstream in(payload);
+    BitInputStream bitIn(in);
+    if (mode == FrameFormat::HUFFMAN) {
+        unsigned int count = bitIn.readBits(8) + 1;
+        HCTree tree;
+        if (!tree.reconstructTree(bitIn, count)) {
+            return false;
+        }
+        tree.buildDecodeTable();
+        tree.decode(bitIn, data.data(), length);
+    } else if (mode == FrameFormat::BLOCK) {
+        unsigned int count = bitIn.readBits(16) + 1;
+        HCTree2 tree;
+        if (!tree.reconstructTree(bitIn, count)) {
+            return false;
+        }
+        tree.buildDecodeTable();
+        vector<byte2> symbols((length + 1) / 2);
+        tree.decode(bitIn, symbols.data(), symbols.size());
+        for (unsigned int i = 0; i < length; i += 2) {
+            data[i] = (symbols[i / 2] >> 8) & 255;
+            if (i + 1 < length) {
+                data[i + 1] = symbols[i / 2] & 255;
+            }
+        }
+    } else if (mode == FrameFormat::CONTEXT) {
+        ContextHCTree model;
+        if (!model.reconstructTree(bitIn)) {
+            return false;
+        }
+        byte prev = 0;
+        for (unsigned int i = 0; i < length; i++) {
+            data[i] = model.decode(prev, bitIn);
+            prev = data[i];
+        }
+    } else if (mode == FrameFormat::LZ) {
+        bool valid = LZCodec::decode(bitIn, length, data);
+        data.resize(length);
+        return valid;
+    }
+    return true;
+}
+
+/* Write the payload of data in the SHARED mode, if the tree has a code for
+      every byte of data and the payload is smaller than limit bytes */
+bool ChunkCodec::encodeShared(const vector<byte>& data, const HCTree& tree,
+                              unsigned long long limit, ostream& out) {
+    vector<unsigned int> freqs;
+    SizeEstimator::countBytes(data, freqs);
+    // the tree has no code for a byte its histogram did not count
+    for (int i = 0; i < 256; i++) {
+        if (freqs[i] > 0 && tree.getCodeLength(i) == 0) {
+            return false;
+        }
+    }
+    if ((tree.getEncodedBits(freqs) + 7) / 8 >= limit) {
+        return false;
+    }
+    BitOutputStream bitOut(out);
+    tree.encode(data.data(), data.size(), bitOut);
+    bitOut.flush();
+    return true;
+}
+
+/* Decode a payload that encodeShared wrote */
+void ChunkCodec::decodeShared(const string& payload, const HCTree& tree,
+                              unsigned int length, vector<byte>& data) {
+    data.resize(length);
+    istringstream in(payload);
+    BitInputStream bitIn(in);
+    tree.decode(bitIn, data.data(), length);
+}
+
+/* return the bits of the distinct count and the tree of a HUFFMAN
+      payload: 9 bits a leaf, 1 an inner node, and a lone leaf written
+      twice */
+unsigned long long ChunkCodec::getTreeHeaderBits(unsigned int distinct) {
+    return 8 + (distinct > 1 ? 10 * distinct - 2 : 17);
+}
+
+/* Rebuild the tree of a HUFFMAN payload */
+bool ChunkCodec::readTree(const string& payload, HCTree& tree) {
+    istringstream in(payload);
+    BitInputStream bitIn(in);
+    unsigned int count = bitIn.readBits(8) + 1;
+    if (!tree.reconstructTree(bitIn, count)) {
+        return false;
+    }
+    tree.buildDecodeTable();
+    return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * This file declares the ChunkCodec class, which codes the payload of one
+ * chunk of a frame in any of the chunk modes
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef CHUNKCODEC_HPP
+#define CHUNKCODEC_HPP
+
+#include <iostream>
+#include <vector>
+#include "FrameFormat.hpp"
+#include "HCTree.hpp"
+
+using namespace std;
+
+/** A class that encodes, decodes and sizes chunk payloads. The level is the
+ * CPU budget of the mode selection:
+ *   1-2: stored or byte Huffman
+ *   3-4: also byte pairs (HCTree2)
+ *   5-6: also order-1 contexts
+ *   7-9: also LZ77, which has to be run to be sized, at that match level */
+class ChunkCodec {
+  public:
+    static const int FASTEST_LEVEL;
+    static const int DEFAULT_LEVEL;
+    static const int BEST_LEVEL;
+    static const unsigned int TREE_HEADER_SIZE;  // most bytes of the tree
+                                                 // of a HUFFMAN payload
+
+    /* return the number of payload bytes encode would write for data in
+      the given mode. All modes but LZ are sized from histograms, without
+      writing anything; LZ is encoded at the given level and measured */
+    static unsigned long long estimate(const vector<byte>& data, byte mode,
+                                       int level = DEFAULT_LEVEL);
+
+    /* return the mode with the smallest estimated payload for data among
+      the modes the level allows, stored unless another one is smaller */
+    static byte chooseMode(const vector<byte>& data,
+                           int level = DEFAULT_LEVEL);
+
+    /* Write the payload of data in the mode chooseMode picks, without
+      running the LZ match finder twice
+      params:
+        data: the bytes of the chunk
+        level: the level of the selection
+        out: the output stream, should be passed by reference
+      return: the mode written */
+    static byte encodeBest(const vector<byte>& data, int level, ostream& out);
+
+    /* Write the payload of data coded in the given mode
+      params:
+        data: the bytes of the chunk
+        mode: one of the FrameFormat chunk modes
+        out: the output stream, should be passed by reference
+        level: the match finder level of the LZ mode */
+    static void encode(const vector<byte>& data, byte mode, ostream& out,
+                       int level = DEFAULT_LEVEL);
+
+    /* Decode a payload that encode wrote
+      params:
+        payload: the payload bytes
+        mode: the mode of the chunk
+        length: the number of bytes of the chunk
+        data: the output, resized to length
+      return: false if the tree header or the LZ stream is corrupt */
+    static bool decode(const string& payload, byte mode, unsigned int length,
+                       vector<byte>& data);
+
+    /* Write the payload of data in the SHARED mode, the codes of a tree
+      kept outside the chunk, if the tree has a code for every byte of data
+      and the payload is smaller than limit bytes
+      params:
+        data: the bytes of the chunk
+        tree: the shared tree
+        limit: the payload size to beat
+        out: the output stream, should be passed by reference
+      return: whether the payload was written */
+    static bool encodeShared(const vector<byte>& data, const HCTree& tree,
+                             unsigned long long limit, ostream& out);
+
+    /* Decode a payload that encodeShared wrote
+      params:
+        payload: the payload bytes
+        tree: the shared tree
+        length: the number of bytes of the chunk
+        data: the output, resized to length */
+    static void decodeShared(const string& payload, const HCTree& tree,
+                             unsigned int length, vector<byte>& data);
+
+    /* return the bits of the distinct count and the tree of a HUFFMAN
+      payload, for a tree of the given number of leaves */
+    static unsigned long long getTreeHeaderBits(unsigned int distinct);
+
+    /* Rebuild the tree of a HUFFMAN payload, ready to decode the REPEAT
+      chunks after it
+      params:
+        payload: the payload, or its first TREE_HEADER_SIZE bytes
+        tree: the tree to rebuild, new
+      return: false if the tree header is corrupt */
+    static bool readTree(const string& payload, HCTree& tree);
+
+  private:
+    /* Helper method for chooseMode and encodeBest, also sets size to the
+      estimated payload bytes of the mode returned */
+    static byte chooseMode(const vector<byte>& data, int level,
+                           unsigned long long& size);
+};
+
+#endif  // CHUNKCODEC_HPP
@@ -0,0 +1,146 @@
+/**
+ * This file shows the implementation of Crc32c class methods.
+ * Declaration can be found in 'Crc32c.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "Crc32c.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+// the crc32 instruction variant is x86-64 code compiled for SSE4.2, chosen
+// when the CPU has it
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAS_CRC32_INSTRUCTION 1
+#include <nmmintrin.h>
+#else
+#define HAS_CRC32_INSTRUCTION 0
+#endif
+
+/* the reflected Castagnoli polynomial */
+static const unsigned int POLYNOMIAL = 0x82F63B78;
+
+/* tables[k][b] is the checksum of byte b followed by k zero bytes, so 8
+ * bytes are folded in with 8 lookups (slicing-by-8) */
+struct Crc32cTables {
+    unsigned int tables[8][256];
+
+    Crc32cTables() {
+        for (unsigned int b = 0; b < 256; b++) {
+            unsigned int crc = b;
+            for (int i = 0; i < 8; i++) {
+                crc = (crc >> 1) ^ (crc & 1 ? POLYNOMIAL : 0);
+            }
+            tables[0][b] = crc;
+        }
+        for (unsigned int b = 0; b < 256; b++) {
+            for (int k = 1; k < 8; k++) {
+                unsigned int prev = tables[k - 1][b];
+                tables[k][b] = (prev >> 8) ^ tables[0][prev & 255];
+            }
+        }
+    }
+};
+
+/* built once, on first use */
+static const Crc32cTables& getTables() {
+    static Crc32cTables crcTables;
+    return crcTables;
+}
+
+/* Helper of update, the inverted crc after length bytes with the tables */
+static unsigned int updateTables(unsigned int crc, const byte* data,
+                                 size_t length) {
+    const unsigned int(*t)[256] = getTables().tables;
+    for (; length >= 8; data += 8, length -= 8) {
+        // the first 4 bytes meet the crc, little endian
+        unsigned int low = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) |
+                                  ((unsigned int)data[3] << 24));
+        crc = t[7][low & 255] ^ t[6][(low >> 8) & 255] ^
+              t[5][(low >> 16) & 255] ^ t[4][low >> 24] ^ t[3][data[4]] ^
+              t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    }
+    for (; length > 0; data++, length--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data) & 255];
+    }
+    return crc;
+}
+
+#if HAS_CRC32_INSTRUCTION
+/* Helper of update, the inverted crc after length bytes with the crc32
+      instruction, 8 bytes per step */
+__attribute__((target("sse4.2"))) static unsigned int updateSse42(
+    unsigned int crc, const byte* data, size_t length) {
+    unsigned long long crc64 = crc;
+    for (; length >= 8; data += 8, length -= 8) {
+        unsigned long long word;
+        memcpy(&word, data, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (unsigned int)crc64;
+    for (; length > 0; data++, length--) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+#endif
+
+typedef unsigned int (*UpdateFunction)(unsigned int, const byte*, size_t);
+
+/* the variant the CPU supports, chosen once */
+static UpdateFunction chooseUpdate() {
+#if HAS_CRC32_INSTRUCTION
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        return updateSse42;
+    }
+#endif
+    return updateTables;
+}
+
+/* return the checksum of length bytes after crc */
+unsigned int Crc32c::update(unsigned int crc, const byte* data,
+                            size_t length) {
+    static const UpdateFunction updateFunction = chooseUpdate();
+    return ~updateFunction(~crc, data, length);
+}
+
+/* return the checksum of all bytes of data */
+unsigned int Crc32c::compute(const vector<byte>& data) {
+    return update(0, data.data(), data.size());
+}
+
+/* Compute the checksum of a range of a file through a mapping of it,
+      without copying the bytes */
+bool Crc32c::computeFile(int fd, unsigned long long offset,
+                         unsigned long long length, unsigned int& crc) {
+    // a mapping past the end of the file would fault
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        return false;
+    }
+    unsigned long long fileSize = status.st_size;
+    if (offset > fileSize || length > fileSize - offset) {
+        return false;
+    }
+    crc = 0;
+    if (length == 0) {
+        return true;
+    }
+    // mappings start at a page
+    unsigned long long page = sysconf(_SC_PAGESIZE);
+    unsigned long long start = offset - offset % page;
+    size_t size = offset + length - start;
+    void* map = mmap(0, size, PROT_READ, MAP_SHARED, fd, start);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+    crc = update(0, (const byte*)map + (offset - start), length);
+    munmap(map, size);
+    return true;
+}
@@ -0,0 +1,47 @@
+/**
+ * This file declares the Crc32c class, the CRC-32C (Castagnoli) checksum
+ * of the original bytes of every chunk
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef CRC32C_HPP
+#define CRC32C_HPP
+
+#include <cstddef>
+#include <vector>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+/** CRC-32C, as iSCSI and ext4 use it. On a CPU with SSE4.2 the crc32
+ * instruction does 8 bytes per step, otherwise 8 lookup tables do */
+class Crc32c {
+  public:
+    /* return the checksum of length bytes after crc, the checksum of the
+      bytes before them, 0 at first
+      params:
+        crc: the checksum so far
+        data: the bytes to add
+        length: the number of bytes */
+    static unsigned int update(unsigned int crc, const byte* data,
+                               size_t length);
+
+    /* return the checksum of all bytes of data */
+    static unsigned int compute(const vector<byte>& data);
+
+    /* Compute the checksum of a range of a file through a mapping of it,
+      without copying the bytes
+      params:
+        fd: a file descriptor open for reading
+        offset: the offset of the range
+        length: the number of bytes of the range
+        crc: set to the checksum
+      return: false if the range is not inside the file or cannot be
+        mapped */
+    static bool computeFile(int fd, unsigned long long offset,
+                            unsigned long long length, unsigned int& crc);
+};
+
+#endif  // CRC32C_HPP
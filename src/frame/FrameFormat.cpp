@@ -0,0 +1,124 @@
+/**
+ * This file shows the implementation of FrameFormat class methods.
+ * Declaration can be found in 'FrameFormat.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "FrameFormat.hpp"
+
+#include <fstream>
+
+const byte FrameFormat::VERSION = 1;
+const unsigned int FrameFormat::DEFAULT_CHUNK_SIZE = 1 << 18;
+const unsigned int FrameFormat::HEADER_SIZE = 21;
+const unsigned int FrameFormat::CHUNK_HEADER_SIZE = 13;
+const unsigned int FrameFormat::TREE_ID_SIZE = 8;
+const unsigned int FrameFormat::CHECKSUM_SIZE = 4;
+const unsigned int FrameFormat::INDEX_ENTRY_SIZE = 16;
+const unsigned int FrameFormat::INDEX_TRAILER_SIZE = 12;
+
+const byte FrameFormat::CHECKSUM_FLAG = 1;
+const byte FrameFormat::INDEX_FLAG = 2;
+const byte FrameFormat::TREE_ID_FLAG = 4;
+
+const byte FrameFormat::STORED = 0;
+const byte FrameFormat::HUFFMAN = 1;
+const byte FrameFormat::BLOCK = 2;
+const byte FrameFormat::CONTEXT = 3;
+const byte FrameFormat::LZ = 4;
+const byte FrameFormat::SHARED = 5;
+const byte FrameFormat::REPEAT = 6;
+const byte FrameFormat::END = 255;
+
+/* the bytes after the legacy total of 0 */
+static const char MAGIC[3] = {'H', 'C', 'F'};
+
+/* return the number of bytes of a frame FrameWriter writes besides
+      the payloads */
+unsigned long long FrameFormat::getOverhead(unsigned long long chunks) {
+    // header, chunk headers, END, index entries and trailer
+    return HEADER_SIZE + chunks * (CHUNK_HEADER_SIZE + INDEX_ENTRY_SIZE) + 1 +
+           INDEX_TRAILER_SIZE;
+}
+
+/* Write the value as nbytes big endian bytes */
+void FrameFormat::writeNumber(ostream& out, unsigned long long value,
+                              int nbytes) {
+    for (int i = nbytes - 1; i > -1; i--) {
+        out.put((value >> (8 * i)) & 255);
+    }
+}
+
+/* Read nbytes big endian bytes */
+unsigned long long FrameFormat::readNumber(istream& in, int nbytes) {
+    unsigned long long value = 0;
+    for (int i = 0; i < nbytes; i++) {
+        value = (value << 8) + (in.get() & 255);
+    }
+    return value;
+}
+
+/* Write the header of one chunk, its checksum included */
+void FrameFormat::writeChunkHeader(ostream& out, byte mode, unsigned int length,
+                                   unsigned int payloadLength,
+                                   unsigned int checksum) {
+    out.put(mode);
+    writeNumber(out, length, 4);
+    writeNumber(out, payloadLength, 4);
+    writeNumber(out, checksum, CHECKSUM_SIZE);
+}
+
+/* Read the header of one chunk, return false on a truncated stream */
+bool FrameFormat::readChunkHeader(istream& in, byte& mode,
+                                  unsigned int& length,
+                                  unsigned int& payloadLength,
+                                  unsigned int& checksum, bool hasChecksum) {
+    mode = in.get();
+    if (!in || mode == END) {
+        return bool(in);
+    }
+    length = readNumber(in, 4);
+    payloadLength = readNumber(in, 4);
+    checksum = hasChecksum ? readNumber(in, CHECKSUM_SIZE) : 0;
+    return bool(in);
+}
+
+/* Write the frame header */
+void FrameFormat::writeHeader(ostream& out, unsigned long long total,
+                              unsigned int chunkSize, byte flags) {
+    writeNumber(out, 0, 4);
+    out.write(MAGIC, 3);
+    out.put(VERSION);
+    out.put(flags);
+    writeNumber(out, total, 8);
+    writeNumber(out, chunkSize, 4);
+}
+
+/* Read the frame header, return false if in does not start with one */
+bool FrameFormat::readHeader(istream& in, unsigned long long& total,
+                             unsigned int& chunkSize, byte& flags) {
+    char head[8];
+    in.read(head, 8);
+    if (!in || head[0] != 0 || head[1] != 0 || head[2] != 0 || head[3] != 0 ||
+        head[4] != MAGIC[0] || head[5] != MAGIC[1] || head[6] != MAGIC[2] ||
+        (byte)head[7] > VERSION) {
+        return false;
+    }
+    flags = in.get();
+    total = readNumber(in, 8);
+    chunkSize = readNumber(in, 4);
+    return bool(in);
+}
+
+/* Check if the given file holds a frame rather than a single stream */
+bool FrameFormat::isFramed(string fileName) {
+    ifstream inFile;
+    inFile.open(fileName, ios::binary);
+    unsigned long long total;
+    unsigned int chunkSize;
+    byte flags;
+    bool framed = readHeader(inFile, total, chunkSize, flags);
+    inFile.close();
+    return framed;
+}
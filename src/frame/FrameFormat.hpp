@@ -0,0 +1,115 @@
+/**
+ * This file declares the FrameFormat class, the constants and the byte
+ * helpers of the chunked (framed) file format
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef FRAMEFORMAT_HPP
+#define FRAMEFORMAT_HPP
+
+#include <iostream>
+#include <string>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+/** The chunked file format. A frame starts with a legacy header of total 0,
+ * so decoders of the single stream formats see an empty file, then:
+ *   3 bytes magic "HCF", 1 byte version, 1 byte flags,
+ *   8 bytes original size, 4 bytes nominal chunk size
+ *   8 bytes ID of the tree of the SHARED chunks, if TREE_ID_FLAG is set
+ * then every chunk as
+ *   1 byte mode, 4 bytes original length, 4 bytes payload length,
+ *   4 bytes CRC-32C of the original bytes if CHECKSUM_FLAG is set, payload
+ * and one END byte. A REPEAT chunk has no tree: its payload is coded with
+ * the tree of the last HUFFMAN chunk before it. If INDEX_FLAG is set, the
+ * chunk index follows:
+ *   for every chunk 8 bytes original offset, 8 bytes offset in the frame
+ *   4 bytes number of chunks, 8 bytes offset of the index in the frame
+ * so it is found from the end of the file. All numbers are big endian */
+class FrameFormat {
+  public:
+    static const byte VERSION;
+    static const unsigned int DEFAULT_CHUNK_SIZE;  // 256 KB
+    static const unsigned int HEADER_SIZE;         // bytes before any chunk
+    static const unsigned int CHUNK_HEADER_SIZE;   // bytes before a payload
+    static const unsigned int TREE_ID_SIZE;        // bytes of a tree ID
+    static const unsigned int CHECKSUM_SIZE;       // of them, the checksum
+    static const unsigned int INDEX_ENTRY_SIZE;    // index bytes per chunk
+    static const unsigned int INDEX_TRAILER_SIZE;  // bytes after the entries
+
+    /* header flags */
+    static const byte CHECKSUM_FLAG;  // every chunk has a checksum
+    static const byte INDEX_FLAG;     // the chunk index follows END
+    static const byte TREE_ID_FLAG;   // SHARED chunks use an outside tree
+
+    /* chunk modes */
+    static const byte STORED;   // the bytes verbatim
+    static const byte HUFFMAN;  // one HCTree for the chunk
+    static const byte BLOCK;    // one HCTree2 of byte pairs
+    static const byte CONTEXT;  // a ContextHCTree, order-1
+    static const byte LZ;       // LZ77 tokens, as LZCodec writes them
+    static const byte SHARED;   // codes of a tree outside the chunk
+    static const byte REPEAT;   // codes of the last HUFFMAN chunk's tree
+    static const byte END;      // no more chunks
+
+    /* return the number of bytes of a frame FrameWriter writes besides
+      the payloads
+      param: the number of chunks */
+    static unsigned long long getOverhead(unsigned long long chunks);
+
+    /* Write the value as nbytes big endian bytes */
+    static void writeNumber(ostream& out, unsigned long long value,
+                            int nbytes);
+
+    /* Read nbytes big endian bytes */
+    static unsigned long long readNumber(istream& in, int nbytes);
+
+    /* Write the header of one chunk, its checksum included
+      params:
+        out: the output stream, should be passed by reference
+        mode: the mode of the payload
+        length: the number of bytes of the chunk
+        payloadLength: the number of payload bytes
+        checksum: the CRC-32C of the bytes of the chunk */
+    static void writeChunkHeader(ostream& out, byte mode, unsigned int length,
+                                 unsigned int payloadLength,
+                                 unsigned int checksum);
+
+    /* Read the header of one chunk, return false on a truncated stream
+      params:
+        in: the input stream, should be passed by reference
+        mode: set to the mode, END has no other field
+        length: set to the number of bytes of the chunk
+        payloadLength: set to the number of payload bytes
+        checksum: set to the checksum, 0 if hasChecksum is false
+        hasChecksum: whether the chunk header has a checksum */
+    static bool readChunkHeader(istream& in, byte& mode, unsigned int& length,
+                                unsigned int& payloadLength,
+                                unsigned int& checksum, bool hasChecksum);
+
+    /* Write the frame header
+      params:
+        out: the output stream, should be passed by reference
+        total: the number of bytes in the frame
+        chunkSize: the nominal number of bytes per chunk
+        flags: the header flags */
+    static void writeHeader(ostream& out, unsigned long long total,
+                            unsigned int chunkSize, byte flags);
+
+    /* Read the frame header, return false if in does not start with one
+      params:
+        in: the input stream, should be passed by reference
+        total: set to the number of bytes in the frame
+        chunkSize: set to the nominal number of bytes per chunk
+        flags: set to the header flags */
+    static bool readHeader(istream& in, unsigned long long& total,
+                           unsigned int& chunkSize, byte& flags);
+
+    /* Check if the given file holds a frame rather than a single stream */
+    static bool isFramed(string fileName);
+};
+
+#endif  // FRAMEFORMAT_HPP
@@ -0,0 +1,233 @@
+/**
+ * This file shows the implementation of FrameReader class methods.
+ * Declaration can be found in 'FrameReader.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "FrameReader.hpp"
+
+#include <algorithm>
+#include <string>
+#include "Crc32c.hpp"
+
+/* Constructor of FrameReader, reads the frame header */
+FrameReader::FrameReader(istream& is)
+    : in(is), total(0), chunkSize(0), flags(0), corrupt(false), done(0),
+      treeId(0), sharedTree(0), lastTree(0) {
+    start = in.tellg();
+    valid = FrameFormat::readHeader(in, total, chunkSize, flags);
+    if (valid && hasTreeId()) {
+        treeId = FrameFormat::readNumber(in, FrameFormat::TREE_ID_SIZE);
+        valid = (bool)in;
+    }
+}
+
+/* Destructor, automatically call it to avoid memory leak */
+FrameReader::~FrameReader() { delete lastTree; }
+
+/* return whether the stream started with a frame header */
+bool FrameReader::isValid() const { return valid; }
+
+/* return the number of bytes in the frame */
+unsigned long long FrameReader::getTotal() const { return total; }
+
+/* return the nominal number of bytes per chunk */
+unsigned int FrameReader::getChunkSize() const { return chunkSize; }
+
+/* return whether every chunk has a checksum */
+bool FrameReader::hasChecksums() const {
+    return flags & FrameFormat::CHECKSUM_FLAG;
+}
+
+/* return whether the SHARED chunks use a tree kept outside the frame */
+bool FrameReader::hasTreeId() const {
+    return flags & FrameFormat::TREE_ID_FLAG;
+}
+
+/* return the ID of the outside tree, 0 without one */
+unsigned long long FrameReader::getTreeId() const { return treeId; }
+
+/* Set the tree of the SHARED chunks */
+void FrameReader::setSharedTree(const HCTree* tree) { sharedTree = tree; }
+
+/* return whether the frame is damaged */
+bool FrameReader::isCorrupt() const { return corrupt; }
+
+/* Read the chunk index from the end of the stream */
+bool FrameReader::readIndex() {
+    if (!valid || !(flags & FrameFormat::INDEX_FLAG) || start < 0) {
+        return false;
+    }
+    streamoff here = in.tellg();
+    in.seekg(-(streamoff)FrameFormat::INDEX_TRAILER_SIZE, ios::end);
+    streamoff trailer = in.tellg();
+    unsigned int count = FrameFormat::readNumber(in, 4);
+    unsigned long long indexOffset = FrameFormat::readNumber(in, 8);
+    // the entries have to fill the space between the offset and trailer
+    bool ok = in && trailer >= start &&
+              indexOffset + (unsigned long long)count *
+                                FrameFormat::INDEX_ENTRY_SIZE ==
+                  (unsigned long long)(trailer - start);
+    if (ok) {
+        in.seekg(start + (streamoff)indexOffset);
+        originalOffsets.resize(count);
+        frameOffsets.resize(count);
+        for (unsigned int i = 0; i < count; i++) {
+            originalOffsets[i] = FrameFormat::readNumber(in, 8);
+            frameOffsets[i] = FrameFormat::readNumber(in, 8);
+            ok = ok && (i == 0 ? originalOffsets[i] == 0
+                               : originalOffsets[i] > originalOffsets[i - 1]);
+        }
+        ok = ok && bool(in);
+    }
+    if (!ok) {
+        originalOffsets.clear();
+        frameOffsets.clear();
+    }
+    in.clear();
+    in.seekg(here);
+    return ok;
+}
+
+/* return the number of chunks in the index */
+unsigned int FrameReader::getChunkCount() const {
+    return frameOffsets.size();
+}
+
+/* Move to the chunk holding the byte at the given original offset */
+bool FrameReader::seekChunk(unsigned long long offset,
+                            unsigned long long& chunkStart) {
+    if (frameOffsets.empty() || offset >= total) {
+        return false;
+    }
+    // the last chunk starting at or before offset
+    unsigned int i = upper_bound(originalOffsets.begin(),
+                                 originalOffsets.end(), offset) -
+                     originalOffsets.begin() - 1;
+    findTree(i);
+    in.clear();
+    in.seekg(start + (streamoff)frameOffsets[i]);
+    done = originalOffsets[i];
+    corrupt = false;
+    chunkStart = done;
+    return bool(in);
+}
+
+/* Read and decode the next chunk, and verify its checksum */
+bool FrameReader::readChunk(vector<byte>& data) {
+    if (!valid || corrupt) {
+        return false;
+    }
+    byte mode;
+    unsigned int length, payloadLength, checksum;
+    bool read = FrameFormat::readChunkHeader(in, mode, length, payloadLength,
+                                             checksum, hasChecksums());
+    if (read && mode == FrameFormat::END) {
+        corrupt = done != total;
+        return false;
+    }
+    if (!read || length > chunkSize || length > total - done ||
+        (mode > FrameFormat::LZ && mode != FrameFormat::SHARED &&
+         mode != FrameFormat::REPEAT) ||
+        (mode == FrameFormat::SHARED && sharedTree == 0) ||
+        (mode == FrameFormat::REPEAT && lastTreeHeader.empty())) {
+        corrupt = true;
+        return false;
+    }
+    // stored chunks go straight into the output buffer; a tree header
+    // that cannot be rebuilt makes the chunk corrupt before its checksum
+    bool decoded = true;
+    if (mode == FrameFormat::STORED) {
+        data.resize(length);
+        in.read((char*)data.data(), length);
+    } else {
+        string payload(payloadLength, '\0');
+        in.read(&payload[0], payloadLength);
+        if (in && mode == FrameFormat::SHARED) {
+            ChunkCodec::decodeShared(payload, *sharedTree, length, data);
+        } else if (in && mode == FrameFormat::REPEAT) {
+            // the tree is rebuilt once for all the chunks repeating it
+            if (lastTree == 0) {
+                lastTree = new HCTree();
+                if (!ChunkCodec::readTree(lastTreeHeader, *lastTree)) {
+                    keepTree("");
+                    corrupt = true;
+                    return false;
+                }
+            }
+            ChunkCodec::decodeShared(payload, *lastTree, length, data);
+        } else if (in) {
+            if (mode == FrameFormat::HUFFMAN) {
+                keepTree(payload);
+            }
+            decoded = ChunkCodec::decode(payload, mode, length, data);
+        }
+    }
+    if (!in || !decoded ||
+        (hasChecksums() && Crc32c::compute(data) != checksum)) {
+        corrupt = true;
+        return false;
+    }
+    done += length;
+    return true;
+}
+
+/* Skip the next chunk if it is stored, without reading its payload */
+bool FrameReader::skipStoredChunk(unsigned int& length,
+                                  unsigned int& checksum, streamoff& offset) {
+    if (!valid || corrupt) {
+        return false;
+    }
+    streamoff header = in.tellg();
+    byte mode;
+    unsigned int payloadLength;
+    bool read = FrameFormat::readChunkHeader(in, mode, length, payloadLength,
+                                             checksum, hasChecksums());
+    if (!read || mode != FrameFormat::STORED || length > chunkSize ||
+        length > total - done) {
+        in.clear();
+        in.seekg(header);
+        return false;
+    }
+    offset = in.tellg();
+    in.seekg(length, ios::cur);
+    done += length;
+    return true;
+}
+
+/* Helper method for readChunk and seekChunk, keep the tree of a HUFFMAN
+      payload for the REPEAT chunks after it */
+void FrameReader::keepTree(const string& payload) {
+    lastTreeHeader = payload.substr(0, ChunkCodec::TREE_HEADER_SIZE);
+    delete lastTree;
+    lastTree = 0;
+}
+
+/* Helper method for seekChunk, keep the tree of the last HUFFMAN chunk
+      before the given one of the index */
+void FrameReader::findTree(unsigned int chunk) {
+    keepTree("");
+    streamoff here = in.tellg();
+    byte mode;
+    unsigned int length, payloadLength, checksum;
+    // only a REPEAT chunk needs one, from the nearest HUFFMAN chunk
+    for (unsigned int i = chunk + 1; i-- > 0;) {
+        in.clear();
+        in.seekg(start + (streamoff)frameOffsets[i]);
+        if (!FrameFormat::readChunkHeader(in, mode, length, payloadLength,
+                                          checksum, hasChecksums()) ||
+            (i == chunk && mode != FrameFormat::REPEAT)) {
+            break;
+        }
+        if (i < chunk && mode == FrameFormat::HUFFMAN) {
+            string header(min(payloadLength, ChunkCodec::TREE_HEADER_SIZE),
+                          '\0');
+            in.read(&header[0], header.size());
+            keepTree(header);
+            break;
+        }
+    }
+    in.clear();
+    in.seekg(here);
+}
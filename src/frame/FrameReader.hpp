@@ -0,0 +1,120 @@
+/**
+ * This file declares the FrameReader class, which reads a frame chunk by
+ * chunk from an input stream
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef FRAMEREADER_HPP
+#define FRAMEREADER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ChunkCodec.hpp"
+#include "FrameFormat.hpp"
+
+using namespace std;
+
+/** A class, instance of which reads one frame */
+class FrameReader {
+  private:
+    istream& in;               // reference to the input stream to use
+    bool valid;                // whether the frame header was read
+    unsigned long long total;  // number of bytes in the frame
+    unsigned int chunkSize;    // nominal number of bytes per chunk
+    byte flags;                // the header flags
+    bool corrupt;              // whether a chunk failed to read or verify
+    unsigned long long done;   // number of bytes read so far
+    streamoff start;           // position of the frame in the stream
+    unsigned long long treeId;  // ID of the tree of SHARED chunks
+    const HCTree* sharedTree;   // that tree, 0 until it is set
+    string lastTreeHeader;      // tree of the last HUFFMAN chunk, as read
+    HCTree* lastTree;           // that tree, 0 until a REPEAT chunk needs it
+    vector<unsigned long long> originalOffsets;  // index, original offsets
+    vector<unsigned long long> frameOffsets;     // index, chunk offsets
+
+  public:
+    /* Constructor of FrameReader, reads the frame header
+      param: the input stream */
+    explicit FrameReader(istream& is);
+
+    /* Destructor, automatically call it to avoid memory leak */
+    ~FrameReader();
+
+    /* return whether the stream started with a frame header */
+    bool isValid() const;
+
+    /* return the number of bytes in the frame */
+    unsigned long long getTotal() const;
+
+    /* return the nominal number of bytes per chunk */
+    unsigned int getChunkSize() const;
+
+    /* return whether every chunk has a checksum */
+    bool hasChecksums() const;
+
+    /* return whether the SHARED chunks of the frame use a tree kept
+      outside it, which has to be set before they can be read */
+    bool hasTreeId() const;
+
+    /* return the ID of the outside tree, 0 without one */
+    unsigned long long getTreeId() const;
+
+    /* Set the tree of the SHARED chunks
+      param: the tree, such as the tree of a GlobalTree of the ID */
+    void setSharedTree(const HCTree* tree);
+
+    /* return whether the frame is damaged: a chunk was truncated, longer
+      than the chunk size, of an unknown mode, SHARED without a tree,
+      REPEAT with no HUFFMAN chunk before it, did not match its checksum,
+      or the frame ended before its total */
+    bool isCorrupt() const;
+
+    /* Read the chunk index from the end of the stream, which must be
+      seekable, the position is kept
+      return: false if the frame has no index or it is damaged */
+    bool readIndex();
+
+    /* return the number of chunks in the index, 0 before readIndex */
+    unsigned int getChunkCount() const;
+
+    /* Move to the chunk holding the byte at the given original offset, so
+      the next readChunk returns it, finding the tree of a REPEAT chunk
+      in the HUFFMAN chunks before it. Needs readIndex first
+      params:
+        offset: the original offset, below the total
+        chunkStart: set to the original offset of the chunk
+      return: false without an index or past the end of the frame */
+    bool seekChunk(unsigned long long offset, unsigned long long& chunkStart);
+
+    /* Read and decode the next chunk, and verify its checksum
+      param: data, the output, resized to the chunk length
+      return: false at the end of the frame or once it is corrupt */
+    bool readChunk(vector<byte>& data);
+
+    /* Skip the next chunk if it is stored, without reading its payload, so
+      the caller can copy the bytes from the file itself. The caller has
+      to verify them with the checksum. Any other chunk, the end and a
+      damaged header are left to readChunk
+      params:
+        length: set to the number of bytes of the chunk
+        checksum: set to the checksum, 0 without checksums
+        offset: set to the stream offset of the payload
+      return: whether a stored chunk was skipped */
+    bool skipStoredChunk(unsigned int& length, unsigned int& checksum,
+                         streamoff& offset);
+
+  private:
+    /* Helper method for readChunk and seekChunk, keep the tree of a
+      HUFFMAN payload for the REPEAT chunks after it
+      param: the payload, or its first ChunkCodec::TREE_HEADER_SIZE bytes */
+    void keepTree(const string& payload);
+
+    /* Helper method for seekChunk, keep the tree of the last HUFFMAN chunk
+      before the given one of the index, the position is kept
+      param: the index of the chunk */
+    void findTree(unsigned int chunk);
+};
+
+#endif  // FRAMEREADER_HPP
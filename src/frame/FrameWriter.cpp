@@ -0,0 +1,142 @@
+/**
+ * This file shows the implementation of FrameWriter class methods.
+ * Declaration can be found in 'FrameWriter.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "FrameWriter.hpp"
+
+#include <sstream>
+#include "Crc32c.hpp"
+#include "SizeEstimator.hpp"
+
+/* Constructor of FrameWriter, writes the frame header */
+FrameWriter::FrameWriter(ostream& os, unsigned long long total,
+                         unsigned int chunkSize, int level,
+                         const HCTree* sharedTree, unsigned long long treeId)
+    : out(os), level(level), sharedTree(sharedTree), reuseTrees(false),
+      lastTree(0), lastRedundancy(1), position(0), originalPosition(0) {
+    byte flags = FrameFormat::CHECKSUM_FLAG | FrameFormat::INDEX_FLAG;
+    if (sharedTree != 0) {
+        flags |= FrameFormat::TREE_ID_FLAG;
+    }
+    FrameFormat::writeHeader(out, total, chunkSize, flags);
+    position = FrameFormat::HEADER_SIZE;
+    if (sharedTree != 0) {
+        FrameFormat::writeNumber(out, treeId, FrameFormat::TREE_ID_SIZE);
+        position += FrameFormat::TREE_ID_SIZE;
+    }
+}
+
+/* Destructor, automatically call it to avoid memory leak */
+FrameWriter::~FrameWriter() { delete lastTree; }
+
+/* Let chunks repeat the tree of the last HUFFMAN chunk */
+void FrameWriter::setTreeReuse(bool reuse) { reuseTrees = reuse; }
+
+/* Write one chunk in the mode with the smallest payload the level
+      allows to find, or the shared or repeated tree finds */
+void FrameWriter::writeChunk(const vector<byte>& data) {
+    vector<unsigned int> freqs;
+    bool canRepeat = false;
+    unsigned long long staleBytes = 0;
+    if (reuseTrees && lastTree != 0) {
+        // the stale codes, if the last tree has one for every byte
+        SizeEstimator::countBytes(data, freqs);
+        unsigned int distinct = 0;
+        canRepeat = true;
+        for (int i = 0; i < 256; i++) {
+            if (freqs[i] > 0) {
+                distinct++;
+                canRepeat = canRepeat && lastTree->getCodeLength(i) > 0;
+            }
+        }
+        unsigned long long staleBits = lastTree->getEncodedBits(freqs);
+        staleBytes = (staleBits + 7) / 8;
+        // a new tree codes about as far above the entropy as the last one
+        // did, and adds its header
+        double freshBits =
+            SizeEstimator::entropy(freqs) * data.size() * lastRedundancy +
+            ChunkCodec::getTreeHeaderBits(distinct);
+        if (canRepeat && staleBits <= freshBits && staleBytes < data.size()) {
+            ostringstream payload;
+            ChunkCodec::encodeShared(data, *lastTree, data.size(), payload);
+            writeChunkHeader(data, FrameFormat::REPEAT, payload.str().size());
+            out << payload.str();
+            return;
+        }
+    }
+
+    ostringstream payload;
+    byte mode = ChunkCodec::encodeBest(data, level, payload);
+    if (sharedTree != 0) {
+        ostringstream shared;
+        if (ChunkCodec::encodeShared(data, *sharedTree, payload.str().size(),
+                                     shared)) {
+            mode = FrameFormat::SHARED;
+            payload.str(shared.str());
+        }
+    }
+    if (canRepeat && staleBytes < payload.str().size()) {
+        ostringstream repeated;
+        ChunkCodec::encodeShared(data, *lastTree, payload.str().size(),
+                                 repeated);
+        mode = FrameFormat::REPEAT;
+        payload.str(repeated.str());
+    }
+    // a new HUFFMAN chunk is the tree of the REPEAT chunks after it
+    if (reuseTrees && mode == FrameFormat::HUFFMAN) {
+        if (freqs.empty()) {
+            SizeEstimator::countBytes(data, freqs);
+        }
+        delete lastTree;
+        lastTree = new HCTree();
+        lastTree->build(freqs);
+        double entropyBits = SizeEstimator::entropy(freqs) * data.size();
+        lastRedundancy = entropyBits > 0
+                             ? lastTree->getEncodedBits(freqs) / entropyBits
+                             : 1;
+    }
+    writeChunkHeader(data, mode, payload.str().size());
+    out << payload.str();
+}
+
+/* Write one chunk in the given mode */
+void FrameWriter::writeChunk(const vector<byte>& data, byte mode) {
+    // stored payloads are known in advance, others are coded aside first
+    if (mode == FrameFormat::STORED) {
+        writeChunkHeader(data, mode, data.size());
+        ChunkCodec::encode(data, mode, out);
+        return;
+    }
+    ostringstream payload;
+    ChunkCodec::encode(data, mode, payload);
+    writeChunkHeader(data, mode, payload.str().size());
+    out << payload.str();
+}
+
+/* Write the header of one chunk, its checksum included, and add the
+      chunk to the index */
+void FrameWriter::writeChunkHeader(const vector<byte>& data, byte mode,
+                                   unsigned int payloadLength) {
+    originalOffsets.push_back(originalPosition);
+    frameOffsets.push_back(position);
+    originalPosition += data.size();
+    position += FrameFormat::CHUNK_HEADER_SIZE + payloadLength;
+    FrameFormat::writeChunkHeader(out, mode, data.size(), payloadLength,
+                                  Crc32c::compute(data));
+}
+
+/* Write the end of the frame and the chunk index */
+void FrameWriter::close() {
+    out.put(FrameFormat::END);
+    unsigned long long indexOffset = position + 1;
+    for (unsigned int i = 0; i < frameOffsets.size(); i++) {
+        FrameFormat::writeNumber(out, originalOffsets[i], 8);
+        FrameFormat::writeNumber(out, frameOffsets[i], 8);
+    }
+    FrameFormat::writeNumber(out, frameOffsets.size(), 4);
+    FrameFormat::writeNumber(out, indexOffset, 8);
+    out.flush();
+}
@@ -0,0 +1,85 @@
+/**
+ * This file declares the FrameWriter class, which writes a frame chunk by
+ * chunk to an output stream
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef FRAMEWRITER_HPP
+#define FRAMEWRITER_HPP
+
+#include <iostream>
+#include <vector>
+#include "ChunkCodec.hpp"
+#include "FrameFormat.hpp"
+
+using namespace std;
+
+/** A class, instance of which writes one frame */
+class FrameWriter {
+  private:
+    ostream& out;  // reference to the output stream to use
+    int level;     // the ChunkCodec level of the mode selection
+    const HCTree* sharedTree;             // tree of SHARED chunks, or 0
+    bool reuseTrees;                      // whether REPEAT chunks are tried
+    HCTree* lastTree;                     // tree of the last HUFFMAN chunk
+    double lastRedundancy;  // its codes over the entropy of its chunk
+    unsigned long long position;          // bytes written so far
+    unsigned long long originalPosition;  // original bytes written so far
+    vector<unsigned long long> originalOffsets;  // index, original offsets
+    vector<unsigned long long> frameOffsets;     // index, chunk offsets
+
+  public:
+    /* Constructor of FrameWriter, writes the frame header, every chunk
+      gets a checksum
+      params:
+        os: the output stream
+        total: the number of bytes that will be written
+        chunkSize: the nominal number of bytes per chunk
+        level: the ChunkCodec level of the mode selection
+        sharedTree: a tree kept outside the frame, such as a GlobalTree,
+          whose codes a chunk uses when they are smaller, or 0
+        treeId: the ID of sharedTree, written in the header */
+    FrameWriter(ostream& os, unsigned long long total, unsigned int chunkSize,
+                int level = ChunkCodec::FASTEST_LEVEL,
+                const HCTree* sharedTree = 0, unsigned long long treeId = 0);
+
+    /* Destructor, automatically call it to avoid memory leak */
+    ~FrameWriter();
+
+    /* Let chunks repeat the tree of the last HUFFMAN chunk. A chunk keeps
+      the stale tree, with no tree built, while its codes cost less than
+      a new tree is estimated to: the entropy of the chunk, times how far
+      above the entropy the last tree coded its own chunk, plus the
+      header of a new tree. Otherwise the level picks the mode as usual,
+      and a new HUFFMAN chunk refreshes the tree. For long streams of
+      stable statistics, where most chunks then carry no tree
+      param: whether to try REPEAT chunks */
+    void setTreeReuse(bool reuse);
+
+    /* Write one chunk in the mode with the smallest payload the level
+      allows to find, or the shared or repeated tree finds
+      param: the bytes of the chunk, at least one */
+    void writeChunk(const vector<byte>& data);
+
+    /* Write one chunk in the given mode
+      params:
+        data: the bytes of the chunk, at least one
+        mode: one of the FrameFormat chunk modes */
+    void writeChunk(const vector<byte>& data, byte mode);
+
+    /* Write the end of the frame and the chunk index */
+    void close();
+
+  private:
+    /* Write the header of one chunk, its checksum included, and add the
+      chunk to the index
+      params:
+        data: the bytes of the chunk
+        mode: the mode of the payload
+        payloadLength: the number of payload bytes */
+    void writeChunkHeader(const vector<byte>& data, byte mode,
+                          unsigned int payloadLength);
+};
+
+#endif  // FRAMEWRITER_HPP
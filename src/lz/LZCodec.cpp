@@ -0,0 +1,335 @@
+/**
+ * This file shows the implementation of LZCodec class methods.
+ * Declaration can be found in 'LZCodec.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "LZCodec.hpp"
+
+#include <cstring>
+
+const unsigned int LZCodec::LENGTH_CODES;
+const unsigned int LZCodec::DISTANCE_CODES;
+
+/* first length of every length code, and its number of extra bits */
+static const unsigned int LENGTH_BASE[LZCodec::LENGTH_CODES] = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const unsigned int LENGTH_EXTRA[LZCodec::LENGTH_CODES] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+    2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+/* first distance of every distance code, and its number of extra bits */
+static const unsigned int DISTANCE_BASE[LZCodec::DISTANCE_CODES] = {
+    1,    2,    3,    4,    5,    7,     9,     13,    17,    25,
+    33,   49,   65,   97,   129,  193,   257,   385,   513,   769,
+    1025, 1537, 2049, 3073, 4097, 6145,  8193,  12289, 16385, 24577};
+static const unsigned int DISTANCE_EXTRA[LZCodec::DISTANCE_CODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/* the symbols of the literal/length tree, and the bytes decode reads at
+   once */
+static const unsigned int LITERAL_SYMBOLS = 256 + LZCodec::LENGTH_CODES;
+static const size_t DECODE_BLOCK_SIZE = 1 << 16;
+
+/* Helper of decode, load the 8 bytes at p, the first one the highest */
+static inline unsigned long long loadBits(const byte* p) {
+    unsigned long long value;
+    memcpy(&value, p, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/** The bits of the tokens, packed behind the bits a BitOutputStream holds
+ * into a buffer sized for all of them, as BitOutputStream::writePacked
+ * takes them */
+class TokenPacker {
+  private:
+    vector<byte> bytes;      // the packed bits
+    byte* next;              // where the next 4 bytes go
+    unsigned long long acc;  // the bits not stored yet, the last lowest
+    int accBits;             // the number of them, below 32
+
+  public:
+    /* Constructor of TokenPacker
+      params:
+        startBits: the bits of the stream buffer, zeros stand for them
+        bits: the number of bits to pack after them */
+    TokenPacker(int startBits, unsigned long long bits)
+        : bytes((startBits + bits + 7) / 8 + 8, 0),
+          acc(0),
+          accBits(startBits) {
+        next = bytes.data();
+    }
+
+    /* Pack the lowest n bits of value, the highest of them first, n at
+      most 64 */
+    void put(unsigned long long value, int n) {
+        if (n > 32) {
+            put(value >> 32, n - 32);
+            value &= 0xFFFFFFFFULL;
+            n = 32;
+        }
+        acc = (acc << n) | value;
+        accBits += n;
+        if (accBits >= 32) {
+            accBits -= 32;
+            unsigned int word = (unsigned int)(acc >> accBits);
+            next[0] = word >> 24;
+            next[1] = (word >> 16) & 255;
+            next[2] = (word >> 8) & 255;
+            next[3] = word & 255;
+            next += 4;
+        }
+    }
+
+    /* Write the bits packed, then the stream buffer holds the last ones */
+    void write(BitOutputStream& out) {
+        unsigned long long bits = (next - bytes.data()) * 8ULL + accBits;
+        // the bits left, at the top of the bytes after the last word
+        unsigned long long rest = accBits > 0 ? acc << (64 - accBits) : 0;
+        for (int i = 0; i < 4; i++) {
+            next[i] = (rest >> (56 - 8 * i)) & 255;
+        }
+        out.writePacked(bytes.data(), bits);
+    }
+};
+
+/* Encode the buffer: both trees, then every token. The length of data is
+      not written, the caller keeps it in its own header */
+void LZCodec::encode(const vector<byte>& data, int level,
+                     BitOutputStream& out) {
+    if (data.empty()) {
+        return;
+    }
+    LZMatcher matcher(level);
+    vector<LZToken> tokens;
+    matcher.parse(data, tokens);
+
+    // count the symbols of both alphabets
+    vector<unsigned int> litFreqs(LITERAL_SYMBOLS), distFreqs(256);
+    for (unsigned int i = 0; i < tokens.size(); i++) {
+        if (tokens[i].length == 0) {
+            litFreqs[tokens[i].literal]++;
+        } else {
+            litFreqs[256 + lengthCode(tokens[i].length)]++;
+            distFreqs[distanceCode(tokens[i].distance)]++;
+        }
+    }
+    // the literal/length tree from the symbols that occur only
+    vector<byte2> symbols;
+    vector<unsigned int> counts;
+    for (unsigned int i = 0; i < LITERAL_SYMBOLS; i++) {
+        if (litFreqs[i] > 0) {
+            symbols.push_back(i);
+            counts.push_back(litFreqs[i]);
+        }
+    }
+    HCTree2 litTree;
+    litTree.build(symbols, counts);
+    HCTree distTree;
+    distTree.build(distFreqs);
+
+    // write the header, there may be no distance tree at all
+    unsigned int litCount = litTree.getDistinctChars();
+    unsigned int distCount = distTree.getDistinctChars();
+    out.writeBits(litCount - 1, 16);
+    litTree.getTree(out);
+    out.writeBits(distCount, 8);
+    if (distCount > 0) {
+        distTree.getTree(out);
+    }
+
+    // the code of every symbol, none for one-leaf trees as they decode
+    // without reading any bit, and the bits of all the tokens
+    unsigned long long litCodes[LITERAL_SYMBOLS], distCodes[DISTANCE_CODES];
+    int litLengths[LITERAL_SYMBOLS], distLengths[DISTANCE_CODES];
+    unsigned long long bits = 0;
+    for (unsigned int i = 0; i < LITERAL_SYMBOLS; i++) {
+        litCodes[i] = litTree.getCode(i);
+        litLengths[i] = litCount > 1 ? litTree.getCodeLength(i) : 0;
+        bits += (unsigned long long)litFreqs[i] * litLengths[i];
+        if (i >= 256) {
+            bits += (unsigned long long)litFreqs[i] * LENGTH_EXTRA[i - 256];
+        }
+    }
+    for (unsigned int i = 0; i < DISTANCE_CODES; i++) {
+        distCodes[i] = distTree.getCode(i);
+        distLengths[i] = distCount > 1 ? distTree.getCodeLength(i) : 0;
+        bits += (unsigned long long)distFreqs[i] *
+                (distLengths[i] + DISTANCE_EXTRA[i]);
+    }
+
+    // write the tokens
+    TokenPacker packer(out.getBufferedBits(), bits);
+    for (unsigned int i = 0; i < tokens.size(); i++) {
+        const LZToken& token = tokens[i];
+        if (token.length == 0) {
+            packer.put(litCodes[token.literal], litLengths[token.literal]);
+            continue;
+        }
+        unsigned int code = lengthCode(token.length);
+        packer.put(litCodes[256 + code], litLengths[256 + code]);
+        packer.put(token.length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+        code = distanceCode(token.distance);
+        packer.put(distCodes[code], distLengths[code]);
+        packer.put(token.distance - DISTANCE_BASE[code],
+                   DISTANCE_EXTRA[code]);
+    }
+    packer.write(out);
+}
+
+/* Decode what encode wrote, false for a corrupt stream */
+bool LZCodec::decode(BitInputStream& in, unsigned int total,
+                     vector<byte>& data) {
+    data.clear();
+    if (total == 0) {
+        return true;
+    }
+
+    // read the header and reconstruct both trees; a code longer than the
+    // tables take needs more than 2^32 symbols, so only a corrupt header
+    // gives one
+    unsigned int litCount = in.readBits(16) + 1;
+    HCTree2 litTree;
+    if (litCount > LITERAL_SYMBOLS ||
+        !litTree.reconstructTree(in, litCount)) {
+        return false;
+    }
+    unsigned int distCount = in.readBits(8);
+    HCTree distTree;
+    if (distCount > DISTANCE_CODES ||
+        !distTree.reconstructTree(in, distCount)) {
+        return false;
+    }
+    litTree.buildDecodeTable();
+    distTree.buildDecodeTable();
+    const BitKernels::DecodeTable& litTable = litTree.getDecodeTable();
+    const BitKernels::DecodeTable& distTable = distTree.getDecodeTable();
+    if (litTable.maxLength > BitKernels::MAX_CODE_LENGTH ||
+        distTable.maxLength > BitKernels::MAX_CODE_LENGTH) {
+        return false;
+    }
+    // one-leaf trees decode without reading
+    unsigned int litSymbol = litCount == 1 ? litTree.decode(in) : 0;
+    unsigned int distSymbol = distCount == 1 ? distTree.decode(in) : 0;
+    // the most bits a token takes
+    unsigned long long tokenBits =
+        litTable.maxLength + 5 + distTable.maxLength + 13;
+
+    // room for a match copied 8 bytes at a time past the end
+    data.resize(total + LZMatcher::MAX_MATCH + 8);
+    byte* output = data.data();
+    size_t outPos = 0;
+    bool corrupt = false;
+    while (outPos < total && !corrupt) {
+        size_t size;
+        unsigned long long pos;
+        const byte* bytes = in.readAhead(DECODE_BLOCK_SIZE, size, pos);
+        // the whole tokens the bytes surely hold, all those left at the
+        // end of the stream, zeros behind them
+        bool end = size < pos / 8 + DECODE_BLOCK_SIZE;
+        unsigned long long limit = size * 8;
+        if (!end) {
+            limit = limit > tokenBits ? limit - tokenBits : 0;
+        }
+        if (pos >= limit) {
+            // a truncated stream
+            corrupt = true;
+        }
+        while (outPos < total && pos < limit) {
+            unsigned int symbol = litSymbol;
+            if (litCount > 1) {
+                pos += BitKernels::decodeCode(
+                    loadBits(bytes + (pos >> 3)) << (pos & 7), litTable,
+                    symbol);
+                symbol = litTree.getSymbol(symbol);
+            }
+            if (symbol < 256) {
+                output[outPos++] = symbol;
+                continue;
+            }
+            // a length code, then a distance code, each with extra bits
+            unsigned int code = symbol - 256;
+            if (code >= LENGTH_CODES || distCount == 0) {
+                corrupt = true;
+                break;
+            }
+            unsigned int length = LENGTH_BASE[code];
+            if (LENGTH_EXTRA[code] > 0) {
+                unsigned long long window =
+                    loadBits(bytes + (pos >> 3)) << (pos & 7);
+                length += window >> (64 - LENGTH_EXTRA[code]);
+                pos += LENGTH_EXTRA[code];
+            }
+            code = distSymbol;
+            if (distCount > 1) {
+                pos += BitKernels::decodeCode(
+                    loadBits(bytes + (pos >> 3)) << (pos & 7), distTable,
+                    code);
+            }
+            if (code >= DISTANCE_CODES) {
+                corrupt = true;
+                break;
+            }
+            unsigned int distance = DISTANCE_BASE[code];
+            if (DISTANCE_EXTRA[code] > 0) {
+                unsigned long long window =
+                    loadBits(bytes + (pos >> 3)) << (pos & 7);
+                distance += window >> (64 - DISTANCE_EXTRA[code]);
+                pos += DISTANCE_EXTRA[code];
+            }
+            // a corrupted stream must not read before the start of the
+            // output, nor write past its end
+            if (distance > outPos || length > total - outPos) {
+                corrupt = true;
+                break;
+            }
+            // 8 bytes at a time when they do not overlap what they copy
+            const byte* from = output + outPos - distance;
+            byte* to = output + outPos;
+            if (distance >= 8) {
+                for (unsigned int i = 0; i < length; i += 8) {
+                    memcpy(to + i, from + i, 8);
+                }
+            } else {
+                for (unsigned int i = 0; i < length; i++) {
+                    to[i] = from[i];
+                }
+            }
+            outPos += length;
+        }
+        in.skipAhead(pos);
+    }
+    data.resize(outPos);
+    return !corrupt;
+}
+
+/* return the code (0-28) of a match length (3-258). Past the first 8,
+      every 4 codes have one more extra bit */
+unsigned int LZCodec::lengthCode(unsigned int length) {
+    if (length == LZMatcher::MAX_MATCH) {
+        return LENGTH_CODES - 1;
+    }
+    unsigned int value = length - 3;
+    if (value < 8) {
+        return value;
+    }
+    unsigned int extra = 29 - __builtin_clz(value);
+    return 4 * extra + (value >> extra);
+}
+
+/* return the code (0-29) of a match distance (1-32768). Past the first 4,
+      every 2 codes have one more extra bit */
+unsigned int LZCodec::distanceCode(unsigned int distance) {
+    unsigned int value = distance - 1;
+    if (value < 4) {
+        return value;
+    }
+    unsigned int extra = 30 - __builtin_clz(value);
+    return 2 * extra + (value >> extra);
+}
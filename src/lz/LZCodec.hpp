@@ -0,0 +1,55 @@
+/**
+ * This file declares the LZCodec class, which codes the output of LZMatcher
+ * with separate Huffman trees for literals/lengths and distances, the way
+ * deflate does
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef LZCODEC_HPP
+#define LZCODEC_HPP
+
+#include <vector>
+#include "BitInputStream.hpp"
+#include "BitOutputStream.hpp"
+#include "HCTree.hpp"
+#include "HCTree2.hpp"
+#include "LZMatcher.hpp"
+
+using namespace std;
+
+/** A class that encodes and decodes buffers with LZ77 + Huffman. Literals
+ * are symbols 0-255 and length codes 256-284 of one HCTree2, distance codes
+ * 0-29 are symbols of one HCTree, both followed by their extra bits */
+class LZCodec {
+  public:
+    static const unsigned int LENGTH_CODES = 29;    // codes of lengths 3-258
+    static const unsigned int DISTANCE_CODES = 30;  // codes of dists 1-32768
+
+    /* Encode the buffer: both trees, then every token. The length of data is
+      not written, the caller keeps it in its own header
+      params:
+        data: the bytes to encode
+        level: the LZMatcher level, 1 (fastest) to 9 (best)
+        out: the output stream, should be passed by reference */
+    static void encode(const vector<byte>& data, int level,
+                       BitOutputStream& out);
+
+    /* Decode what encode wrote
+      params:
+        in: the input stream, should be passed by reference
+        total: the number of bytes to decode
+        data: the output, cleared first
+      return: false if the stream is corrupt, then data holds the bytes
+        decoded before the error */
+    static bool decode(BitInputStream& in, unsigned int total,
+                       vector<byte>& data);
+
+    /* return the code (0-28) of a match length (3-258) */
+    static unsigned int lengthCode(unsigned int length);
+
+    /* return the code (0-29) of a match distance (1-32768) */
+    static unsigned int distanceCode(unsigned int distance);
+};
+
+#endif  // LZCODEC_HPP
@@ -0,0 +1,190 @@
+/**
+ * This file shows the implementation of LZMatcher class methods.
+ * Declaration can be found in 'LZMatcher.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "LZMatcher.hpp"
+
+#include <cstring>
+
+const unsigned int LZMatcher::WINDOW_SIZE;
+const unsigned int LZMatcher::MIN_MATCH;
+const unsigned int LZMatcher::MAX_MATCH;
+const int LZMatcher::FASTEST_LEVEL;
+const int LZMatcher::DEFAULT_LEVEL;
+const int LZMatcher::BEST_LEVEL;
+const unsigned int LZMatcher::HASH_BITS;
+
+/* search parameters of every level, the same trade-offs zlib makes:
+ * good length, max lazy (max insert for greedy levels), nice length,
+ * max chain, lazy matching */
+static const unsigned int LEVEL_CONFIG[10][5] = {
+    {0, 0, 0, 0, 0},          // unused
+    {4, 4, 8, 4, 0},          // 1: fastest, greedy
+    {4, 5, 16, 8, 0},         // 2
+    {4, 6, 32, 32, 0},        // 3
+    {4, 4, 16, 16, 1},        // 4: lazy from here on
+    {8, 16, 32, 32, 1},       // 5
+    {8, 16, 128, 128, 1},     // 6: default
+    {8, 32, 128, 256, 1},     // 7
+    {32, 128, 258, 1024, 1},  // 8
+    {32, 258, 258, 4096, 1}   // 9: best
+};
+
+/* Constructor of LZMatcher
+      param: level, 1 (fastest, greedy, short chains) to 9 (best, lazy,
+        long chains) */
+LZMatcher::LZMatcher(int level) {
+    if (level < FASTEST_LEVEL) {
+        level = FASTEST_LEVEL;
+    } else if (level > BEST_LEVEL) {
+        level = BEST_LEVEL;
+    }
+    goodLength = LEVEL_CONFIG[level][0];
+    maxLazy = LEVEL_CONFIG[level][1];
+    niceLength = LEVEL_CONFIG[level][2];
+    maxChain = LEVEL_CONFIG[level][3];
+    lazy = LEVEL_CONFIG[level][4] != 0;
+}
+
+/* Parse the whole buffer into tokens
+      params:
+        data: the bytes to parse
+        tokens: the output, cleared first */
+void LZMatcher::parse(const vector<byte>& buffer,
+                      vector<LZToken>& tokens) {
+    tokens.clear();
+    head.assign(1 << HASH_BITS, -1);
+    prev.assign(WINDOW_SIZE, -1);
+
+    const byte* data = buffer.data();
+    unsigned int n = buffer.size();
+    unsigned int pos = 0;
+    unsigned int length, distance = 0;
+    while (pos < n) {
+        // too close to the end for any match
+        if (pos + MIN_MATCH > n) {
+            tokens.push_back(LZToken(data[pos]));
+            pos++;
+            continue;
+        }
+
+        length = longestMatch(data, n, pos, MIN_MATCH - 1, distance);
+        insert(data, pos);
+
+        // lazy matching: while the next byte starts a longer match, emit a
+        // literal and take that match instead
+        if (lazy && length >= MIN_MATCH) {
+            while (length < maxLazy && pos + 1 + MIN_MATCH <= n) {
+                unsigned int nextDistance = 0;
+                unsigned int nextLength =
+                    longestMatch(data, n, pos + 1, length, nextDistance);
+                if (nextLength <= length) break;
+                tokens.push_back(LZToken(data[pos]));
+                pos++;
+                insert(data, pos);
+                length = nextLength;
+                distance = nextDistance;
+            }
+        }
+
+        if (length >= MIN_MATCH) {
+            tokens.push_back(LZToken(length, distance));
+            // greedy levels do not hash the inside of long matches, which
+            // is most of their speed on repetitive input
+            if (lazy || length <= maxLazy) {
+                for (unsigned int i = pos + 1;
+                     i < pos + length && i + MIN_MATCH <= n; i++) {
+                    insert(data, i);
+                }
+            }
+            pos += length;
+        } else {
+            tokens.push_back(LZToken(data[pos]));
+            pos++;
+        }
+    }
+}
+
+/* hash of the MIN_MATCH bytes starting at pos */
+unsigned int LZMatcher::hash(const byte* data, unsigned int pos) {
+    unsigned int v = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16);
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/* add pos to the hash chains */
+void LZMatcher::insert(const byte* data, unsigned int pos) {
+    unsigned int h = hash(data, pos);
+    prev[pos & (WINDOW_SIZE - 1)] = head[h];
+    head[h] = pos;
+}
+
+/* return the number of equal bytes at a and b, at most maxLength */
+unsigned int LZMatcher::matchLength(const byte* a, const byte* b,
+                                    unsigned int maxLength) {
+    unsigned int len = 0;
+    while (len + 8 <= maxLength) {
+        unsigned long long x, y;
+        memcpy(&x, a + len, 8);
+        memcpy(&y, b + len, 8);
+        if (x != y) {
+            // the first byte that differs, the lowest in memory
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            return len + __builtin_ctzll(x ^ y) / 8;
+#else
+            return len + __builtin_clzll(x ^ y) / 8;
+#endif
+        }
+        len += 8;
+    }
+    while (len < maxLength && a[len] == b[len]) {
+        len++;
+    }
+    return len;
+}
+
+/* find the longest earlier match of the bytes at pos
+      params:
+        data: the buffer
+        n: the number of bytes of the buffer
+        pos: the position to match
+        prevLength: length of a match already found, only longer ones count
+        distance: set to the distance of the match found
+      return: the length of the match found, 0 if none is longer */
+unsigned int LZMatcher::longestMatch(const byte* data, unsigned int n,
+                                     unsigned int pos, unsigned int prevLength,
+                                     unsigned int& distance) const {
+    unsigned int maxLength = n - pos;
+    if (maxLength > MAX_MATCH) {
+        maxLength = MAX_MATCH;
+    }
+    if (maxLength < MIN_MATCH || prevLength >= maxLength) {
+        return 0;
+    }
+    unsigned int chain = maxChain;
+    if (prevLength >= goodLength) {
+        chain >>= 2;
+    }
+    int limit = pos > WINDOW_SIZE ? pos - WINDOW_SIZE : 0;
+
+    unsigned int best = prevLength, found = 0;
+    int cur = head[hash(data, pos)];
+    while (cur >= limit && chain-- > 0) {
+        // the byte that would make this match longer is checked first
+        if (data[cur + best] == data[pos + best] && data[cur] == data[pos]) {
+            unsigned int len = matchLength(data + cur, data + pos, maxLength);
+            if (len > best) {
+                best = len;
+                found = len;
+                distance = pos - cur;
+                if (len >= niceLength || len == maxLength) break;
+            }
+        }
+        int next = prev[cur & (WINDOW_SIZE - 1)];
+        if (next >= cur) break;
+        cur = next;
+    }
+    return found;
+}
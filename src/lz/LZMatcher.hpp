@@ -0,0 +1,90 @@
+/**
+ * This file declares the LZMatcher class, a hash-chain match finder that
+ * turns a buffer into a sequence of literals and back-references
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef LZMATCHER_HPP
+#define LZMATCHER_HPP
+
+#include <vector>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+/** One step of the parse: a literal byte when length is 0, otherwise a copy
+ * of length bytes starting distance bytes back */
+struct LZToken {
+    unsigned short length;    // match length, 0 for a literal
+    unsigned short distance;  // match distance, 0 for a literal
+    byte literal;             // the literal byte when length is 0
+
+    explicit LZToken(byte literal)
+        : length(0), distance(0), literal(literal) {}
+    LZToken(unsigned short length, unsigned short distance)
+        : length(length), distance(distance), literal(0) {}
+};
+
+/** A class, instance of which finds back-references with hash chains */
+class LZMatcher {
+  public:
+    static const unsigned int WINDOW_SIZE = 32768;  // max match distance
+    static const unsigned int MIN_MATCH = 3;        // shortest match kept
+    static const unsigned int MAX_MATCH = 258;      // longest match kept
+    static const int FASTEST_LEVEL = 1;
+    static const int DEFAULT_LEVEL = 6;
+    static const int BEST_LEVEL = 9;
+
+  private:
+    static const unsigned int HASH_BITS = 15;
+
+    unsigned int goodLength;  // past this length, search a quarter chain
+    unsigned int maxLazy;     // lazy levels: no second try past this length
+                              // greedy levels: no insertion past this length
+    unsigned int niceLength;  // stop searching once a match is this long
+    unsigned int maxChain;    // max number of chain links to follow
+    bool lazy;                // try a match at the next byte before emitting
+
+    vector<int> head;  // most recent position of every hash
+    vector<int> prev;  // previous position with the same hash, per window slot
+
+  public:
+    /* Constructor of LZMatcher
+      param: level, 1 (fastest, greedy, short chains) to 9 (best, lazy,
+        long chains) */
+    explicit LZMatcher(int level = DEFAULT_LEVEL);
+
+    /* Parse the whole buffer into tokens
+      params:
+        data: the bytes to parse
+        tokens: the output, cleared first */
+    void parse(const vector<byte>& data, vector<LZToken>& tokens);
+
+  private:
+    /* hash of the MIN_MATCH bytes starting at pos */
+    static unsigned int hash(const byte* data, unsigned int pos);
+
+    /* add pos to the hash chains */
+    void insert(const byte* data, unsigned int pos);
+
+    /* return the number of equal bytes at a and b, at most maxLength,
+      compared 8 at a time */
+    static unsigned int matchLength(const byte* a, const byte* b,
+                                    unsigned int maxLength);
+
+    /* find the longest earlier match of the bytes at pos
+      params:
+        data: the buffer
+        n: the number of bytes of the buffer
+        pos: the position to match
+        prevLength: length of a match already found, only longer ones count
+        distance: set to the distance of the match found
+      return: the length of the match found, 0 if none is longer */
+    unsigned int longestMatch(const byte* data, unsigned int n,
+                              unsigned int pos, unsigned int prevLength,
+                              unsigned int& distance) const;
+};
+
+#endif  // LZMATCHER_HPP
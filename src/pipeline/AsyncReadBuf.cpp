@@ -0,0 +1,125 @@
+/**
+ * This file shows the implementation of AsyncReadBuf class methods.
+ * Declaration can be found in 'AsyncReadBuf.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "AsyncReadBuf.hpp"
+
+const unsigned int AsyncReadBuf::BLOCK_SIZE = 1 << 20;
+const unsigned int AsyncReadBuf::QUEUE_DEPTH = 4;
+
+/* Constructor of AsyncReadBuf, starts reading at the current position of
+      the source */
+AsyncReadBuf::AsyncReadBuf(streambuf* src)
+    : source(src), blocks(QUEUE_DEPTH), current(0), currentOffset(0),
+      nextOffset(0), ended(false), stopping(false) {
+    streamoff offset = source->pubseekoff(0, ios_base::cur, ios_base::in);
+    start(offset < 0 ? 0 : offset);
+}
+
+/* Destructor, stops the thread */
+AsyncReadBuf::~AsyncReadBuf() { stop(); }
+
+/* Stop the thread, nothing more is read */
+void AsyncReadBuf::close() {
+    stop();
+    ended = true;
+}
+
+/* Take the next block once the current one is consumed */
+AsyncReadBuf::int_type AsyncReadBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    if (ended) {
+        return traits_type::eof();
+    }
+    delete current;
+    current = blocks.pop();
+    if (current == 0) {
+        ended = true;
+        currentOffset = nextOffset;
+        setg(0, 0, 0);
+        return traits_type::eof();
+    }
+    currentOffset = nextOffset;
+    nextOffset += current->size();
+    setg(current->data(), current->data(), current->data() + current->size());
+    return traits_type::to_int_type(*gptr());
+}
+
+/* Move to an offset of the source, or tell the current one, the mode does
+      not matter to a buffer that only reads */
+AsyncReadBuf::pos_type AsyncReadBuf::seekoff(off_type off,
+                                             ios_base::seekdir dir,
+                                             ios_base::openmode) {
+    // the position of the consumer, inside the current block
+    streamoff here = currentOffset + (gptr() - eback());
+    if (dir == ios_base::cur && off == 0) {
+        return here;
+    }
+    streamoff target = off;
+    if (dir == ios_base::cur) {
+        target = here + off;
+    }
+    stop();
+    if (dir == ios_base::end) {
+        target = source->pubseekoff(off, ios_base::end, ios_base::in);
+    }
+    target = source->pubseekpos(target, ios_base::in);
+    start(target < 0 ? 0 : target);
+    return target;
+}
+
+/* Move to an offset of the source */
+AsyncReadBuf::pos_type AsyncReadBuf::seekpos(pos_type pos,
+                                             ios_base::openmode which) {
+    return seekoff(pos, ios_base::beg, which);
+}
+
+/* Start the thread at the given source offset */
+void AsyncReadBuf::start(streamoff offset) {
+    currentOffset = offset;
+    nextOffset = offset;
+    ended = false;
+    stopping = false;
+    setg(0, 0, 0);
+    reader = thread(&AsyncReadBuf::readBlocks, this);
+}
+
+/* Stop the thread and drop every block read ahead */
+void AsyncReadBuf::stop() {
+    stopping = true;
+    if (reader.joinable()) {
+        // the thread may wait for room in the queue: drain up to its last
+        // push, the end marker, unless it was consumed already
+        bool sawEnd = ended;
+        while (!sawEnd) {
+            vector<char>* block = blocks.pop();
+            sawEnd = block == 0;
+            delete block;
+        }
+        reader.join();
+    }
+    delete current;
+    current = 0;
+    setg(0, 0, 0);
+}
+
+/* The loop of the thread, read blocks until the end of the source */
+void AsyncReadBuf::readBlocks() {
+    while (!stopping) {
+        vector<char>* block = new vector<char>(BLOCK_SIZE);
+        streamsize count = source->sgetn(block->data(), BLOCK_SIZE);
+        if (count <= 0) {
+            delete block;
+            break;
+        }
+        block->resize(count);
+        blocks.push(block);
+    }
+    // the end, or the acknowledgement of a stop
+    blocks.push(0);
+}
@@ -0,0 +1,76 @@
+/**
+ * This file declares the AsyncReadBuf class, a stream buffer that reads
+ * ahead of its consumer on a thread of its own
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef ASYNCREADBUF_HPP
+#define ASYNCREADBUF_HPP
+
+#include <atomic>
+#include <streambuf>
+#include <thread>
+#include <vector>
+#include "SpscQueue.hpp"
+
+using namespace std;
+
+/** The reader stage of a pipeline: a thread fills large blocks from the
+ * source buffer while the istream on top of this one decodes the blocks
+ * before them. Wrap a file like
+ *   ifstream inFile(name, ios::binary);
+ *   AsyncReadBuf inBuf(inFile.rdbuf());
+ *   istream in(&inBuf);
+ *   ...
+ *   inBuf.close();
+ * Seeking stops the thread, moves the source and starts again */
+class AsyncReadBuf : public streambuf {
+  private:
+    streambuf* source;                  // where the blocks are read from
+    SpscQueue<vector<char>*> blocks;    // read blocks, 0 after the last one
+    vector<char>* current;              // the block being consumed
+    streamoff currentOffset;            // source offset of current
+    streamoff nextOffset;               // source offset of the next block
+    bool ended;                         // whether the last block was taken
+    atomic<bool> stopping;              // asks the thread to stop
+    thread reader;                      // the reading thread
+
+  public:
+    static const unsigned int BLOCK_SIZE;   // bytes per read
+    static const unsigned int QUEUE_DEPTH;  // blocks read ahead at most
+
+    /* Constructor of AsyncReadBuf, starts reading at the current position
+      of the source
+      param: the source buffer, such as the rdbuf of an ifstream */
+    explicit AsyncReadBuf(streambuf* src);
+
+    /* Destructor, stops the thread */
+    ~AsyncReadBuf();
+
+    /* Stop the thread, nothing more is read, close it before the file */
+    void close();
+
+  protected:
+    /* Take the next block once the current one is consumed */
+    int_type underflow() override;
+
+    /* Move to an offset of the source, or tell the current one */
+    pos_type seekoff(off_type off, ios_base::seekdir dir,
+                     ios_base::openmode which) override;
+
+    /* Move to an offset of the source */
+    pos_type seekpos(pos_type pos, ios_base::openmode which) override;
+
+  private:
+    /* Start the thread at the given source offset */
+    void start(streamoff offset);
+
+    /* Stop the thread and drop every block read ahead */
+    void stop();
+
+    /* The loop of the thread, read blocks until the end of the source */
+    void readBlocks();
+};
+
+#endif  // ASYNCREADBUF_HPP
@@ -0,0 +1,90 @@
+/**
+ * This file shows the implementation of AsyncWriteBuf class methods.
+ * Declaration can be found in 'AsyncWriteBuf.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "AsyncWriteBuf.hpp"
+
+const unsigned int AsyncWriteBuf::BLOCK_SIZE = 1 << 20;
+const unsigned int AsyncWriteBuf::QUEUE_DEPTH = 4;
+
+/* Constructor of AsyncWriteBuf, starts the thread */
+AsyncWriteBuf::AsyncWriteBuf(streambuf* snk)
+    : sink(snk), blocks(QUEUE_DEPTH), current(0), closed(false), failed(false) {
+    current = new vector<char>(BLOCK_SIZE);
+    setp(current->data(), current->data() + current->size());
+    writer = thread(&AsyncWriteBuf::writeBlocks, this);
+}
+
+/* Destructor, closes the buffer if it is not yet */
+AsyncWriteBuf::~AsyncWriteBuf() {
+    close();
+    delete current;
+}
+
+/* Hand over the last block and wait until every block is written */
+void AsyncWriteBuf::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+    handOver();
+    blocks.push(0);
+    writer.join();
+    if (sink->pubsync() != 0) {
+        failed = true;
+    }
+    setp(0, 0);
+}
+
+/* Check if a write failed, the output is incomplete then */
+bool AsyncWriteBuf::isFailed() { return failed; }
+
+/* Hand over the full block and start a new one */
+AsyncWriteBuf::int_type AsyncWriteBuf::overflow(int_type c) {
+    if (closed || failed) {
+        return traits_type::eof();
+    }
+    handOver();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/* Hand over the current block, even if it is not full */
+int AsyncWriteBuf::sync() {
+    if (!closed) {
+        handOver();
+    }
+    return failed ? -1 : 0;
+}
+
+/* Hand over the current block if it holds anything */
+void AsyncWriteBuf::handOver() {
+    if (pptr() == pbase()) {
+        return;
+    }
+    current->resize(pptr() - pbase());
+    blocks.push(current);
+    current = new vector<char>(BLOCK_SIZE);
+    setp(current->data(), current->data() + current->size());
+}
+
+/* The loop of the thread, write blocks until the end marker */
+void AsyncWriteBuf::writeBlocks() {
+    while (1) {
+        vector<char>* block = blocks.pop();
+        if (block == 0) break;
+        // after a failed write the blocks are only dropped, the producer
+        // must not wait for room
+        if (!failed && sink->sputn(block->data(), block->size()) !=
+                           (streamsize)block->size()) {
+            failed = true;
+        }
+        delete block;
+    }
+}
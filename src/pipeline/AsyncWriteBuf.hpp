@@ -0,0 +1,70 @@
+/**
+ * This file declares the AsyncWriteBuf class, a stream buffer that writes
+ * behind its producer on a thread of its own
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef ASYNCWRITEBUF_HPP
+#define ASYNCWRITEBUF_HPP
+
+#include <atomic>
+#include <streambuf>
+#include <thread>
+#include <vector>
+#include "SpscQueue.hpp"
+
+using namespace std;
+
+/** The writer stage of a pipeline: the ostream on top of this one fills
+ * large blocks that a thread writes to the sink buffer while the next
+ * ones are being encoded. Wrap a file like
+ *   ofstream outFile(name, ios::binary);
+ *   AsyncWriteBuf outBuf(outFile.rdbuf());
+ *   ostream out(&outBuf);
+ *   ...
+ *   outBuf.close();
+ * and close it before the file */
+class AsyncWriteBuf : public streambuf {
+  private:
+    streambuf* sink;                  // where the blocks are written to
+    SpscQueue<vector<char>*> blocks;  // full blocks, 0 after the last one
+    vector<char>* current;            // the block being filled
+    bool closed;                      // whether close was called
+    atomic<bool> failed;              // whether a write fell short
+    thread writer;                    // the writing thread
+
+  public:
+    static const unsigned int BLOCK_SIZE;   // bytes per write
+    static const unsigned int QUEUE_DEPTH;  // blocks waiting at most
+
+    /* Constructor of AsyncWriteBuf, starts the thread
+      param: the sink buffer, such as the rdbuf of an ofstream */
+    explicit AsyncWriteBuf(streambuf* snk);
+
+    /* Destructor, closes the buffer if it is not yet */
+    ~AsyncWriteBuf();
+
+    /* Hand over the last block and wait until every block is written and
+      the sink is flushed */
+    void close();
+
+    /* Check if a write failed, the output is incomplete then */
+    bool isFailed();
+
+  protected:
+    /* Hand over the full block and start a new one */
+    int_type overflow(int_type c) override;
+
+    /* Hand over the current block, even if it is not full */
+    int sync() override;
+
+  private:
+    /* Hand over the current block if it holds anything */
+    void handOver();
+
+    /* The loop of the thread, write blocks until the end marker */
+    void writeBlocks();
+};
+
+#endif  // ASYNCWRITEBUF_HPP
@@ -0,0 +1,50 @@
+/**
+ * This file shows the implementation of InputFile class methods.
+ * Declaration can be found in 'InputFile.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "InputFile.hpp"
+
+/* Constructor of InputFile, opens the file */
+InputFile::InputFile(string fileName, bool useUring, bool direct)
+    : uringBuf(0), asyncBuf(0), in(0) {
+    if (useUring || direct) {
+        uringBuf = new UringReadBuf(fileName, direct);
+        if (!uringBuf->isOpen()) {
+            delete uringBuf;
+            uringBuf = 0;
+        }
+    }
+    if (uringBuf != 0) {
+        in.rdbuf(uringBuf);
+    } else {
+        file.open(fileName, ios::binary);
+        asyncBuf = new AsyncReadBuf(file.rdbuf());
+        in.rdbuf(asyncBuf);
+    }
+}
+
+/* Destructor, closes the file */
+InputFile::~InputFile() {
+    close();
+    delete uringBuf;
+    delete asyncBuf;
+}
+
+/* return the stream to read from */
+istream& InputFile::getStream() { return in; }
+
+/* Check if the file is read through the blocks of UringReadBuf */
+bool InputFile::isUring() { return uringBuf != 0; }
+
+/* Stop reading and close the file, the thread before the file */
+void InputFile::close() {
+    if (uringBuf != 0) {
+        uringBuf->close();
+    } else {
+        asyncBuf->close();
+        file.close();
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * This file declares the InputFile class, which opens a file for reading
+ * on the fastest I/O backend at hand
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef INPUTFILE_HPP
+#define INPUTFILE_HPP
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "AsyncReadBuf.hpp"
+#include "UringReadBuf.hpp"
+
+using namespace std;
+
+/** An input file read ahead of its consumer: through io_uring where the
+ * kernel allows it, by an ifstream on a reader thread otherwise. Either
+ * way the coders see a plain istream */
+class InputFile {
+  private:
+    ifstream file;            // the file of the iostream backend
+    UringReadBuf* uringBuf;   // the io_uring backend, 0 if unused
+    AsyncReadBuf* asyncBuf;   // the iostream backend, 0 if unused
+    istream in;               // the stream on top of either backend
+
+  public:
+    /* Constructor of InputFile, opens the file
+      params:
+        fileName: the name of the file
+        useUring: whether io_uring may be used
+        direct: whether to keep the file out of the page cache, which
+          takes the aligned blocks of UringReadBuf even without a ring */
+    explicit InputFile(string fileName, bool useUring = true,
+                        bool direct = false);
+
+    /* Destructor, closes the file */
+    ~InputFile();
+
+    /* return the stream to read from, should be used by reference */
+    istream& getStream();
+
+    /* Check if the file is read through the blocks of UringReadBuf,
+      io_uring or direct */
+    bool isUring();
+
+    /* Stop reading and close the file */
+    void close();
+};
+
+#endif  // INPUTFILE_HPP
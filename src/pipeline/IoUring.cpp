@@ -0,0 +1,241 @@
+/**
+ * This file shows the implementation of IoUring class methods.
+ * Declaration can be found in 'IoUring.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "IoUring.hpp"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+/* Constructor of IoUring, the ring is not open yet */
+IoUring::IoUring()
+    : ringFd(-1), entries(0), inFlight(0), sqRing(0), cqRing(0), sqes(0),
+      sqRingSize(0), cqRingSize(0), sqesSize(0) {}
+
+/* Destructor, closes the ring */
+IoUring::~IoUring() { close(); }
+
+/* Check if the ring is open */
+bool IoUring::isOpen() { return ringFd >= 0; }
+
+/* return the number of operations submitted and not yet waited for */
+unsigned int IoUring::getInFlight() { return inFlight; }
+
+/* Check once per process if io_uring rings can be set up */
+bool IoUring::isAvailable() {
+    static const bool available = IoUring().open(1);
+    return available;
+}
+
+/* Queue a read of length bytes at offset of fd into buf */
+bool IoUring::submitRead(int fd, char* buf, unsigned int length,
+                         unsigned long long offset, unsigned long long tag) {
+#ifdef HAVE_IO_URING
+    return submit(IORING_OP_READ, fd, buf, length, offset, tag);
+#else
+    return false;
+#endif
+}
+
+/* Queue a write of length bytes of buf at offset of fd */
+bool IoUring::submitWrite(int fd, const char* buf, unsigned int length,
+                          unsigned long long offset, unsigned long long tag) {
+#ifdef HAVE_IO_URING
+    return submit(IORING_OP_WRITE, fd, buf, length, offset, tag);
+#else
+    return false;
+#endif
+}
+
+#ifdef HAVE_IO_URING
+
+/* Set up the ring, return false if io_uring is unavailable or the
+  kernel lacks the read and write operations */
+bool IoUring::open(unsigned int depth) {
+    close();
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, depth, &params);
+    if (fd < 0) {
+        return false;
+    }
+    ringFd = fd;
+    entries = params.sq_entries;
+
+    // map the rings, in one mapping if the kernel allows it
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && cqRingSize > sqRingSize) {
+        sqRingSize = cqRingSize;
+    }
+    sqRing = mmap(0, sqRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = 0;
+        close();
+        return false;
+    }
+    if (single) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(0, cqRingSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            cqRing = 0;
+            close();
+            return false;
+        }
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = mmap(0, sqesSize, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        sqes = 0;
+        close();
+        return false;
+    }
+
+    char* sq = (char*)sqRing;
+    sqHead = (unsigned int*)(sq + params.sq_off.head);
+    sqTail = (unsigned int*)(sq + params.sq_off.tail);
+    sqMask = (unsigned int*)(sq + params.sq_off.ring_mask);
+    sqArray = (unsigned int*)(sq + params.sq_off.array);
+    char* cq = (char*)cqRing;
+    cqHead = (unsigned int*)(cq + params.cq_off.head);
+    cqTail = (unsigned int*)(cq + params.cq_off.tail);
+    cqMask = (unsigned int*)(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+
+    // rings from kernels before 5.6 set up but fail every read and write
+    if (!probe()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/* Helper method for open, check the kernel knows the read and write
+  operations */
+bool IoUring::probe() {
+#ifdef IO_URING_OP_SUPPORTED
+    const unsigned int count = 256;
+    unsigned long size =
+        sizeof(io_uring_probe) + count * sizeof(io_uring_probe_op);
+    char* buf = new char[size];
+    memset(buf, 0, size);
+    io_uring_probe* ops = (io_uring_probe*)buf;
+    bool supported =
+        syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, ops,
+                count) == 0;
+    int needed[] = {IORING_OP_READ, IORING_OP_WRITE};
+    for (int op : needed) {
+        supported = supported && op <= ops->last_op &&
+                    (ops->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+    delete[] buf;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/* Release the ring, every operation should be completed */
+void IoUring::close() {
+    if (sqes != 0) munmap(sqes, sqesSize);
+    if (cqRing != 0 && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing != 0) munmap(sqRing, sqRingSize);
+    if (ringFd >= 0) ::close(ringFd);
+    sqes = sqRing = cqRing = 0;
+    ringFd = -1;
+    inFlight = 0;
+}
+
+/* Helper method for submitRead and submitWrite */
+bool IoUring::submit(int op, int fd, const char* buf, unsigned int length,
+                     unsigned long long offset, unsigned long long tag) {
+    if (ringFd < 0 || inFlight >= entries) {
+        return false;
+    }
+    // fill the next entry, then publish it by moving the tail
+    unsigned int tail = *sqTail;
+    unsigned int index = tail & *sqMask;
+    io_uring_sqe* sqe = (io_uring_sqe*)sqes + index;
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = op;
+    sqe->fd = fd;
+    sqe->addr = (unsigned long long)buf;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = tag;
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    int submitted;
+    do {
+        submitted = syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, 0, 0);
+    } while (submitted < 0 && errno == EINTR);
+    if (submitted != 1) {
+        // the kernel did not take it, take it back
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        return false;
+    }
+    inFlight++;
+    return true;
+}
+
+/* Wait for one operation to complete */
+bool IoUring::wait(unsigned long long& tag, int& result) {
+    if (inFlight == 0) {
+        return false;
+    }
+    unsigned int head = *cqHead;
+    while (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+        syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS,
+                0, 0);
+    }
+    io_uring_cqe* cqe = (io_uring_cqe*)cqes + (head & *cqMask);
+    tag = cqe->user_data;
+    result = cqe->res;
+    __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+    inFlight--;
+    return true;
+}
+
+#else
+
+/* Set up the ring, io_uring is not part of this build */
+bool IoUring::open(unsigned int depth) { return false; }
+
+/* Release the ring, there is none */
+void IoUring::close() {}
+
+/* Helper method for open, there are no operations */
+bool IoUring::probe() { return false; }
+
+/* Helper method for submitRead and submitWrite */
+bool IoUring::submit(int op, int fd, const char* buf, unsigned int length,
+                     unsigned long long offset, unsigned long long tag) {
+    return false;
+}
+
+/* Wait for one operation to complete, there is none */
+bool IoUring::wait(unsigned long long& tag, int& result) { return false; }
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * This file declares the IoUring class, a minimal io_uring submission and
+ * completion ring for file reads and writes on Linux
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef IOURING_HPP
+#define IOURING_HPP
+
+using namespace std;
+
+/** A ring set up with the raw io_uring system calls, so no library is
+ * needed. Reads and writes at explicit offsets are queued with submitRead
+ * and submitWrite and waited for with wait; up to the number of entries
+ * may be in flight. Where the kernel or the build lacks io_uring, or a
+ * sandbox forbids it, open fails and callers use plain streams */
+class IoUring {
+  private:
+    int ringFd;                 // the ring, -1 if it is not open
+    unsigned int entries;       // submission queue entries
+    unsigned int inFlight;      // submitted and not yet completed
+    void* sqRing;               // mapped submission ring
+    void* cqRing;               // mapped completion ring, may be sqRing
+    void* sqes;                 // mapped submission entries
+    unsigned long sqRingSize;   // bytes mapped at sqRing
+    unsigned long cqRingSize;   // bytes mapped at cqRing
+    unsigned long sqesSize;     // bytes mapped at sqes
+    unsigned int* sqHead;       // ring fields inside the mappings
+    unsigned int* sqTail;
+    unsigned int* sqMask;
+    unsigned int* sqArray;
+    unsigned int* cqHead;
+    unsigned int* cqTail;
+    unsigned int* cqMask;
+    void* cqes;
+
+  public:
+    /* Constructor of IoUring, the ring is not open yet */
+    IoUring();
+
+    /* Destructor, closes the ring */
+    ~IoUring();
+
+    /* Set up the ring, return false if io_uring is unavailable or the
+      kernel lacks the read and write operations
+      param: the number of operations in flight at most */
+    bool open(unsigned int depth);
+
+    /* Check if the ring is open */
+    bool isOpen();
+
+    /* Release the ring, every operation should be completed */
+    void close();
+
+    /* Queue a read of length bytes at offset of fd into buf
+      params:
+        fd: an open file descriptor
+        buf: the destination, length bytes
+        length: the number of bytes to read
+        offset: the offset in the file
+        tag: returned by wait with the result
+      return: false if the ring is full */
+    bool submitRead(int fd, char* buf, unsigned int length,
+                    unsigned long long offset, unsigned long long tag);
+
+    /* Queue a write of length bytes of buf at offset of fd, see
+      submitRead */
+    bool submitWrite(int fd, const char* buf, unsigned int length,
+                     unsigned long long offset, unsigned long long tag);
+
+    /* Wait for one operation to complete
+      params:
+        tag: set to the tag of the operation
+        result: set to the bytes transferred, a negative errno on failure
+      return: false if nothing is in flight */
+    bool wait(unsigned long long& tag, int& result);
+
+    /* return the number of operations submitted and not yet waited for */
+    unsigned int getInFlight();
+
+    /* Check once per process if io_uring rings can be set up */
+    static bool isAvailable();
+
+  private:
+    /* Helper method for open, check the kernel knows the read and write
+      operations */
+    bool probe();
+
+    /* Helper method for submitRead and submitWrite */
+    bool submit(int op, int fd, const char* buf, unsigned int length,
+                unsigned long long offset, unsigned long long tag);
+};
+
+#endif  // IOURING_HPP
@@ -0,0 +1,82 @@
+/**
+ * This file shows the implementation of OutputFile class methods.
+ * Declaration can be found in 'OutputFile.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "OutputFile.hpp"
+
+#include <unistd.h>
+
+/* Constructor of OutputFile, creates or truncates the file */
+OutputFile::OutputFile(string fileName, bool useUring, bool direct)
+    : uringBuf(0), asyncBuf(0), pipeBuf(0), out(0) {
+    if (fileName == "-") {
+        pipeBuf = new PipeWriteBuf(1);
+        out.rdbuf(pipeBuf);
+        return;
+    }
+    if (useUring || direct) {
+        uringBuf = new UringWriteBuf(fileName, direct);
+        if (!uringBuf->isOpen()) {
+            delete uringBuf;
+            uringBuf = 0;
+        }
+    }
+    if (uringBuf != 0) {
+        out.rdbuf(uringBuf);
+    } else {
+        file.open(fileName, ios::binary);
+        asyncBuf = new AsyncWriteBuf(file.rdbuf());
+        out.rdbuf(asyncBuf);
+    }
+}
+
+/* Destructor, closes the file */
+OutputFile::~OutputFile() {
+    close();
+    delete uringBuf;
+    delete asyncBuf;
+    delete pipeBuf;
+}
+
+/* return the stream to write to */
+ostream& OutputFile::getStream() { return out; }
+
+/* Check if the file is written through the blocks of UringWriteBuf */
+bool OutputFile::isUring() { return uringBuf != 0; }
+
+/* Check if the file is a pipe that takes spliceFrom without copying */
+bool OutputFile::isPipe() { return pipeBuf != 0 && pipeBuf->isPipe(); }
+
+/* Move a range of a file to the output after what is written */
+bool OutputFile::spliceFrom(int inFd, unsigned long long offset,
+                            unsigned long long length) {
+    if (pipeBuf != 0) {
+        return pipeBuf->spliceFrom(inFd, offset, length);
+    }
+    // any other backend copies it
+    vector<char> data(length);
+    if (pread(inFd, data.data(), length, offset) != (ssize_t)length) {
+        return false;
+    }
+    out.write(data.data(), length);
+    return (bool)out;
+}
+
+/* Write everything and close the file, the thread before the file */
+bool OutputFile::close() {
+    if (pipeBuf != 0) {
+        pipeBuf->close();
+        return !pipeBuf->isFailed();
+    } else if (uringBuf != 0) {
+        uringBuf->close();
+        return !uringBuf->isFailed();
+    }
+    asyncBuf->close();
+    if (file.is_open()) {
+        file.close();
+    }
+    return !asyncBuf->isFailed() && !file.fail();
+}
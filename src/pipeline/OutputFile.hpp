@@ -0,0 +1,70 @@
+/**
+ * This file declares the OutputFile class, which opens a file for writing
+ * on the fastest I/O backend at hand
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef OUTPUTFILE_HPP
+#define OUTPUTFILE_HPP
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "AsyncWriteBuf.hpp"
+#include "PipeWriteBuf.hpp"
+#include "UringWriteBuf.hpp"
+
+using namespace std;
+
+/** An output file written behind its producer: through io_uring where the
+ * kernel allows it, by an ofstream on a writer thread otherwise. The name
+ * "-" is the standard output, written by a PipeWriteBuf. Either way the
+ * coders see a plain ostream */
+class OutputFile {
+  private:
+    ofstream file;             // the file of the iostream backend
+    UringWriteBuf* uringBuf;   // the io_uring backend, 0 if unused
+    AsyncWriteBuf* asyncBuf;   // the iostream backend, 0 if unused
+    PipeWriteBuf* pipeBuf;     // the standard output, 0 if unused
+    ostream out;               // the stream on top of the backend
+
+  public:
+    /* Constructor of OutputFile, creates or truncates the file
+      params:
+        fileName: the name of the file, "-" for the standard output
+        useUring: whether io_uring may be used
+        direct: whether to keep the file out of the page cache, which
+          takes the aligned blocks of UringWriteBuf even without a ring */
+    explicit OutputFile(string fileName, bool useUring = true,
+                         bool direct = false);
+
+    /* Destructor, closes the file */
+    ~OutputFile();
+
+    /* return the stream to write to, should be used by reference */
+    ostream& getStream();
+
+    /* Check if the file is written through the blocks of UringWriteBuf,
+      io_uring or direct */
+    bool isUring();
+
+    /* Check if the file is a pipe that takes spliceFrom without copying */
+    bool isPipe();
+
+    /* Move a range of a file to the output after what is written, without
+      copying it through this process if the output is a pipe
+      params:
+        inFd: a file descriptor open for reading
+        offset: the offset of the range
+        length: the number of bytes of the range
+      return: false if the range could not be written whole */
+    bool spliceFrom(int inFd, unsigned long long offset,
+                    unsigned long long length);
+
+    /* Write everything and close the file
+      return: false if a write failed, the file is incomplete then */
+    bool close();
+};
+
+#endif  // OUTPUTFILE_HPP
@@ -0,0 +1,162 @@
+/**
+ * This file shows the implementation of PipeWriteBuf class methods.
+ * Declaration can be found in 'PipeWriteBuf.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "PipeWriteBuf.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+
+const unsigned int PipeWriteBuf::BLOCK_SIZE = 1 << 18;
+
+/* the pages of a block, mapped rather than allocated, since the pipe may
+   still hold them when they are let go and the heap would hand them out
+   again */
+static char* mapBlock() {
+    void* block = mmap(0, PipeWriteBuf::BLOCK_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return block == MAP_FAILED ? 0 : (char*)block;
+}
+
+/* Constructor of PipeWriteBuf */
+PipeWriteBuf::PipeWriteBuf(int fd)
+    : fd(fd), pipe(false), failed(false), block(mapBlock()) {
+    // a pipe as large as the kernel lets us
+    struct stat status;
+    if (fstat(fd, &status) == 0 && S_ISFIFO(status.st_mode)) {
+        fcntl(fd, F_SETPIPE_SZ, 1 << 20);
+        pipe = fcntl(fd, F_GETPIPE_SZ) > 0;
+    }
+    if (block == 0) {
+        failed = true;
+        return;
+    }
+    setp(block, block + BLOCK_SIZE);
+}
+
+/* Destructor, writes what is left */
+PipeWriteBuf::~PipeWriteBuf() {
+    close();
+    if (block != 0) {
+        munmap(block, BLOCK_SIZE);
+    }
+}
+
+/* Check if the descriptor is a pipe */
+bool PipeWriteBuf::isPipe() { return pipe; }
+
+/* Check if a write failed, the output is incomplete then */
+bool PipeWriteBuf::isFailed() { return failed; }
+
+/* Write what is buffered, then move a range of a file to the pipe */
+bool PipeWriteBuf::spliceFrom(int inFd, unsigned long long offset,
+                              unsigned long long length) {
+    sync();
+    loff_t from = offset;
+    unsigned long long left = length;
+    while (pipe && left > 0) {
+        ssize_t moved = splice(inFd, &from, fd, 0, left, SPLICE_F_MORE);
+        if (moved < 0 && errno == EINTR) continue;
+        if (moved <= 0) break;
+        left -= moved;
+    }
+    // what splice did not move is copied
+    while (left > 0 && !failed) {
+        size_t size = left < BLOCK_SIZE ? left : BLOCK_SIZE;
+        ssize_t count = pread(inFd, pbase(), size, from);
+        if (count <= 0) {
+            return false;
+        }
+        writeAll(pbase(), count);
+        from += count;
+        left -= count;
+    }
+    return !failed;
+}
+
+/* Write what is buffered, the descriptor stays open */
+void PipeWriteBuf::close() { sync(); }
+
+/* Hand over the full block and start the next one */
+PipeWriteBuf::int_type PipeWriteBuf::overflow(int_type c) {
+    if (failed) {
+        return traits_type::eof();
+    }
+    handOver();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/* Write the current block, even if it is not full */
+int PipeWriteBuf::sync() {
+    handOver();
+    return failed ? -1 : 0;
+}
+
+/* Hand over the current block if it holds anything, a full one by
+      vmsplice, then a fresh block replaces it */
+void PipeWriteBuf::handOver() {
+    size_t length = pptr() - pbase();
+    if (length == 0 || failed) {
+        return;
+    }
+    // only full blocks count towards what the pipe may still hold
+    if (!pipe || length < BLOCK_SIZE) {
+        writeAll(pbase(), length);
+        setp(pbase(), pbase() + BLOCK_SIZE);
+        return;
+    }
+    size_t done = 0;
+    while (done < length) {
+        iovec iov = {pbase() + done, length - done};
+        ssize_t count = vmsplice(fd, &iov, 1, 0);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            // vmsplice is refused, every block is copied from now on
+            pipe = false;
+            writeAll(pbase() + done, length - done);
+            break;
+        }
+        done += count;
+    }
+    if (!replaceBlock()) {
+        failed = true;
+        setp(0, 0);
+        return;
+    }
+    setp(block, block + BLOCK_SIZE);
+}
+
+/* Helper method for handOver, map a fresh block in place of the one given
+      to the pipe */
+bool PipeWriteBuf::replaceBlock() {
+    // the pipe, and whoever it splices the pages to, keep them alive
+    char* fresh = mapBlock();
+    munmap(block, BLOCK_SIZE);
+    block = fresh;
+    return block != 0;
+}
+
+/* Copy length bytes to the descriptor with write */
+void PipeWriteBuf::writeAll(const char* data, size_t length) {
+    while (length > 0 && !failed) {
+        ssize_t count = write(fd, data, length);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            failed = true;
+            break;
+        }
+        data += count;
+        length -= count;
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * This file declares the PipeWriteBuf class, a stream buffer that writes
+ * to a file descriptor, handing whole pages to a pipe without copying
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef PIPEWRITEBUF_HPP
+#define PIPEWRITEBUF_HPP
+
+#include <streambuf>
+
+using namespace std;
+
+/** The writer stage for the standard output. When it is a pipe, full
+ * blocks of aligned pages are given to the pipe with vmsplice, which maps
+ * them rather than copying them. The reader may keep the pages well after
+ * it has read the pipe, splicing them on, so a block given away is never
+ * written again: it is unmapped, the pipe keeping its pages alive, and a
+ * fresh one is mapped. Partial blocks, at a flush, are copied with write,
+ * as is everything when the descriptor is not a pipe or vmsplice fails.
+ * spliceFrom moves a range of a file into the pipe without it ever
+ * entering this process */
+class PipeWriteBuf : public streambuf {
+  private:
+    int fd;                  // the output, not closed by this buffer
+    bool pipe;               // whether fd is a pipe that takes vmsplice
+    bool failed;             // whether a write failed
+    char* block;             // the block being filled, its own pages
+
+  public:
+    static const unsigned int BLOCK_SIZE;  // bytes per vmsplice, aligned
+
+    /* Constructor of PipeWriteBuf
+      param: the descriptor to write to, such as 1 for the standard
+        output */
+    explicit PipeWriteBuf(int fd);
+
+    /* Destructor, writes what is left */
+    ~PipeWriteBuf();
+
+    /* Check if the descriptor is a pipe */
+    bool isPipe();
+
+    /* Check if a write failed, the output is incomplete then */
+    bool isFailed();
+
+    /* Write what is buffered, then move a range of a file to the pipe with
+      splice, copying it if splice refuses
+      params:
+        inFd: a file descriptor open for reading
+        offset: the offset of the range
+        length: the number of bytes of the range
+      return: false if the range could not be written whole */
+    bool spliceFrom(int inFd, unsigned long long offset,
+                    unsigned long long length);
+
+    /* Write what is buffered, the descriptor stays open */
+    void close();
+
+  protected:
+    /* Hand over the full block and start the next one */
+    int_type overflow(int_type c) override;
+
+    /* Write the current block, even if it is not full */
+    int sync() override;
+
+  private:
+    /* Hand over the current block if it holds anything, a full one by
+      vmsplice, then a fresh block replaces it */
+    void handOver();
+
+    /* Helper method for handOver, map a fresh block in place of the one
+      given to the pipe, return false if there is no memory */
+    bool replaceBlock();
+
+    /* Copy length bytes to the descriptor with write */
+    void writeAll(const char* data, size_t length);
+};
+
+#endif  // PIPEWRITEBUF_HPP
@@ -0,0 +1,133 @@
+/**
+ * This file declares and implements the SpscQueue class template, a
+ * bounded lock-free queue between one producer and one consumer thread
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+/** A ring of slots. Only the producer moves the tail and only the consumer
+ * moves the head, so neither needs a lock: a release store of its index
+ * publishes the slot, an acquire load of the other index sees it. The
+ * indices are padded onto their own cache lines so the two threads do not
+ * fight over one line; padding rather than alignas, which operator new
+ * does not honour before C++17. push and pop block on a condition variable
+ * when the queue is full or empty; the other side only takes the lock to
+ * wake it when a waiter is counted */
+template <typename T>
+class SpscQueue {
+  private:
+    vector<T> slots;           // one more than the capacity
+    char headPad[64];          // keeps head off the line of slots
+    atomic<size_t> head;       // next slot to pop, consumer side
+    char tailPad[64];          // keeps tail off the line of head
+    atomic<size_t> tail;       // next slot to push, producer side
+    char waitPad[64];          // keeps the waits off the line of tail
+    atomic<int> waiters;       // threads blocked in push or pop
+    mutex lock;                // guards the waits
+    condition_variable moved;  // an item was pushed or popped
+
+  public:
+    /* Constructor of SpscQueue
+      param: the number of items the queue holds at most */
+    explicit SpscQueue(size_t capacity)
+        : slots(capacity + 1), head(0), tail(0), waiters(0) {}
+
+    /* Add an item unless the queue is full, producer only
+      param: the item
+      return: false if the queue is full */
+    bool tryPush(const T& item) {
+        if (!put(item)) {
+            return false;
+        }
+        wake();
+        return true;
+    }
+
+    /* Take the oldest item unless the queue is empty, consumer only
+      param: item, set to the item taken
+      return: false if the queue is empty */
+    bool tryPop(T& item) {
+        if (!take(item)) {
+            return false;
+        }
+        wake();
+        return true;
+    }
+
+    /* Add an item, waiting while the queue is full, producer only */
+    void push(const T& item) {
+        if (!put(item)) {
+            wait([&]() { return put(item); });
+        }
+        wake();
+    }
+
+    /* Take the oldest item, waiting while the queue is empty, consumer
+      only */
+    T pop() {
+        T item;
+        if (!take(item)) {
+            wait([&]() { return take(item); });
+        }
+        wake();
+        return item;
+    }
+
+  private:
+    /* Helper of tryPush and push, add the item if there is room */
+    bool put(const T& item) {
+        size_t t = tail.load(memory_order_relaxed);
+        size_t next = (t + 1) % slots.size();
+        if (next == head.load(memory_order_acquire)) {
+            return false;
+        }
+        slots[t] = item;
+        tail.store(next, memory_order_release);
+        return true;
+    }
+
+    /* Helper of tryPop and pop, take the oldest item if there is one */
+    bool take(T& item) {
+        size_t h = head.load(memory_order_relaxed);
+        if (h == tail.load(memory_order_acquire)) {
+            return false;
+        }
+        item = slots[h];
+        head.store((h + 1) % slots.size(), memory_order_release);
+        return true;
+    }
+
+    /* Helper of push and pop, block until done() succeeds. The waiter is
+      counted before done() looks at the indices, and wake() looks at the
+      count after moving one, so one of them sees the other */
+    template <typename Done>
+    void wait(Done done) {
+        unique_lock<mutex> guard(lock);
+        waiters.fetch_add(1);
+        atomic_thread_fence(memory_order_seq_cst);
+        moved.wait(guard, done);
+        waiters.fetch_sub(1);
+    }
+
+    /* Helper of the push and pop methods, wake the other side if it
+      waits */
+    void wake() {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (waiters.load(memory_order_relaxed) > 0) {
+            lock_guard<mutex> guard(lock);
+            moved.notify_all();
+        }
+    }
+};
+
+#endif  // SPSCQUEUE_HPP
@@ -0,0 +1,248 @@
+/**
+ * This file shows the implementation of UringReadBuf class methods.
+ * Declaration can be found in 'UringReadBuf.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "UringReadBuf.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <ios>
+
+const unsigned int UringReadBuf::BLOCK_SIZE = 1 << 20;
+const unsigned int UringReadBuf::QUEUE_DEPTH = 8;
+
+/* the alignment of the blocks, a page */
+static const unsigned int ALIGNMENT = 4096;
+
+/* Constructor of UringReadBuf, opens the file and starts reading */
+UringReadBuf::UringReadBuf(string fileName, bool direct)
+    : fd(-1), fileSize(0), buffers(QUEUE_DEPTH, (char*)0),
+      ready(QUEUE_DEPTH), results(QUEUE_DEPTH), base(0), consumed(0),
+      submitted(0), skip(0), holding(false), direct(direct),
+      dropCache(false) {
+    bool hasRing = IoUring::isAvailable() && ring.open(QUEUE_DEPTH);
+    if (!hasRing && !direct) {
+        return;
+    }
+    if (direct) {
+        fd = open(fileName.c_str(), O_RDONLY | O_DIRECT);
+        if (fd < 0 && errno == EINVAL) {
+            dropCache = true;
+        }
+    }
+    if (fd < 0) {
+        fd = open(fileName.c_str(), O_RDONLY);
+    }
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0) {
+        close();
+        return;
+    }
+    fileSize = status.st_size;
+    for (unsigned int i = 0; i < QUEUE_DEPTH; i++) {
+        void* block;
+        if (posix_memalign(&block, ALIGNMENT, BLOCK_SIZE) != 0) {
+            close();
+            return;
+        }
+        buffers[i] = (char*)block;
+    }
+    start(0);
+}
+
+/* Destructor, closes the buffer */
+UringReadBuf::~UringReadBuf() {
+    close();
+    for (unsigned int i = 0; i < QUEUE_DEPTH; i++) {
+        free(buffers[i]);
+    }
+}
+
+/* Check if the file and the ring are open, or the file alone in direct
+      mode */
+bool UringReadBuf::isOpen() {
+    return fd >= 0 && (ring.isOpen() || direct);
+}
+
+/* Wait for the reads in flight and close the file */
+void UringReadBuf::close() {
+    drain();
+    ring.close();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    holding = false;
+    setg(0, 0, 0);
+}
+
+/* Take the next block once the current one is consumed */
+UringReadBuf::int_type UringReadBuf::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    if (!isOpen()) {
+        return traits_type::eof();
+    }
+    // the slot of the block consumed is free for a read ahead
+    if (holding) {
+        if (dropCache) {
+            posix_fadvise(fd, base + consumed * BLOCK_SIZE, BLOCK_SIZE,
+                          POSIX_FADV_DONTNEED);
+        }
+        holding = false;
+        consumed++;
+        skip = 0;
+        setg(0, 0, 0);
+        refill();
+    }
+    unsigned long long offset = base + consumed * BLOCK_SIZE;
+    if (offset >= fileSize) {
+        return traits_type::eof();
+    }
+
+    unsigned int slot = consumed % QUEUE_DEPTH;
+    while (!ready[slot] && ring.getInFlight() > 0) {
+        reap();
+    }
+    if (!ready[slot]) {
+        return traits_type::eof();
+    }
+    unsigned long long left = fileSize - offset;
+    unsigned int expected = left < BLOCK_SIZE ? left : BLOCK_SIZE;
+    // a failed read is done again with pread, a short one is completed in
+    // place, from an aligned offset in direct mode
+    unsigned int count = results[slot] < 0 ? 0 : results[slot];
+    while (count < expected) {
+        unsigned int from = direct ? count - count % ALIGNMENT : count;
+        ssize_t more = pread(fd, buffers[slot] + from, BLOCK_SIZE - from,
+                             offset + from);
+        if (more < 0 && errno == EINTR) continue;
+        if (more <= 0 || from + more <= count) break;
+        count = from + more;
+    }
+    // the file is shorter than at open or cannot be read, the stream goes
+    // bad rather than ending early
+    if (count < expected) {
+        throw ios_base::failure("read failed");
+    }
+    if (count <= skip) {
+        return traits_type::eof();
+    }
+    holding = true;
+    setg(buffers[slot], buffers[slot] + skip, buffers[slot] + count);
+    return traits_type::to_int_type(*gptr());
+}
+
+/* Move to an offset of the file, or tell the current one, the mode does
+      not matter to a buffer that only reads */
+UringReadBuf::pos_type UringReadBuf::seekoff(off_type off,
+                                             ios_base::seekdir dir,
+                                             ios_base::openmode) {
+    unsigned long long here = base + consumed * BLOCK_SIZE + skip;
+    if (holding) {
+        here = base + consumed * BLOCK_SIZE + (gptr() - eback());
+    }
+    long long target = off;
+    if (dir == ios_base::cur) {
+        target = here + off;
+    } else if (dir == ios_base::end) {
+        target = fileSize + off;
+    }
+    if (target < 0 || !isOpen()) {
+        return pos_type(off_type(-1));
+    }
+    if (target != (long long)here && !seekAhead(target)) {
+        start(target);
+    }
+    return target;
+}
+
+/* Move to an offset of the file */
+UringReadBuf::pos_type UringReadBuf::seekpos(pos_type pos,
+                                             ios_base::openmode which) {
+    return seekoff(pos, ios_base::beg, which);
+}
+
+/* Move to an offset in the block being consumed or in one being read
+      ahead, keeping the reads in flight */
+bool UringReadBuf::seekAhead(unsigned long long target) {
+    if (target < base + consumed * BLOCK_SIZE ||
+        target >= base + submitted * BLOCK_SIZE) {
+        return false;
+    }
+    unsigned long long block = (target - base) / BLOCK_SIZE;
+    unsigned int inBlock = (target - base) % BLOCK_SIZE;
+    if (holding && block == consumed) {
+        if (inBlock > egptr() - eback()) {
+            return false;
+        }
+        setg(eback(), eback() + inBlock, egptr());
+        return true;
+    }
+    // the blocks passed over free their slots once their reads are done
+    while (consumed < block) {
+        unsigned int slot = consumed % QUEUE_DEPTH;
+        while (!ready[slot] && ring.getInFlight() > 0) {
+            reap();
+        }
+        consumed++;
+    }
+    skip = inBlock;
+    holding = false;
+    setg(0, 0, 0);
+    refill();
+    return true;
+}
+
+/* Restart reading at the given file offset */
+void UringReadBuf::start(unsigned long long offset) {
+    drain();
+    base = offset - offset % BLOCK_SIZE;
+    skip = offset % BLOCK_SIZE;
+    consumed = 0;
+    submitted = 0;
+    holding = false;
+    setg(0, 0, 0);
+    refill();
+}
+
+/* Submit reads until QUEUE_DEPTH are in flight or the file ends */
+void UringReadBuf::refill() {
+    while (submitted < consumed + QUEUE_DEPTH &&
+           base + submitted * BLOCK_SIZE < fileSize) {
+        unsigned int slot = submitted % QUEUE_DEPTH;
+        ready[slot] = false;
+        if (!ring.submitRead(fd, buffers[slot], BLOCK_SIZE,
+                             base + submitted * BLOCK_SIZE, submitted)) {
+            // the ring is unusable, the block is read in place instead
+            results[slot] = pread(fd, buffers[slot], BLOCK_SIZE,
+                                  base + submitted * BLOCK_SIZE);
+            ready[slot] = true;
+        }
+        submitted++;
+    }
+}
+
+/* Wait for every read in flight */
+void UringReadBuf::drain() {
+    while (ring.getInFlight() > 0) {
+        reap();
+    }
+}
+
+/* Wait for one read to complete and record its result */
+void UringReadBuf::reap() {
+    unsigned long long tag;
+    int result;
+    if (ring.wait(tag, result)) {
+        results[tag % QUEUE_DEPTH] = result;
+        ready[tag % QUEUE_DEPTH] = true;
+    }
+}
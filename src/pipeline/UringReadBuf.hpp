@@ -0,0 +1,95 @@
+/**
+ * This file declares the UringReadBuf class, a stream buffer that keeps
+ * several reads of a file in flight through io_uring
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef URINGREADBUF_HPP
+#define URINGREADBUF_HPP
+
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "IoUring.hpp"
+
+using namespace std;
+
+/** The reader stage of a pipeline on io_uring: the file is read in large
+ * aligned blocks, QUEUE_DEPTH of them in flight, so the device works on
+ * the next blocks while the istream on top of this one decodes the
+ * current one. Block i of the file always goes to slot i % QUEUE_DEPTH.
+ * Seeking forward within the blocks read ahead keeps them.
+ * In direct mode the file bypasses the page cache with O_DIRECT, which the
+ * aligned blocks and offsets allow, reading synchronously if there is no
+ * ring; where the file system refuses O_DIRECT, every block is dropped
+ * from the cache once consumed instead. Check isOpen after construction
+ * and use AsyncReadBuf if it is false */
+class UringReadBuf : public streambuf {
+  private:
+    IoUring ring;                    // the ring of the reads
+    int fd;                          // the file, -1 if it is not open
+    unsigned long long fileSize;     // bytes in the file
+    vector<char*> buffers;           // one aligned block per slot
+    vector<bool> ready;              // whether the read of a slot is done
+    vector<int> results;             // bytes read into a slot, or -errno
+    unsigned long long base;         // file offset of block 0, aligned
+    unsigned long long consumed;     // the block being or to be consumed
+    unsigned long long submitted;    // blocks submitted since the seek
+    unsigned int skip;               // bytes to skip in block 0
+    bool holding;                    // whether the get area is a block
+    bool direct;                     // whether the page cache is avoided
+    bool dropCache;                  // direct without O_DIRECT
+
+  public:
+    static const unsigned int BLOCK_SIZE;   // bytes per read, aligned
+    static const unsigned int QUEUE_DEPTH;  // reads in flight at most
+
+    /* Constructor of UringReadBuf, opens the file and starts reading
+      params:
+        fileName: the name of the file
+        direct: whether to keep the file out of the page cache */
+    explicit UringReadBuf(string fileName, bool direct = false);
+
+    /* Destructor, closes the buffer */
+    ~UringReadBuf();
+
+    /* Check if the file and the ring are open, or the file alone in
+      direct mode */
+    bool isOpen();
+
+    /* Wait for the reads in flight and close the file */
+    void close();
+
+  protected:
+    /* Take the next block once the current one is consumed */
+    int_type underflow() override;
+
+    /* Move to an offset of the file, or tell the current one */
+    pos_type seekoff(off_type off, ios_base::seekdir dir,
+                     ios_base::openmode which) override;
+
+    /* Move to an offset of the file */
+    pos_type seekpos(pos_type pos, ios_base::openmode which) override;
+
+  private:
+    /* Move to an offset in the block being consumed or in one being read
+      ahead, keeping the reads in flight
+      param: the file offset
+      return: false if the offset is in neither */
+    bool seekAhead(unsigned long long target);
+
+    /* Restart reading at the given file offset */
+    void start(unsigned long long offset);
+
+    /* Submit reads until QUEUE_DEPTH are in flight or the file ends */
+    void refill();
+
+    /* Wait for every read in flight */
+    void drain();
+
+    /* Wait for one read to complete and record its result */
+    void reap();
+};
+
+#endif  // URINGREADBUF_HPP
@@ -0,0 +1,185 @@
+/**
+ * This file shows the implementation of UringWriteBuf class methods.
+ * Declaration can be found in 'UringWriteBuf.hpp'
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include "UringWriteBuf.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int UringWriteBuf::BLOCK_SIZE = 1 << 20;
+const unsigned int UringWriteBuf::QUEUE_DEPTH = 8;
+
+/* the alignment of the blocks, a page */
+static const unsigned int ALIGNMENT = 4096;
+
+/* Constructor of UringWriteBuf, creates or truncates the file */
+UringWriteBuf::UringWriteBuf(string fileName, bool direct)
+    : fd(-1), buffers(QUEUE_DEPTH, (char*)0), busy(QUEUE_DEPTH),
+      lengths(QUEUE_DEPTH), offsets(QUEUE_DEPTH), current(0), fileOffset(0),
+      failed(false), direct(direct), dropCache(false) {
+    bool hasRing = IoUring::isAvailable() && ring.open(QUEUE_DEPTH);
+    if (!hasRing && !direct) {
+        return;
+    }
+    for (unsigned int i = 0; i < QUEUE_DEPTH; i++) {
+        void* block;
+        if (posix_memalign(&block, ALIGNMENT, BLOCK_SIZE) != 0) {
+            ring.close();
+            return;
+        }
+        buffers[i] = (char*)block;
+    }
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    if (direct) {
+        fd = open(fileName.c_str(), flags | O_DIRECT, 0644);
+        if (fd < 0 && errno == EINVAL) {
+            dropCache = true;
+        }
+    }
+    if (fd < 0) {
+        fd = open(fileName.c_str(), flags, 0644);
+    }
+    if (fd < 0) {
+        ring.close();
+        return;
+    }
+    setp(buffers[current], buffers[current] + BLOCK_SIZE);
+}
+
+/* Destructor, closes the buffer if it is not yet */
+UringWriteBuf::~UringWriteBuf() {
+    close();
+    for (unsigned int i = 0; i < QUEUE_DEPTH; i++) {
+        free(buffers[i]);
+    }
+}
+
+/* Check if the file and the ring are open, or the file alone in direct
+      mode */
+bool UringWriteBuf::isOpen() {
+    return fd >= 0 && (ring.isOpen() || direct);
+}
+
+/* Check if a write failed, the file is incomplete then */
+bool UringWriteBuf::isFailed() { return failed; }
+
+/* Write the last block, wait for every write and close the file */
+void UringWriteBuf::close() {
+    if (!isOpen()) {
+        return;
+    }
+    // the last block of a direct file is padded, the padding cut off
+    unsigned long long size = fileOffset + (pptr() - pbase());
+    if (direct && !dropCache && (pptr() - pbase()) % ALIGNMENT != 0) {
+        unsigned int padding = ALIGNMENT - (pptr() - pbase()) % ALIGNMENT;
+        memset(pptr(), 0, padding);
+        pbump(padding);
+    }
+    handOver();
+    while (ring.getInFlight() > 0) {
+        reap();
+    }
+    if (fileOffset != size && ftruncate(fd, size) != 0) {
+        failed = true;
+    }
+    if (::close(fd) != 0) {
+        failed = true;
+    }
+    fd = -1;
+    ring.close();
+    setp(0, 0);
+}
+
+/* Hand over the full block and start a new one */
+UringWriteBuf::int_type UringWriteBuf::overflow(int_type c) {
+    if (!isOpen() || failed) {
+        return traits_type::eof();
+    }
+    handOver();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/* Hand over the current block, even if it is not full, but for a direct
+      file, whose blocks have to stay aligned */
+int UringWriteBuf::sync() {
+    if (isOpen() && !direct) {
+        handOver();
+    }
+    return failed ? -1 : 0;
+}
+
+/* Submit the current block if it holds anything and move to a free slot */
+void UringWriteBuf::handOver() {
+    if (pptr() == pbase()) {
+        return;
+    }
+    lengths[current] = pptr() - pbase();
+    offsets[current] = fileOffset;
+    fileOffset += lengths[current];
+    busy[current] = true;
+    if (!ring.submitWrite(fd, buffers[current], lengths[current],
+                          offsets[current], current)) {
+        // the ring is unusable, the block is written in place instead
+        if (pwrite(fd, buffers[current], lengths[current],
+                   offsets[current]) != (int)lengths[current]) {
+            failed = true;
+        }
+        if (dropCache) {
+            dropWritten(current);
+        }
+        busy[current] = false;
+    }
+    current = (current + 1) % QUEUE_DEPTH;
+    while (busy[current]) {
+        reap();
+    }
+    setp(buffers[current], buffers[current] + BLOCK_SIZE);
+}
+
+/* Wait for one write to complete and free its slot */
+void UringWriteBuf::reap() {
+    unsigned long long tag;
+    int result;
+    if (!ring.wait(tag, result)) {
+        return;
+    }
+    unsigned int slot = tag;
+    if (result < 0) {
+        failed = true;
+    }
+    // a short write, the rest is written in place
+    unsigned int done = result < 0 ? lengths[slot] : result;
+    while (done < lengths[slot]) {
+        int more = pwrite(fd, buffers[slot] + done, lengths[slot] - done,
+                          offsets[slot] + done);
+        if (more <= 0) {
+            failed = true;
+            break;
+        }
+        done += more;
+    }
+    if (dropCache) {
+        dropWritten(slot);
+    }
+    busy[slot] = false;
+}
+
+/* Write the bytes of a slot back to the disk and drop them from the page
+      cache */
+void UringWriteBuf::dropWritten(unsigned int slot) {
+    sync_file_range(fd, offsets[slot], lengths[slot],
+                    SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                        SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise(fd, offsets[slot], lengths[slot], POSIX_FADV_DONTNEED);
+}
@@ -0,0 +1,84 @@
+/**
+ * This file declares the UringWriteBuf class, a stream buffer that keeps
+ * several writes of a file in flight through io_uring
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef URINGWRITEBUF_HPP
+#define URINGWRITEBUF_HPP
+
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "IoUring.hpp"
+
+using namespace std;
+
+/** The writer stage of a pipeline on io_uring: the ostream on top of this
+ * one fills large aligned blocks, each written at its own offset while
+ * the next ones are filled, QUEUE_DEPTH of them in flight at most. In
+ * direct mode the file bypasses the page cache with O_DIRECT: only full
+ * blocks are written until close, which pads the last one to the
+ * alignment and truncates the file back, and writes are synchronous if
+ * there is no ring. Where the file system refuses O_DIRECT, every block
+ * written is flushed and dropped from the cache instead. Check isOpen
+ * after construction and use AsyncWriteBuf if it is false */
+class UringWriteBuf : public streambuf {
+  private:
+    IoUring ring;                         // the ring of the writes
+    int fd;                               // the file, -1 if not open
+    vector<char*> buffers;                // one aligned block per slot
+    vector<bool> busy;                    // whether a slot is in flight
+    vector<unsigned int> lengths;         // bytes written from a slot
+    vector<unsigned long long> offsets;   // file offset of a slot
+    unsigned int current;                 // the slot being filled
+    unsigned long long fileOffset;        // file offset of the next block
+    bool failed;                          // whether a write failed
+    bool direct;                          // whether the cache is avoided
+    bool dropCache;                       // direct without O_DIRECT
+
+  public:
+    static const unsigned int BLOCK_SIZE;   // bytes per write, aligned
+    static const unsigned int QUEUE_DEPTH;  // writes in flight at most
+
+    /* Constructor of UringWriteBuf, creates or truncates the file
+      params:
+        fileName: the name of the file
+        direct: whether to keep the file out of the page cache */
+    explicit UringWriteBuf(string fileName, bool direct = false);
+
+    /* Destructor, closes the buffer if it is not yet */
+    ~UringWriteBuf();
+
+    /* Check if the file and the ring are open, or the file alone in
+      direct mode */
+    bool isOpen();
+
+    /* Check if a write failed, the file is incomplete then */
+    bool isFailed();
+
+    /* Write the last block, wait for every write and close the file */
+    void close();
+
+  protected:
+    /* Hand over the full block and start a new one */
+    int_type overflow(int_type c) override;
+
+    /* Hand over the current block, even if it is not full */
+    int sync() override;
+
+  private:
+    /* Submit the current block if it holds anything and move to a free
+      slot */
+    void handOver();
+
+    /* Wait for one write to complete and free its slot */
+    void reap();
+
+    /* Write the bytes of a slot back to the disk and drop them from the
+      page cache, direct mode without O_DIRECT */
+    void dropWritten(unsigned int slot);
+};
+
+#endif  // URINGWRITEBUF_HPP
@@ -5,14 +5,32 @@
  * Author: Yuening YANG
  * Email: y3yang@ucsd.edu
  */
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 #include "FileUtils.hpp"
+#include "ArchiveReader.hpp"
+#include "ContextHCTree.hpp"
+#include "Crc32c.hpp"
+#include "FrameReader.hpp"
+#include "GlobalTree.hpp"
 #include "HCNode.hpp"
 #include "HCNode2.hpp"
 #include "HCTree.hpp"
 #include "HCTree2.hpp"
+#include "HCTreeN.hpp"
+#include "InputFile.hpp"
+#include "LZCodec.hpp"
+#include "OutputFile.hpp"
+#include "SpeculativeDecoder.hpp"
+#include "TunstallCode.hpp"
 #include "cxxopts.hpp"
 
 /* Pseudo decompression with ascii encoding and naive header (checkpoint)
@@ -59,6 +77,10 @@ void pseudoDecompression(string inFileName, string outFileName) {
     delete hctree;
 }
 
+/* the number of bytes trueDecompression and blockDecompression decode at
+ * once */
+static const unsigned int DECODING_BLOCK_SIZE = 1 << 16;
+
 /* decompression of encoding two symbols, also with bitwise i/o and small header
  * (final) */
 void blockDecompression(string inFileName, string outFileName) {
@@ -94,32 +116,186 @@ void blockDecompression(string inFileName, string outFileName) {
     unsigned short count = (before << 8) + after + 1;
     HCTree2* hctree = new HCTree2();
     hctree->reconstructTree(bitIn, count);
+    hctree->buildDecodeTable();
 
-    // decode
-    byte2 symbol = 0;
-    unsigned char first, second;
-    for (int i = 0; i < total / 2; i++) {
-        symbol = hctree->decode(bitIn);
-        first = ((symbol >> 8) & 255);
-        second = (symbol & 255);
-        outFile << first << second;
+    // decode a block of pairs at a time, an odd total ends with the first
+    // byte of a pair
+    unsigned int length = total;
+    unsigned int pairs = (length + 1) / 2;
+    vector<byte2> symbols(DECODING_BLOCK_SIZE / 2);
+    vector<byte> block(DECODING_BLOCK_SIZE);
+    for (unsigned int i = 0; i < pairs; i += symbols.size()) {
+        unsigned int n = min((unsigned int)symbols.size(), pairs - i);
+        hctree->decode(bitIn, symbols.data(), n);
+        for (unsigned int j = 0; j < n; j++) {
+            block[2 * j] = (symbols[j] >> 8) & 255;
+            block[2 * j + 1] = symbols[j] & 255;
+        }
+        outFile.write((const char*)block.data(), min(2 * n, length - 2 * i));
+    }
+    // close files
+    inFile.close();
+    outFile.close();
+
+    // release memory
+    delete hctree;
+}
+
+/* Close an output file written behind the coder
+ *      params: the file and its name
+ *      return: false if a write failed, reported, the output is incomplete
+ */
+bool closeOutput(OutputFile& outFile, string outFileName) {
+    if (outFile.close()) {
+        return true;
+    }
+    cerr << outFileName << ": write failed, output is incomplete" << endl;
+    return false;
+}
+
+/* True decompression with bitwise i/o and small header (final)
+ *      params: names of the input file and the output file
+ *      return: false if the output cannot be written */
+bool trueDecompression(string inFileName, string outFileName) {
+    // open the input file, read ahead of the coder
+    InputFile inFile(inFileName);
+    istream& in = inFile.getStream();
+    BitInputStream bitIn(in);
+
+    // open the output file, written behind the coder
+    OutputFile outFile(outFileName);
+    ostream& out = outFile.getStream();
+
+    // read the header and reconstruct HCTree
+    // get total number, 32 bits
+    int total = 0, bit;
+    for (int i = 0; i < 4; i++) {
+        // bit = bitIn.readBit();
+        bit = in.get();
+        total = (total << 8) + bit;
+    }
+
+    // check empty file
+    if (total == 0) {
+        inFile.close();
+        return closeOutput(outFile, outFileName);
     }
 
-    if (total % 2 != 0) {
-        symbol = hctree->decode(bitIn);
-        first = ((symbol >> 8) & 255);
-        outFile << first;
+    // get distinct number
+    int count = in.get() + 1;
+    HCTree* hctree = new HCTree();
+    hctree->reconstructTree(bitIn, count);
+    hctree->buildDecodeTable();
+
+    // decode a block at a time
+    vector<byte> block(DECODING_BLOCK_SIZE);
+    for (unsigned int i = 0; i < (unsigned int)total;
+         i += DECODING_BLOCK_SIZE) {
+        unsigned int n = min(DECODING_BLOCK_SIZE, (unsigned int)total - i);
+        hctree->decode(bitIn, block.data(), n);
+        out.write((const char*)block.data(), n);
     }
     // close files
     inFile.close();
-    outFile.close();
+    bool written = closeOutput(outFile, outFileName);
 
     // release memory
     delete hctree;
+    return written;
 }
 
-/* True decompression with bitwise i/o and small header (final) */
-void trueDecompression(string inFileName, string outFileName) {
+/* the coded bytes per piece of a window of speculativeDecompression */
+static const unsigned int WINDOW_PIECE_BYTES = 1 << 21;
+
+/* Speculative decompression of the trueDecompression format on several
+ * threads. The file is read a window at a time, the stream of a window cut
+ * into pieces decoded at once by SpeculativeDecoder, and its symbols
+ * written while the next window is read
+ *      params: names of the input file and the output file, and the number
+ *              of pieces to decode apart
+ *      return: false if the output cannot be written */
+bool speculativeDecompression(string inFileName, string outFileName,
+                              unsigned int pieces) {
+    // open the input file, read ahead of the coder; a window holds 16
+    // bytes past its end, for the codes crossing it and the 8 bytes the
+    // decoder loads past them, then 8 bytes of zeros at the end of the file
+    InputFile inFile(inFileName);
+    istream& in = inFile.getStream();
+    size_t windowBytes = (size_t)pieces * WINDOW_PIECE_BYTES;
+    size_t capacity = windowBytes + 16;
+    vector<byte> window(capacity + 8, 0);
+    in.read((char*)window.data(), capacity);
+    size_t size = in.gcount();
+    bool eof = size < capacity;
+
+    // read the header and reconstruct HCTree, at most 9 bits per leaf and
+    // one per inner node
+    unsigned int total = 0;
+    for (int i = 0; i < 4; i++) {
+        total = (total << 8) + window[i];
+    }
+    int count = window[4] + 1;
+    istringstream header(string((const char*)window.data() + 5,
+                                size < 5 ? 0 : min(size - 5, (size_t)320)));
+    BitInputStream bitIn(header);
+    HCTree* hctree = new HCTree();
+    hctree->reconstructTree(bitIn, count);
+    hctree->buildDecodeTable();
+    const BitKernels::DecodeTable& table = hctree->getDecodeTable();
+    if (total == 0 || table.entries.empty() ||
+        table.maxLength > BitKernels::MAX_CODE_LENGTH) {
+        inFile.close();
+        delete hctree;
+        return trueDecompression(inFileName, outFileName);
+    }
+
+    // open the output file, written behind the coder
+    OutputFile outFile(outFileName);
+    ostream& out = outFile.getStream();
+
+    // decode a window, write it, then move the bytes of the codes not yet
+    // decoded to the front and read the next window after them
+    unsigned long long pos = 5 * 8 + hctree->getTreeBits();
+    size_t left = total;
+    vector<byte> symbols;
+    while (left > 0) {
+        size_t inBytes = eof ? size : size - 8;
+        unsigned long long endPos = eof ? size * 8ULL : windowBytes * 8ULL;
+        unsigned int windowPieces = SpeculativeDecoder::getPieceCount(
+            (endPos - min(pos, endPos)) / 8, pieces);
+        SpeculativeDecoder::decodeWindow(window.data(), inBytes, pos, endPos,
+                                         table, symbols, left,
+                                         windowPieces);
+        out.write((const char*)symbols.data(), symbols.size());
+        left -= symbols.size();
+        if (eof || symbols.empty()) break;
+        size_t used = pos / 8;
+        window.erase(window.begin(), window.begin() + used);
+        window.resize(capacity + 8, 0);
+        pos -= used * 8;
+        size -= used;
+        in.read((char*)window.data() + size, capacity - size);
+        size += in.gcount();
+        eof = size < capacity;
+    }
+    // a truncated stream, the symbols it lacks are 0
+    vector<byte> zeros(DECODING_BLOCK_SIZE, 0);
+    while (left > 0) {
+        size_t n = min(left, (size_t)DECODING_BLOCK_SIZE);
+        out.write((const char*)zeros.data(), n);
+        left -= n;
+    }
+    // close files
+    inFile.close();
+    bool written = closeOutput(outFile, outFileName);
+
+    // release memory
+    delete hctree;
+    return written;
+}
+
+/* Order-1 context decompression with bitwise i/o and small header (final) */
+void contextDecompression(string inFileName, string outFileName) {
     // open the input file
     ifstream inFile;
     inFile.open(inFileName);
@@ -129,11 +305,10 @@ void trueDecompression(string inFileName, string outFileName) {
     ofstream outFile;
     outFile.open(outFileName);
 
-    // read the header and reconstruct HCTree
+    // read the header and reconstruct the context model
     // get total number, 32 bits
     int total = 0, bit;
     for (int i = 0; i < 4; i++) {
-        // bit = bitIn.readBit();
         bit = inFile.get();
         total = (total << 8) + bit;
     }
@@ -145,40 +320,439 @@ void trueDecompression(string inFileName, string outFileName) {
         return;
     }
 
-    // get distinct number
-    int count = inFile.get() + 1;
-    HCTree* hctree = new HCTree();
-    hctree->reconstructTree(bitIn, count);
+    ContextHCTree* model = new ContextHCTree();
+    model->reconstructTree(bitIn);
 
-    // decode
-    byte symbol = 0;
-    int counts = 0;
+    // decode, the previous byte selects the tree
+    byte symbol = 0, prev = 0;
     for (int i = 0; i < total; i++) {
-        symbol = hctree->decode(bitIn);
+        symbol = model->decode(prev, bitIn);
         outFile << symbol;
+        prev = symbol;
     }
     // close files
     inFile.close();
     outFile.close();
 
     // release memory
-    delete hctree;
+    delete model;
+}
+
+/* LZ77 decompression with bitwise i/o and small header (final)
+ *      params: names of the input file and the output file
+ *      return: false if the input is truncated or corrupt */
+bool lzDecompression(string inFileName, string outFileName) {
+    // open the input file
+    ifstream inFile;
+    inFile.open(inFileName);
+    BitInputStream bitIn(inFile);
+
+    // open the output file
+    ofstream outFile;
+    outFile.open(outFileName);
+
+    // read the header
+    // get total number, 32 bits
+    unsigned int total = 0, bit;
+    for (int i = 0; i < 4; i++) {
+        bit = inFile.get();
+        total = (total << 8) + bit;
+    }
+
+    // decode, back-references need the output at hand
+    vector<byte> data;
+    bool valid = LZCodec::decode(bitIn, total, data);
+    outFile.write((const char*)data.data(), data.size());
+    // close files
+    inFile.close();
+    outFile.close();
+    if (!valid) {
+        cerr << inFileName << ": truncated or corrupt" << endl;
+    }
+    return valid;
+}
+
+/* Wide symbol decompression, the width read from the header (final)
+ *      params: names of the input file and the output file, and the width
+ *              compress was given
+ *      return: false if the file was coded with another width */
+bool wideDecompression(string inFileName, string outFileName, int width) {
+    // open the input file
+    ifstream inFile;
+    inFile.open(inFileName);
+    BitInputStream bitIn(inFile);
+
+    // read the header
+    // get total number, 32 bits
+    unsigned int total = 0, bit;
+    for (int i = 0; i < 4; i++) {
+        bit = inFile.get();
+        total = (total << 8) + bit;
+    }
+    if (inFile.get() != width) {
+        cerr << inFileName << ": not coded with --width " << width << endl;
+        inFile.close();
+        return false;
+    }
+    HCTreeN hctree(width);
+    hctree.reconstructTree(bitIn);
+
+    // decode, then write at once
+    vector<byte> data(total);
+    hctree.decode(bitIn, data.data(), data.size());
+    inFile.close();
+    ofstream outFile;
+    outFile.open(outFileName);
+    outFile.write((const char*)data.data(), data.size());
+    outFile.close();
+    return true;
+}
+
+/* Tunstall decompression: a copy of a phrase per 16 bit codeword
+ *      params: names of the input file and the output file
+ *      return: false if the input ends before its bytes do */
+bool tunstallDecompression(string inFileName, string outFileName) {
+    // open the input file
+    ifstream inFile;
+    inFile.open(inFileName);
+
+    // read the header
+    // get total number, 32 bits
+    unsigned int total = 0, bit;
+    for (int i = 0; i < 4; i++) {
+        bit = inFile.get();
+        total = (total << 8) + bit;
+    }
+    TunstallCode code;
+    vector<byte> codes, data(total);
+    size_t done = 0;
+    if (code.readDictionary(inFile)) {
+        // the codewords, all at once
+        codes.assign(istreambuf_iterator<char>(inFile),
+                     istreambuf_iterator<char>());
+        done = code.decode(codes.data(), codes.size() / 2, data.data(),
+                           total);
+    }
+    inFile.close();
+    if (done < total) {
+        cerr << inFileName << ": truncated or corrupt" << endl;
+        return false;
+    }
+
+    // open the output file
+    ofstream outFile;
+    outFile.open(outFileName);
+    outFile.write((const char*)data.data(), data.size());
+    outFile.close();
+    return true;
+}
+
+/* Give the reader the tree of a data set if its frame was coded with one
+ *      params: the reader, the name of its file, and the tree of the
+ *              --tree histogram, 0 without one
+ *      return: false if the frame needs another tree than the one given */
+bool setGlobalTree(FrameReader& reader, string inFileName,
+                   const GlobalTree* globalTree) {
+    if (!reader.hasTreeId()) {
+        return true;
+    }
+    if (globalTree == 0 || globalTree->getId() != reader.getTreeId()) {
+        cerr << inFileName << ": needs the tree " << hex
+             << reader.getTreeId() << dec
+             << " of a merged histogram, see --tree" << endl;
+        return false;
+    }
+    reader.setSharedTree(&globalTree->getTree());
+    return true;
+}
+
+/* Framed decompression, chunk by chunk, every chunk verified (final)
+ *      params: names of the input file and the output file, whether to
+ *              keep both out of the page cache, and the tree of the data
+ *              set of the file, if any
+ *      return: whether the frame is intact and the output written */
+bool framedDecompression(string inFileName, string outFileName,
+                         bool direct = false,
+                         const GlobalTree* globalTree = 0) {
+    // open the input file, read ahead of the coder
+    InputFile inFile(inFileName, true, direct);
+    istream& in = inFile.getStream();
+    FrameReader reader(in);
+    if (!setGlobalTree(reader, inFileName, globalTree)) {
+        inFile.close();
+        return false;
+    }
+
+    // open the output file, written behind the coder
+    OutputFile outFile(outFileName, true, direct);
+    ostream& out = outFile.getStream();
+
+    // into a pipe, stored chunks are verified in place and spliced from
+    // the input file, never copied through this process
+    int inFd = outFile.isPipe() ? open(inFileName.c_str(), O_RDONLY) : -1;
+    bool spliced = true;
+
+    // decode every chunk, while the next one is read and the last written
+    vector<byte> chunk;
+    while (spliced) {
+        unsigned int length, checksum, crc = 0;
+        streamoff offset;
+        if (inFd >= 0 && reader.skipStoredChunk(length, checksum, offset)) {
+            spliced = Crc32c::computeFile(inFd, offset, length, crc) &&
+                      (!reader.hasChecksums() || crc == checksum) &&
+                      outFile.spliceFrom(inFd, offset, length);
+            continue;
+        }
+        if (!reader.readChunk(chunk)) break;
+        out.write((const char*)chunk.data(), chunk.size());
+    }
+    // close files
+    if (inFd >= 0) {
+        close(inFd);
+    }
+    inFile.close();
+    if (!closeOutput(outFile, outFileName)) {
+        return false;
+    }
+    if (reader.isCorrupt() || !spliced) {
+        cerr << inFileName << ": corrupt, output is incomplete" << endl;
+        return false;
+    }
+    return true;
+}
+
+/* Range decompression: only the chunks covering the range are read, found
+ * with the chunk index of the frame
+ *      params: names of the input file and the output file, the original
+ *              offset and the number of bytes to write, fewer past the
+ *              end, and the tree of the data set of the file, if any
+ *      return: whether the range was decoded and written */
+bool rangeDecompression(string inFileName, string outFileName,
+                        unsigned long long offset, unsigned long long length,
+                        const GlobalTree* globalTree = 0) {
+    ifstream inFile;
+    inFile.open(inFileName, ios::binary);
+    FrameReader reader(inFile);
+    if (!setGlobalTree(reader, inFileName, globalTree)) {
+        return false;
+    }
+    if (!reader.readIndex()) {
+        cerr << inFileName << ": no chunk index, cannot seek" << endl;
+        return false;
+    }
+
+    // the standard output too, as framedDecompression writes it
+    OutputFile outFile(outFileName);
+    ostream& out = outFile.getStream();
+    unsigned long long end = reader.getTotal();
+    if (length < end - min(offset, end)) {
+        end = offset + length;
+    }
+    unsigned long long chunkStart = 0;
+    if (offset < end && reader.seekChunk(offset, chunkStart)) {
+        vector<byte> chunk;
+        while (chunkStart < end && reader.readChunk(chunk)) {
+            // the part of the chunk inside the range
+            unsigned long long from = max(offset, chunkStart);
+            unsigned long long to = min(end, chunkStart + chunk.size());
+            out.write((const char*)chunk.data() + (from - chunkStart),
+                      to - from);
+            chunkStart += chunk.size();
+        }
+    }
+    inFile.close();
+    if (!closeOutput(outFile, outFileName)) {
+        return false;
+    }
+    if (reader.isCorrupt()) {
+        cerr << inFileName << ": corrupt, output is incomplete" << endl;
+        return false;
+    }
+    return true;
+}
+
+/* Archive extraction: one file of the archive to the output file, or with
+ * no member name every file under the output directory. Names are kept
+ * below the directory: leading slashes are dropped, ".." is refused
+ *      params: names of the archive and of the output, the name of the
+ *              member to extract, empty for all, whether to only list the
+ *              files, and whether to only verify them
+ *      return: whether every file was extracted intact */
+bool archiveDecompression(string inFileName, string outFileName,
+                          string memberName, bool isListMode,
+                          bool isTestMode) {
+    ifstream inFile;
+    inFile.open(inFileName, ios::binary);
+    ArchiveReader reader(inFile);
+    if (!reader.isValid()) {
+        cerr << inFileName << ": damaged archive, no file table" << endl;
+        return false;
+    }
+
+    bool ok = true;
+    vector<byte> data;
+    // the member as typed or as stored, without its leading '/'
+    int member = memberName.empty() ? -1 : reader.findFile(memberName);
+    for (unsigned int i = 0; i < reader.getFileCount(); i++) {
+        string name = reader.getName(i);
+        if (isListMode) {
+            cout << reader.getSize(i) << "\t" << name << endl;
+            continue;
+        }
+        if (!memberName.empty() && (int)i != member) {
+            continue;
+        }
+        string path = outFileName;
+        if (isTestMode) {
+            if (!reader.readFile(i, data)) {
+                cout << name << ": corrupt" << endl;
+                ok = false;
+            }
+            continue;
+        }
+        if (memberName.empty()) {
+            size_t first = name.find_first_not_of('/');
+            name = first == string::npos ? "" : name.substr(first);
+            if (name.empty() ||
+                ("/" + name + "/").find("/../") != string::npos) {
+                cerr << reader.getName(i) << ": unsafe name, skipped" << endl;
+                ok = false;
+                continue;
+            }
+            path = outFileName + "/" + name;
+            FileUtils::makeParentDirs(path);
+        }
+        if (!reader.readFile(i, data)) {
+            cerr << reader.getName(i) << ": corrupt, skipped" << endl;
+            ok = false;
+            continue;
+        }
+        ofstream outFile;
+        outFile.open(path, ios::binary);
+        outFile.write((const char*)data.data(), data.size());
+        outFile.close();
+        if (!outFile) {
+            cerr << path << ": write failed, output is incomplete" << endl;
+            ok = false;
+        }
+        if (!memberName.empty()) {
+            break;
+        }
+    }
+    inFile.close();
+    if (isTestMode && ok) {
+        cout << inFileName << ": OK, " << reader.getFileCount() << " files"
+             << endl;
+    }
+    if (!memberName.empty() && member < 0) {
+        cerr << memberName << ": not in the archive" << endl;
+        return false;
+    }
+    return ok;
+}
+
+/* Verification of a frame: every chunk is decoded into a scratch buffer
+ * and checked against its checksum, nothing is written
+ *      params: name of the input file, and the tree of its data set, if any
+ *      return: whether the frame is intact */
+bool testFrame(string inFileName, const GlobalTree* globalTree = 0) {
+    ifstream inFile;
+    inFile.open(inFileName, ios::binary);
+    FrameReader reader(inFile);
+    if (!setGlobalTree(reader, inFileName, globalTree)) {
+        return false;
+    }
+
+    vector<byte> chunk;
+    unsigned long long chunks = 0;
+    while (reader.readChunk(chunk)) {
+        chunks++;
+    }
+    inFile.close();
+    if (reader.isCorrupt()) {
+        cout << inFileName << ": corrupt at chunk " << chunks << endl;
+        return false;
+    }
+    cout << inFileName << ": OK, " << chunks << " chunks, "
+         << reader.getTotal() << " bytes"
+         << (reader.hasChecksums() ? "" : ", no checksums") << endl;
+    return true;
+}
+
+/* Parse a decimal number of an option, digits only
+ *      params: the text of the number, the value it sets
+ *      return: false if the text is not a plain decimal number that fits */
+bool parseNumber(const string& text, unsigned long long& value) {
+    if (text.empty() || text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+    char* end;
+    errno = 0;
+    value = strtoull(text.c_str(), &end, 10);
+    return errno == 0 && *end == '\0';
 }
 
 /* Main program that runs the uncompress */
 int main(int argc, char* argv[]) {
     cxxopts::Options options("./compress",
                              "Compresses files using Huffman Encoding");
-    options.positional_help("./path_to_input_file ./path_to_output_file");
+    options.positional_help(
+        "./path_to_input_file ./path_to_output_file, - for the standard "
+        "output");
 
     bool isAsciiOutput = false;
     bool isBlockEncoding = false;
+    bool isContextEncoding = false;
+    bool isLZEncoding = false;
+    bool isTunstallEncoding = false;
+    int width = 0;
+    bool isTestMode = false;
+    string range;
+    string memberName;
+    bool isListMode = false;
+    bool isDirect = false;
+    string treeName;
+    unsigned int threads = 0;
     string inFileName, outFileName;
     options.allow_unrecognised_options().add_options()(
         "ascii", "Write output in ascii mode instead of bit strem",
         cxxopts::value<bool>(isAsciiOutput))(
         "block", "Encoding two byte symbols instead of one byte symbols",
         cxxopts::value<bool>(isBlockEncoding))(
+        "context", "Encoding each byte with a tree chosen by the previous byte",
+        cxxopts::value<bool>(isContextEncoding))(
+        "lz", "Finding repeated strings before the Huffman encoding",
+        cxxopts::value<bool>(isLZEncoding))(
+        "tunstall", "Encoding phrases of bytes as fixed 16 bit codewords",
+        cxxopts::value<bool>(isTunstallEncoding))(
+        "width", "Encoding symbols of this many bytes, 1 to 4",
+        cxxopts::value<int>(width))(
+        "test",
+        "Verifying the checksums of a framed file without writing the "
+        "output, no output file is needed",
+        cxxopts::value<bool>(isTestMode))(
+        "range",
+        "Writing only the bytes offset:length of a framed file, decoding "
+        "just the chunks that hold them",
+        cxxopts::value<string>(range))(
+        "member",
+        "Extracting only the file of this name from an archive to the output "
+        "file, an archive is otherwise extracted under the output directory",
+        cxxopts::value<string>(memberName))(
+        "list", "Printing the size and name of every file of an archive",
+        cxxopts::value<bool>(isListMode))(
+        "direct",
+        "Reading and writing a framed file with O_DIRECT, keeping both out "
+        "of the page cache",
+        cxxopts::value<bool>(isDirect))(
+        "tree",
+        "Decoding a framed file compressed with --tree, with the same merged "
+        "histogram",
+        cxxopts::value<string>(treeName))(
+        "threads",
+        "Number of threads decoding a file of the default format, one per "
+        "core by default",
+        cxxopts::value<unsigned int>(threads))(
         "input", "", cxxopts::value<string>(inFileName))(
         "output", "", cxxopts::value<string>(outFileName))(
         "h, help", "Print help and exit");
@@ -187,23 +761,117 @@ int main(int argc, char* argv[]) {
     auto userOptions = options.parse(argc, argv);
 
     if (userOptions.count("help") || !FileUtils::isValidFile(inFileName) ||
-        outFileName.empty()) {
+        (outFileName.empty() && !isTestMode && !isListMode)) {
         cout << options.help({""}) << std::endl;
         exit(0);
     }
 
-    if (!FileUtils::isEmptyFile(argv[1])) {
-        if (isAsciiOutput) {
+    if (ArchiveFormat::isArchive(inFileName)) {
+        return archiveDecompression(inFileName, outFileName, memberName,
+                                    isListMode, isTestMode)
+                   ? 0
+                   : 1;
+    }
+
+    // the tree of the data set of a frame, the frame checks its ID
+    GlobalTree* globalTree = 0;
+    if (!treeName.empty()) {
+        vector<unsigned long long> freqs(256, 0);
+        if (!GlobalTree::readHistogram(treeName, freqs)) {
+            cerr << treeName << " is not a histogram" << endl;
+            return 1;
+        }
+        globalTree = new GlobalTree(freqs);
+    }
+
+    // only frames carry checksums, the single stream formats cannot be told
+    // apart from garbage
+    if (isTestMode) {
+        if (!FrameFormat::isFramed(inFileName)) {
+            cout << inFileName << ": not a framed file, nothing to verify"
+                 << endl;
+            return 1;
+        }
+        return testFrame(inFileName, globalTree) ? 0 : 1;
+    }
+
+    if (!range.empty()) {
+        size_t colon = range.find(':');
+        if (colon == string::npos) {
+            cout << options.help({""}) << std::endl;
+            exit(0);
+        }
+        unsigned long long offset, length;
+        if (!parseNumber(range.substr(0, colon), offset) ||
+            !parseNumber(range.substr(colon + 1), length)) {
+            cerr << "--range " << range
+                 << ": expected offset:length, two decimal numbers" << endl;
+            return 1;
+        }
+        if (!FrameFormat::isFramed(inFileName)) {
+            cerr << inFileName << ": not a framed file, cannot seek" << endl;
+            return 1;
+        }
+        return rangeDecompression(inFileName, outFileName, offset, length,
+                                  globalTree)
+                   ? 0
+                   : 1;
+    }
+
+    // the older formats write through an ofstream of their own
+    if (outFileName == "-" && !FrameFormat::isFramed(inFileName) &&
+        (isAsciiOutput || isBlockEncoding || isContextEncoding ||
+         isLZEncoding || isTunstallEncoding || width > 0)) {
+        cerr << "only the default and framed formats can be written to "
+                "the standard output"
+             << endl;
+        return 1;
+    }
+
+    if (!FileUtils::isEmptyFile(inFileName)) {
+        // a frame says how it was coded, whatever the options
+        if (FrameFormat::isFramed(inFileName)) {
+            if (!framedDecompression(inFileName, outFileName, isDirect,
+                                     globalTree)) {
+                return 1;
+            }
+        } else if (isAsciiOutput) {
             pseudoDecompression(inFileName, outFileName);
         } else if (isBlockEncoding) {
             blockDecompression(inFileName, outFileName);
+        } else if (isContextEncoding) {
+            contextDecompression(inFileName, outFileName);
+        } else if (isLZEncoding) {
+            if (!lzDecompression(inFileName, outFileName)) {
+                return 1;
+            }
+        } else if (width > 0) {
+            if (!wideDecompression(inFileName, outFileName, width)) {
+                return 1;
+            }
+        } else if (isTunstallEncoding) {
+            if (!tunstallDecompression(inFileName, outFileName)) {
+                return 1;
+            }
         } else {
-            trueDecompression(inFileName, outFileName);
+            // a large stream is decoded in pieces, on a thread each
+            unsigned int pieces = SpeculativeDecoder::getPieceCount(
+                FileUtils::getFileSize(inFileName), threads);
+            bool written =
+                pieces > 1
+                    ? speculativeDecompression(inFileName, outFileName,
+                                               pieces)
+                    : trueDecompression(inFileName, outFileName);
+            if (!written) {
+                return 1;
+            }
         }
-    } else {
+    } else if (outFileName != "-") {
+        // an empty output, the standard output gets nothing
         ofstream outFile;
         outFile.open(outFileName);
         outFile.close();
     }
+    delete globalTree;
     return 0;
 }
@@ -0,0 +1,30 @@
+/**
+ * This file declares the data the unit tests of the coders share
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#ifndef TESTDATA_HPP
+#define TESTDATA_HPP
+
+#include <vector>
+
+typedef unsigned char byte;
+
+using namespace std;
+
+/* skewed bytes, a few of them rare enough for codes past the root table
+  params:
+    n: the number of bytes
+    seed: the seed of the generator, so tests may differ in their data */
+inline vector<byte> makeData(unsigned int n, unsigned int seed = 12345) {
+    vector<byte> data(n);
+    for (unsigned int i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = (seed >> 16) & 0x7FFF;
+        data[i] = r < 16384 ? 'e' : r < 28000 ? 'a' + r % 20 : r % 256;
+    }
+    return data;
+}
+
+#endif  // TESTDATA_HPP
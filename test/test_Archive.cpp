@@ -0,0 +1,135 @@
+/**
+ * This file performs unit tests for ArchiveWriter and ArchiveReader.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ArchiveReader.hpp"
+#include "ArchiveWriter.hpp"
+
+using namespace std;
+using namespace testing;
+
+class SimpleArchiveFixture : public ::testing::Test {
+  protected:
+    vector<string> names;
+    vector<vector<byte>> files;
+    vector<unsigned int> freqs;
+
+  public:
+    SimpleArchiveFixture() : freqs(256, 0) {
+        // initialization code here
+        string lines[] = {"small files share a tree\n", "", "one more line\n",
+                          "and the last small file of the archive\n"};
+        for (int i = 0; i < 4; i++) {
+            names.push_back("dir/file" + to_string(i));
+            files.push_back(vector<byte>(lines[i].begin(), lines[i].end()));
+            for (byte c : files[i]) {
+                freqs[c]++;
+            }
+        }
+        // larger than one chunk
+        vector<byte> big;
+        for (int i = 0; i < 3000; i++) {
+            big.push_back("abcdefgh"[i % 8] + i / 1000);
+        }
+        names.push_back("big");
+        files.push_back(big);
+    }
+
+    /* Write every file into an archive of 1000 byte chunks */
+    string writeArchive(bool shared) {
+        stringstream ss;
+        ArchiveWriter* writer =
+            shared ? new ArchiveWriter(ss, 1000, ChunkCodec::DEFAULT_LEVEL,
+                                       freqs)
+                   : new ArchiveWriter(ss, 1000, ChunkCodec::DEFAULT_LEVEL);
+        for (unsigned int i = 0; i < files.size(); i++) {
+            EXPECT_TRUE(writer->addFile(names[i], files[i]));
+        }
+        writer->close();
+        delete writer;
+        return ss.str();
+    }
+};
+
+TEST_F(SimpleArchiveFixture, TEST_ROUND_TRIP) {
+    bool modes[] = {false, true};
+    for (bool shared : modes) {
+        stringstream ss(writeArchive(shared));
+        ArchiveReader reader(ss);
+        ASSERT_TRUE(reader.isValid());
+        ASSERT_EQ(reader.getFileCount(), files.size());
+        // in any order
+        vector<byte> data;
+        for (int i = files.size() - 1; i >= 0; i--) {
+            EXPECT_EQ(reader.getName(i), names[i]);
+            EXPECT_EQ(reader.getSize(i), files[i].size());
+            ASSERT_TRUE(reader.readFile(i, data));
+            EXPECT_EQ(data, files[i]);
+        }
+        EXPECT_EQ(reader.findFile("dir/file2"), 2);
+        EXPECT_EQ(reader.findFile("missing"), -1);
+    }
+}
+
+/* small files are smaller without trees of their own */
+TEST_F(SimpleArchiveFixture, TEST_SHARED_TREE) {
+    EXPECT_LT(writeArchive(true).size(), writeArchive(false).size());
+}
+
+TEST_F(SimpleArchiveFixture, TEST_CORRUPT) {
+    string archive = writeArchive(false);
+    stringstream ss(archive);
+    ArchiveReader reader(ss);
+    ASSERT_TRUE(reader.isValid());
+    // the last payload byte of the first file
+    archive[ArchiveFormat::HEADER_SIZE + FrameFormat::CHUNK_HEADER_SIZE +
+            files[0].size() - 1] ^= 1;
+    stringstream corrupt(archive);
+    ArchiveReader corruptReader(corrupt);
+    ASSERT_TRUE(corruptReader.isValid());
+    vector<byte> data;
+    EXPECT_FALSE(corruptReader.readFile(0, data));
+    EXPECT_TRUE(corruptReader.readFile(4, data));
+    EXPECT_EQ(data, files[4]);
+
+    stringstream cut(archive.substr(0, archive.size() - 1));
+    ArchiveReader cutReader(cut);
+    EXPECT_FALSE(cutReader.isValid());
+}
+
+/* names are stored without the components that leave the directory they
+   are extracted to, and a name the 2 byte length cannot hold is refused */
+TEST(ArchiveTests, TEST_NAMES) {
+    EXPECT_EQ(ArchiveFormat::normalizeName("dir/file"), "dir/file");
+    EXPECT_EQ(ArchiveFormat::normalizeName("/etc/passwd"), "etc/passwd");
+    EXPECT_EQ(ArchiveFormat::normalizeName("../../x/../y"), "x/../y");
+    EXPECT_EQ(ArchiveFormat::normalizeName("./.hidden"), ".hidden");
+    EXPECT_EQ(ArchiveFormat::normalizeName("//./.."), "");
+
+    stringstream ss;
+    ArchiveWriter writer(ss, 1000, ChunkCodec::DEFAULT_LEVEL);
+    vector<byte> data(10, 'a');
+    EXPECT_TRUE(writer.addFile("/tmp/../a", data));
+    EXPECT_FALSE(writer.addFile("..", data));
+    EXPECT_FALSE(writer.addFile(string(ArchiveFormat::MAX_NAME_LENGTH + 1,
+                                       'n'),
+                                data));
+    EXPECT_TRUE(
+        writer.addFile(string(ArchiveFormat::MAX_NAME_LENGTH, 'n'), data));
+    writer.close();
+
+    ArchiveReader reader(ss);
+    ASSERT_TRUE(reader.isValid());
+    ASSERT_EQ(reader.getFileCount(), 2);
+    EXPECT_EQ(reader.getName(0), "tmp/../a");
+    EXPECT_EQ(reader.findFile("/tmp/../a"), 0);
+    EXPECT_EQ(reader.getName(1).size(), ArchiveFormat::MAX_NAME_LENGTH);
+}
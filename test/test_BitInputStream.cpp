@@ -31,3 +31,17 @@ TEST(BitInputStreamTests, LONG_TEST) {
         EXPECT_EQ((i + 1) % 2, bis.readBit());
     }
 }
+
+TEST(BitInputStreamTests, READ_BITS_TEST) {
+    string ascii = string(1, stoi("11010101", nullptr, 2)) +
+                   string(1, stoi("01000001", nullptr, 2));
+
+    stringstream ss;
+    ss.str(ascii);
+    BitInputStream bis(ss);
+
+    ASSERT_EQ(1, bis.readBit());
+    ASSERT_EQ(0x2AA, bis.readBits(10));
+    ASSERT_EQ(0, bis.readBits(0));
+    ASSERT_EQ(1, bis.readBits(5));
+}
@@ -0,0 +1,315 @@
+/**
+ * This file performs unit tests for BitKernels, and the bit streams and
+ * trees that code many symbols with them.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "BitInputStream.hpp"
+#include "BitKernels.hpp"
+#include "BitOutputStream.hpp"
+#include "HCTree.hpp"
+#include "HCTree2.hpp"
+#include "TestData.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* every variant the CPU supports */
+static vector<int> supportedLevels() {
+    vector<int> levels;
+    for (int level = BitKernels::GENERIC; level <= BitKernels::getBestLevel();
+         level++) {
+        levels.push_back(level);
+    }
+    return levels;
+}
+
+TEST(BitKernelsTests, TEST_COUNT_BYTES) {
+    vector<byte> data = makeData(100003);
+    vector<unsigned int> expected(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        expected[data[i]]++;
+    }
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        EXPECT_EQ(BitKernels::select(levels[i]), levels[i]);
+        // counts are added, whatever the alignment
+        vector<unsigned int> freqs(256, 1);
+        BitKernels::countBytes(data.data() + 1, data.size() - 1,
+                               freqs.data());
+        freqs[data[0]]++;
+        for (int j = 0; j < 256; j++) {
+            EXPECT_EQ(freqs[j], expected[j] + 1);
+        }
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_COUNT_PAIRS) {
+    // short and odd, long enough for the 16-bit tables, and one pair
+    // repeated past what a 16-bit count holds
+    vector<vector<byte>> inputs;
+    inputs.push_back(makeData(100003));
+    inputs.push_back(makeData(1000001));
+    inputs.push_back(vector<byte>(600000, 0));
+    vector<int> levels = supportedLevels();
+    for (unsigned int k = 0; k < inputs.size(); k++) {
+        const vector<byte>& data = inputs[k];
+        vector<unsigned int> expected(65536, 1);
+        for (unsigned int i = 0; i < data.size(); i += 2) {
+            byte second = i + 1 < data.size() ? data[i + 1] : 0;
+            expected[(data[i] << 8) | second]++;
+        }
+        for (unsigned int i = 0; i < levels.size(); i++) {
+            EXPECT_EQ(BitKernels::select(levels[i]), levels[i]);
+            // counts are added
+            vector<unsigned int> freqs(65536, 1);
+            BitKernels::countPairs(data.data(), data.size(), freqs.data());
+            EXPECT_TRUE(freqs == expected)
+                << data.size() << " bytes, level " << levels[i];
+        }
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_COUNT_PAIRS_KEPT) {
+    // pieces counted into the same tables, one pair past 16 bits
+    vector<byte> data = makeData(300001);
+    data.insert(data.begin(), 200000, 0);
+    vector<unsigned int> expected(65536, 1);
+    BitKernels::countPairs(data.data(), data.size(), expected.data());
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        EXPECT_EQ(BitKernels::select(levels[i]), levels[i]);
+        BitKernels::PairTables tables;
+        vector<unsigned int> freqs(65536, 1);
+        for (size_t start = 0; start < data.size(); start += 65536) {
+            size_t n = data.size() - start < 65536 ? data.size() - start
+                                                   : 65536;
+            BitKernels::countPairs(data.data() + start, n, tables,
+                                   freqs.data());
+        }
+        BitKernels::mergePairs(tables, freqs.data());
+        EXPECT_TRUE(freqs == expected) << "level " << levels[i];
+        // the tables are cleared
+        EXPECT_TRUE(tables.counts == vector<unsigned short>(2 * 65536, 0));
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_PACK_SAME_AS_WRITE_BITS) {
+    vector<byte> data = makeData(200000);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+
+    // 3 bits before the codes, so that they start inside a byte
+    ostringstream expected;
+    BitOutputStream expectedOut(expected);
+    expectedOut.writeBits(5, 3);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        tree.encode(data[i], expectedOut);
+    }
+    expectedOut.writeBits(1, 1);
+    expectedOut.flush();
+
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        BitKernels::select(levels[i]);
+        ostringstream os;
+        BitOutputStream bitOut(os);
+        bitOut.writeBits(5, 3);
+        tree.encode(data.data(), 1000, bitOut);
+        tree.encode(data.data() + 1000, data.size() - 1000, bitOut);
+        bitOut.writeBits(1, 1);
+        bitOut.flush();
+        EXPECT_EQ(os.str(), expected.str()) << BitKernels::getLevelName();
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_PACK_ENDS_ON_A_BYTE) {
+    // 8 one bit codes, the last byte stays in the buffer as writeBits
+    // leaves it, so flush writes no extra byte
+    vector<unsigned long long> codes(256, 0);
+    vector<unsigned char> lengths(256, 1);
+    codes[1] = 1;
+    vector<byte> symbols = {1, 0, 1, 0, 1, 0, 1, 1};
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    bitOut.writeCodes(symbols.data(), symbols.size(), codes.data(),
+                      lengths.data());
+    bitOut.flush();
+    EXPECT_EQ(os.str(), string(1, (char)0xAB));
+}
+
+TEST(BitKernelsTests, TEST_UNPACK_SAME_AS_TREE_WALK) {
+    vector<byte> data = makeData(200000);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    bitOut.writeBits(5, 3);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        tree.encode(data[i], bitOut);
+    }
+    bitOut.writeBits(0x2A, 7);
+    bitOut.flush();
+    tree.buildDecodeTable();
+
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        BitKernels::select(levels[i]);
+        istringstream is(os.str());
+        BitInputStream bitIn(is);
+        EXPECT_EQ(bitIn.readBits(3), 5);
+        vector<byte> decoded(data.size());
+        tree.decode(bitIn, decoded.data(), 777);
+        tree.decode(bitIn, decoded.data() + 777, data.size() - 777);
+        EXPECT_EQ(decoded, data) << BitKernels::getLevelName();
+        // the bits after the codes are read from where they stopped
+        EXPECT_EQ(bitIn.readBits(7), 0x2A);
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_LONG_CODES) {
+    // Fibonacci counts make a code of every length up to 30, past the
+    // root table and a sub table
+    vector<unsigned int> freqs(256, 0);
+    unsigned int a = 1, b = 1;
+    for (int i = 0; i < 31; i++) {
+        freqs[i] = a;
+        unsigned int next = a + b;
+        a = b;
+        b = next;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    EXPECT_EQ(tree.getCodeLength(0), 30);
+    tree.buildDecodeTable();
+
+    vector<byte> data;
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 31; i++) {
+            data.push_back(i);
+        }
+    }
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        BitKernels::select(levels[i]);
+        ostringstream os;
+        BitOutputStream bitOut(os);
+        tree.encode(data.data(), data.size(), bitOut);
+        bitOut.flush();
+        istringstream is(os.str());
+        BitInputStream bitIn(is);
+        vector<byte> decoded(data.size());
+        tree.decode(bitIn, decoded.data(), decoded.size());
+        EXPECT_EQ(decoded, data) << BitKernels::getLevelName();
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_UNPACK_FAST_AND_TAIL) {
+    vector<byte> data = makeData(5000);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    unsigned long long bits = 0;
+    for (unsigned int i = 0; i < data.size(); i++) {
+        bits += tree.getCodeLength(data[i]);
+    }
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    tree.encode(data.data(), data.size(), bitOut);
+    bitOut.flush();
+    string coded = os.str();
+    BitKernels::DecodeTable decodeTable;
+    vector<unsigned long long> codes(256, 0);
+    vector<unsigned char> lengths(256, 0);
+    // the codes of the tree, read back from single symbols
+    for (int s = 0; s < 256; s++) {
+        if (freqs[s] == 0) continue;
+        ostringstream one;
+        BitOutputStream oneOut(one);
+        byte symbol = s;
+        tree.encode(&symbol, 1, oneOut);
+        oneOut.flush();
+        lengths[s] = tree.getCodeLength(s);
+        istringstream oneIn(one.str());
+        BitInputStream oneBits(oneIn);
+        codes[s] = oneBits.readBits(lengths[s]);
+    }
+    BitKernels::buildDecodeTable(codes.data(), lengths.data(), 256,
+                                 decodeTable);
+
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        BitKernels::select(levels[i]);
+        // without padding, the codes of the last 8 bytes are left
+        unsigned long long bitPos = 0;
+        vector<byte> decoded(data.size());
+        size_t count = BitKernels::unpackCodes(
+            (const byte*)coded.data(), coded.size(), bitPos, decodeTable,
+            decoded.data(), decoded.size());
+        EXPECT_LT(count, data.size());
+        EXPECT_LE(bitPos / 8 + 8, coded.size() + 1);
+        // padded, the tail loop decodes them one by one
+        string padded = coded + string(8, '\0');
+        size_t rest = BitKernels::unpackCodes(
+            (const byte*)padded.data(), padded.size(), bitPos, decodeTable,
+            decoded.data() + count, decoded.size() - count);
+        EXPECT_EQ(count + rest, data.size());
+        EXPECT_EQ(bitPos, bits);
+        EXPECT_EQ(decoded, data) << BitKernels::getLevelName();
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
+
+TEST(BitKernelsTests, TEST_UNPACK_PAIRS) {
+    vector<byte> data = makeData(100000);
+    vector<unsigned int> freqs(65536, 0);
+    for (unsigned int i = 0; i < data.size(); i += 2) {
+        freqs[(data[i] << 8) + data[i + 1]]++;
+    }
+    HCTree2 tree;
+    tree.build(freqs);
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    for (unsigned int i = 0; i < data.size(); i += 2) {
+        tree.encode((data[i] << 8) + data[i + 1], bitOut);
+    }
+    bitOut.flush();
+    tree.buildDecodeTable();
+
+    vector<int> levels = supportedLevels();
+    for (unsigned int i = 0; i < levels.size(); i++) {
+        BitKernels::select(levels[i]);
+        istringstream is(os.str());
+        BitInputStream bitIn(is);
+        vector<byte2> symbols(data.size() / 2);
+        tree.decode(bitIn, symbols.data(), symbols.size());
+        for (unsigned int j = 0; j < symbols.size(); j++) {
+            ASSERT_EQ(symbols[j], (data[2 * j] << 8) + data[2 * j + 1]);
+        }
+    }
+    BitKernels::select(BitKernels::getBestLevel());
+}
@@ -32,3 +32,37 @@ TEST(BitOutputStreamTests, LONG_TEST) {
     ASSERT_EQ(ss.get(), asciiVal);
     ASSERT_EQ(ss.get(), asciiVal);
 }
+
+TEST(BitOutputStreamTests, WRITE_BITS_TEST) {
+    stringstream ss;
+    BitOutputStream bos(ss);
+    bos.writeBit(1);
+    bos.writeBits(0x2AA, 10);
+    bos.writeBits(0, 0);
+    bos.writeBits(1, 5);
+    bos.flush();
+
+    // 1 1010101010 00001
+    ASSERT_EQ(ss.get(), stoi("11010101", nullptr, 2));
+    ASSERT_EQ(ss.get(), stoi("01000001", nullptr, 2));
+}
+
+TEST(BitOutputStreamTests, WRITE_PACKED_TEST) {
+    stringstream ss;
+    BitOutputStream bos(ss);
+    bos.writeBits(5, 3);
+    ASSERT_EQ(bos.getBufferedBits(), 3);
+    // 3 zero bits for the buffer, then 11001100 1110
+    byte packed[] = {0x19, 0x9C};
+    bos.writePacked(packed, 15);
+    ASSERT_EQ(bos.getBufferedBits(), 7);
+    bos.writeBit(1);
+    // a full buffer stays until the next bit or flush
+    ASSERT_EQ(bos.getBufferedBits(), 8);
+    bos.flush();
+
+    // 101 11001100 1110 1
+    ASSERT_EQ(ss.get(), stoi("10111001", nullptr, 2));
+    ASSERT_EQ(ss.get(), stoi("10011101", nullptr, 2));
+    ASSERT_EQ(ss.get(), EOF);
+}
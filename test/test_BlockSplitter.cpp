@@ -0,0 +1,111 @@
+/**
+ * This file performs unit tests for BlockSplitter
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "BlockSplitter.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* n bytes drawn from the given alphabet */
+static void append(vector<byte>& data, unsigned int n, const string& alphabet,
+                   unsigned int seed) {
+    for (unsigned int i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        data.push_back(alphabet[(seed >> 16) % alphabet.size()]);
+    }
+}
+
+/* return the sum of the lengths, checking none is longer than maxLength */
+static size_t checkLengths(const vector<unsigned int>& lengths,
+                           unsigned int maxLength) {
+    size_t sum = 0;
+    for (unsigned int i = 0; i < lengths.size(); i++) {
+        EXPECT_GT(lengths[i], 0);
+        EXPECT_LE(lengths[i], maxLength);
+        sum += lengths[i];
+    }
+    return sum;
+}
+
+TEST(BlockSplitterTests, TEST_SPLIT_AT_CHANGE) {
+    // text, then digits, then text again
+    vector<byte> data;
+    append(data, 100000, "etaoin shrdlu", 1);
+    append(data, 60000, "0123456789", 2);
+    append(data, 80000, "etaoin shrdlu", 3);
+    BlockSplitter splitter(1 << 18);
+    vector<unsigned int> lengths;
+    splitter.split(data.data(), data.size(), lengths);
+    EXPECT_EQ(checkLengths(lengths, 1 << 18), data.size());
+    ASSERT_GE(lengths.size(), 3);
+
+    // a boundary within a unit of each change
+    unsigned int unit = splitter.getUnitSize(data.size());
+    bool first = false, second = false;
+    size_t start = 0;
+    for (unsigned int i = 0; i < lengths.size(); i++) {
+        start += lengths[i];
+        first |= start + unit > 100000 && start < 100000 + unit;
+        second |= start + unit > 160000 && start < 160000 + unit;
+    }
+    EXPECT_TRUE(first);
+    EXPECT_TRUE(second);
+}
+
+TEST(BlockSplitterTests, TEST_NO_SPLIT) {
+    // one alphabet throughout, a segment as long as allowed
+    vector<byte> data;
+    append(data, 200000, "etaoin shrdlu", 4);
+    BlockSplitter splitter(1 << 16);
+    vector<unsigned int> lengths;
+    splitter.split(data.data(), data.size(), lengths);
+    EXPECT_EQ(checkLengths(lengths, 1 << 16), data.size());
+    EXPECT_EQ(lengths.size(), 4);
+
+    splitter.split(data.data(), 0, lengths);
+    EXPECT_TRUE(lengths.empty());
+    splitter.split(data.data(), 10, lengths);
+    EXPECT_EQ(lengths, vector<unsigned int>(1, 10));
+}
+
+TEST(BlockSplitterTests, TEST_BUDGET) {
+    unsigned int unit = BlockSplitter::MIN_UNIT_SIZE;
+    BlockSplitter fine(1 << 20, 1ULL << 40);
+    EXPECT_EQ(fine.getUnitSize(1 << 24), unit);
+    // 64 units of 64 segments each
+    BlockSplitter coarse(1 << 20, 64 * 64);
+    EXPECT_EQ(coarse.getUnitSize(1 << 20), 1 << 14);
+    // never more than the longest segment
+    BlockSplitter small(1000);
+    EXPECT_EQ(small.getUnitSize(1 << 24), 1000);
+
+    vector<byte> data;
+    append(data, 300000, "ab", 5);
+    append(data, 300000, "0123456789abcdef", 6);
+    vector<unsigned int> lengths;
+    coarse.split(data.data(), data.size(), lengths);
+    EXPECT_EQ(checkLengths(lengths, 1 << 20), data.size());
+}
+
+TEST(BlockSplitterTests, TEST_ESTIMATE) {
+    // 2 bytes, 1 bit each, a 2 leaf tree, and the chunk overhead
+    vector<unsigned int> freqs(256, 0);
+    freqs['a'] = 500;
+    freqs['b'] = 500;
+    unsigned int overhead =
+        FrameFormat::CHUNK_HEADER_SIZE + FrameFormat::INDEX_ENTRY_SIZE;
+    EXPECT_DOUBLE_EQ(BlockSplitter::estimateBits(freqs, 1000),
+                     1000 + 8 + 18 + overhead * 8);
+    // every byte once, cheaper stored
+    freqs.assign(256, 1);
+    EXPECT_DOUBLE_EQ(BlockSplitter::estimateBits(freqs, 256),
+                     256 * 8 + overhead * 8);
+}
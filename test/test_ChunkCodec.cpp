@@ -0,0 +1,126 @@
+/**
+ * This file performs unit tests for ChunkCodec.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ChunkCodec.hpp"
+
+using namespace std;
+using namespace testing;
+
+class SimpleChunkCodecFixture : public ::testing::Test {
+  protected:
+    vector<byte> text;
+    vector<byte> noise;
+
+  public:
+    SimpleChunkCodecFixture() {
+        // initialization code here
+        string s;
+        for (int i = 0; i < 100; i++) {
+            s += "a chunk of text, text and text\n";
+        }
+        text.assign(s.begin(), s.end());
+        unsigned int seed = 1;
+        for (int i = 0; i < 3000; i++) {
+            seed = seed * 1103515245 + 12345;
+            noise.push_back(seed >> 16);
+        }
+    }
+};
+
+TEST_F(SimpleChunkCodecFixture, TEST_CHOOSE_MODE) {
+    EXPECT_EQ(ChunkCodec::chooseMode(text, ChunkCodec::FASTEST_LEVEL),
+              FrameFormat::HUFFMAN);
+    EXPECT_EQ(ChunkCodec::chooseMode(text), FrameFormat::CONTEXT);
+    EXPECT_EQ(ChunkCodec::chooseMode(text, ChunkCodec::BEST_LEVEL),
+              FrameFormat::LZ);
+    EXPECT_EQ(ChunkCodec::chooseMode(noise), FrameFormat::STORED);
+    EXPECT_EQ(ChunkCodec::chooseMode(noise, ChunkCodec::BEST_LEVEL),
+              FrameFormat::STORED);
+}
+
+/* the histogram modes are sized exactly */
+TEST_F(SimpleChunkCodecFixture, TEST_ESTIMATE) {
+    byte modes[] = {FrameFormat::HUFFMAN, FrameFormat::BLOCK,
+                    FrameFormat::CONTEXT, FrameFormat::LZ};
+    for (byte mode : modes) {
+        ostringstream os;
+        ChunkCodec::encode(text, mode, os);
+        EXPECT_EQ(os.str().size(), ChunkCodec::estimate(text, mode));
+    }
+    EXPECT_EQ(ChunkCodec::estimate(noise, FrameFormat::STORED), noise.size());
+}
+
+TEST_F(SimpleChunkCodecFixture, TEST_ENCODE_BEST) {
+    for (int level = ChunkCodec::FASTEST_LEVEL;
+         level <= ChunkCodec::BEST_LEVEL; level++) {
+        ostringstream os;
+        byte mode = ChunkCodec::encodeBest(text, level, os);
+        EXPECT_EQ(mode, ChunkCodec::chooseMode(text, level));
+        vector<byte> decoded;
+        EXPECT_TRUE(ChunkCodec::decode(os.str(), mode, text.size(), decoded));
+        EXPECT_EQ(decoded, text);
+    }
+}
+
+TEST_F(SimpleChunkCodecFixture, TEST_ROUND_TRIP) {
+    byte modes[] = {FrameFormat::STORED, FrameFormat::HUFFMAN,
+                    FrameFormat::BLOCK, FrameFormat::CONTEXT, FrameFormat::LZ};
+    // odd lengths leave a lone last byte in block mode
+    vector<byte> odd(text.begin(), text.end() - 1);
+    for (byte mode : modes) {
+        ostringstream os;
+        ChunkCodec::encode(text, mode, os);
+        vector<byte> decoded;
+        EXPECT_TRUE(ChunkCodec::decode(os.str(), mode, text.size(), decoded));
+        EXPECT_EQ(decoded, text);
+
+        ostringstream oddOs;
+        ChunkCodec::encode(odd, mode, oddOs);
+        ChunkCodec::decode(oddOs.str(), mode, odd.size(), decoded);
+        EXPECT_EQ(decoded, odd);
+    }
+}
+
+/* a chunk of one repeated byte is just the tree */
+TEST(ChunkCodecTests, TEST_ONE_SYMBOL) {
+    vector<byte> data(5000, 'x');
+    ostringstream os;
+    ChunkCodec::encode(data, FrameFormat::HUFFMAN, os);
+    EXPECT_EQ(os.str().size(), 4);
+    vector<byte> decoded;
+    ChunkCodec::decode(os.str(), FrameFormat::HUFFMAN, data.size(), decoded);
+    EXPECT_EQ(decoded, data);
+}
+
+/* a byte of a tree header replaced never crashes the decoder, and a
+   header that cannot be a tree is rejected */
+TEST_F(SimpleChunkCodecFixture, TEST_CORRUPT_TREE) {
+    byte modes[] = {FrameFormat::HUFFMAN, FrameFormat::BLOCK,
+                    FrameFormat::CONTEXT, FrameFormat::LZ};
+    for (byte mode : modes) {
+        ostringstream os;
+        ChunkCodec::encode(text, mode, os);
+        int rejected = 0;
+        for (unsigned int i = 0; i < 64 && i < os.str().size(); i++) {
+            for (int value : {0x00, 0xFF}) {
+                string payload = os.str();
+                payload[i] = value;
+                vector<byte> decoded;
+                if (!ChunkCodec::decode(payload, mode, text.size(), decoded)) {
+                    rejected++;
+                }
+                EXPECT_EQ(decoded.size(), text.size());
+            }
+        }
+        EXPECT_GT(rejected, 0);
+    }
+}
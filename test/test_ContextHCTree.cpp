@@ -0,0 +1,91 @@
+/**
+ * This file performs unit tests for ContextHCTree.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ContextHCTree.hpp"
+
+using namespace std;
+using namespace testing;
+
+class SimpleContextHCTreeFixture : public ::testing::Test {
+  protected:
+    ContextHCTree model;
+    string text;
+
+  public:
+    SimpleContextHCTreeFixture() {
+        // initialization code here
+        for (int i = 0; i < 50; i++) {
+            text += "abababab qqqq abab qq zzzzzzzz abab ";
+        }
+        vector<vector<unsigned int>> freqs(256, vector<unsigned int>(256));
+        unsigned char prev = 0;
+        for (unsigned int i = 0; i < text.size(); i++) {
+            freqs[prev][(unsigned char)text[i]]++;
+            prev = text[i];
+        }
+        model.build(freqs, 4);
+    }
+};
+
+TEST_F(SimpleContextHCTreeFixture, TEST_CLUSTERS) {
+    EXPECT_GE(model.getClusters(), 1);
+    EXPECT_LE(model.getClusters(), 4);
+    // 'a' is always followed by 'b', 'z' mostly by 'z'
+    EXPECT_NE(model.getCluster('a'), model.getCluster('z'));
+}
+
+TEST_F(SimpleContextHCTreeFixture, TEST_ENCODE_DECODE_BIT) {
+    stringstream ss;
+    BitOutputStream bos(ss);
+    model.getTree(bos);
+    unsigned char prev = 0;
+    for (unsigned int i = 0; i < text.size(); i++) {
+        model.encode(prev, text[i], bos);
+        prev = text[i];
+    }
+    bos.flush();
+
+    BitInputStream bis(ss);
+    ContextHCTree decoded;
+    decoded.reconstructTree(bis);
+    ASSERT_EQ(decoded.getClusters(), model.getClusters());
+    prev = 0;
+    for (unsigned int i = 0; i < text.size(); i++) {
+        byte symbol = decoded.decode(prev, bis);
+        ASSERT_EQ(symbol, (unsigned char)text[i]);
+        prev = symbol;
+    }
+}
+
+/* a context whose cluster has one leaf writes no bits at all */
+TEST(ContextHCTreeTests, ONE_LEAF_CLUSTER) {
+    vector<vector<unsigned int>> freqs(256, vector<unsigned int>(256));
+    freqs[0]['x'] = 1;
+    freqs['x']['x'] = 100;
+    ContextHCTree model;
+    model.build(freqs, 1);
+    EXPECT_EQ(model.getClusters(), 1);
+
+    stringstream ss;
+    BitOutputStream bos(ss);
+    model.getTree(bos);
+    bos.flush();
+    string header = ss.str();
+
+    ss.str("");
+    BitOutputStream bos2(ss);
+    model.getTree(bos2);
+    for (int i = 0; i < 50; i++) {
+        model.encode('x', 'x', bos2);
+    }
+    bos2.flush();
+    EXPECT_EQ(ss.str(), header);
+}
@@ -0,0 +1,73 @@
+/**
+ * This file performs unit tests for Crc32c.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "Crc32c.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* the check value of the CRC-32C catalogue */
+TEST(Crc32cTests, TEST_CHECK_VALUE) {
+    string s = "123456789";
+    vector<byte> data(s.begin(), s.end());
+    EXPECT_EQ(Crc32c::compute(data), 0xE3069283);
+    EXPECT_EQ(Crc32c::compute(vector<byte>()), 0);
+}
+
+/* 32 zero bytes, from RFC 3720 */
+TEST(Crc32cTests, TEST_ZEROS) {
+    EXPECT_EQ(Crc32c::compute(vector<byte>(32, 0)), 0x8A9136AA);
+    EXPECT_EQ(Crc32c::compute(vector<byte>(32, 0xFF)), 0x62A8AB43);
+}
+
+/* any split of the bytes gives the same checksum */
+TEST(Crc32cTests, TEST_UPDATE) {
+    vector<byte> data;
+    for (int i = 0; i < 1000; i++) {
+        data.push_back(i * 31 + 7);
+    }
+    unsigned int whole = Crc32c::compute(data);
+    for (int split = 0; split < 20; split++) {
+        unsigned int crc = Crc32c::update(0, data.data(), split);
+        crc = Crc32c::update(crc, data.data() + split, data.size() - split);
+        EXPECT_EQ(crc, whole);
+    }
+}
+
+TEST(Crc32cTests, TEST_COMPUTE_FILE) {
+    vector<byte> data;
+    for (int i = 0; i < 10000; i++) {
+        data.push_back(i * 31 + 7);
+    }
+    const char* name = "test_Crc32c.tmp";
+    ofstream outFile(name, ios::binary);
+    outFile.write((const char*)data.data(), data.size());
+    outFile.close();
+    int fd = open(name, O_RDONLY);
+    ASSERT_GE(fd, 0);
+
+    // ranges off the page boundaries
+    unsigned int crc;
+    ASSERT_TRUE(Crc32c::computeFile(fd, 5000, 3000, crc));
+    EXPECT_EQ(crc, Crc32c::update(0, data.data() + 5000, 3000));
+    ASSERT_TRUE(Crc32c::computeFile(fd, 0, data.size(), crc));
+    EXPECT_EQ(crc, Crc32c::compute(data));
+    ASSERT_TRUE(Crc32c::computeFile(fd, 123, 0, crc));
+    EXPECT_EQ(crc, 0);
+    // past the end of the file
+    EXPECT_FALSE(Crc32c::computeFile(fd, 9000, 1001, crc));
+    close(fd);
+    remove(name);
+}
@@ -0,0 +1,83 @@
+/**
+ * This file performs unit tests for FileUtils
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "FileUtils.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* a file holding its own name */
+static void makeFile(string fileName) {
+    FileUtils::makeParentDirs(fileName);
+    ofstream outFile(fileName, ios::binary);
+    outFile << fileName;
+    outFile.close();
+}
+
+/* one run of compress --batch over root, listed as "root/.", into
+ * root/out, each file copied to the same path below the output directory;
+ * return the names of the inputs */
+static vector<string> runBatch(string root) {
+    vector<string> listed, inputs;
+    FileUtils::listFiles(root + "/.", listed);
+    string outDirName = root + "/out";
+    for (unsigned int i = 0; i < listed.size(); i++) {
+        if (FileUtils::isInside(listed[i], outDirName)) {
+            continue;
+        }
+        inputs.push_back(listed[i]);
+        makeFile(outDirName + "/" + listed[i].substr(root.size() + 3));
+    }
+    return inputs;
+}
+
+TEST(FileUtilsTests, TEST_INSIDE) {
+    string root = "test_FileUtils.dir";
+    makeFile(root + "/out/a");
+    makeFile(root + "/outer/b");
+    EXPECT_TRUE(FileUtils::isInside(root + "/out/a", root + "/out"));
+    EXPECT_TRUE(FileUtils::isInside(root + "/./out/a", root + "/out/"));
+    string dotted = "./" + root + "/out";
+    EXPECT_TRUE(FileUtils::isInside(root + "/out/../out/a", dotted));
+    EXPECT_FALSE(FileUtils::isInside(root + "/outer/b", root + "/out"));
+    EXPECT_FALSE(FileUtils::isInside(root + "/out/none", root + "/out"));
+    EXPECT_FALSE(FileUtils::isInside(root + "/out/a", root + "/none"));
+    remove((root + "/out/a").c_str());
+    remove((root + "/outer/b").c_str());
+    rmdir((root + "/out").c_str());
+    rmdir((root + "/outer").c_str());
+    rmdir(root.c_str());
+}
+
+TEST(FileUtilsTests, TEST_BATCH_TWICE) {
+    // the outputs of the first run are neither inputs of the second nor
+    // nested below the output directory
+    string root = "test_FileUtils.dir";
+    makeFile(root + "/a");
+    makeFile(root + "/sub/b");
+    EXPECT_EQ(runBatch(root).size(), 2);
+    EXPECT_EQ(runBatch(root).size(), 2);
+    EXPECT_FALSE(FileUtils::isDirectory(root + "/out/out"));
+    vector<string> outputs;
+    FileUtils::listFiles(root + "/out", outputs);
+    EXPECT_EQ(outputs.size(), 2);
+
+    const char* files[] = {"/a", "/sub/b", "/out/a", "/out/sub/b"};
+    for (unsigned int i = 0; i < 4; i++) {
+        remove((root + files[i]).c_str());
+    }
+    const char* dirs[] = {"/sub", "/out/sub", "/out", ""};
+    for (unsigned int i = 0; i < 4; i++) {
+        rmdir((root + dirs[i]).c_str());
+    }
+}
@@ -0,0 +1,313 @@
+/**
+ * This file performs unit tests for FrameWriter and FrameReader.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "Crc32c.hpp"
+#include "FrameReader.hpp"
+#include "FrameWriter.hpp"
+#include "HCTree.hpp"
+
+using namespace std;
+using namespace testing;
+
+TEST(FrameTests, TEST_HEADER) {
+    stringstream ss;
+    FrameWriter writer(ss, 0, 1024);
+    writer.close();
+    string frame = ss.str();
+    ASSERT_EQ(frame.size(), FrameFormat::getOverhead(0));
+    // a legacy total of 0 first
+    EXPECT_EQ(frame.substr(0, 4), string(4, '\0'));
+    EXPECT_EQ(frame.substr(4, 3), "HCF");
+
+    FrameReader reader(ss);
+    ASSERT_TRUE(reader.isValid());
+    EXPECT_EQ(reader.getTotal(), 0);
+    EXPECT_EQ(reader.getChunkSize(), 1024);
+    vector<byte> chunk;
+    EXPECT_FALSE(reader.readChunk(chunk));
+}
+
+TEST(FrameTests, TEST_NOT_A_FRAME) {
+    stringstream ss;
+    ss.str(string("\0\0\0\5abcde", 9));
+    FrameReader reader(ss);
+    EXPECT_FALSE(reader.isValid());
+}
+
+TEST(FrameTests, TEST_ROUND_TRIP) {
+    vector<byte> text(1000, 'a'), noise;
+    for (int i = 0; i < 1000; i++) {
+        text[i] += i % 3;
+        noise.push_back((i * 7919) >> 3);
+    }
+    stringstream ss;
+    FrameWriter writer(ss, 3000, 1000);
+    writer.writeChunk(text);
+    writer.writeChunk(noise);
+    writer.writeChunk(text, FrameFormat::STORED);
+    writer.close();
+
+    FrameReader reader(ss);
+    ASSERT_TRUE(reader.isValid());
+    EXPECT_EQ(reader.getTotal(), 3000);
+    vector<byte> chunk;
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, text);
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, noise);
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, text);
+    EXPECT_FALSE(reader.readChunk(chunk));
+}
+
+/* a flipped bit in a stored chunk is found by its checksum */
+TEST(FrameTests, TEST_CORRUPT_CHUNK) {
+    vector<byte> text(1000, 'a');
+    stringstream ss;
+    FrameWriter writer(ss, 2000, 1000);
+    writer.writeChunk(text, FrameFormat::STORED);
+    writer.writeChunk(text, FrameFormat::STORED);
+    writer.close();
+    string frame = ss.str();
+    // a byte in the middle of the second payload
+    frame[FrameFormat::HEADER_SIZE + 2 * FrameFormat::CHUNK_HEADER_SIZE +
+          1500] ^= 4;
+
+    stringstream corrupt(frame);
+    FrameReader reader(corrupt);
+    ASSERT_TRUE(reader.isValid());
+    EXPECT_TRUE(reader.hasChecksums());
+    vector<byte> chunk;
+    EXPECT_TRUE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_TRUE(reader.isCorrupt());
+}
+
+/* a chunk whose tree header is not a tree is corrupt, it is not decoded */
+TEST(FrameTests, TEST_CORRUPT_TREE) {
+    vector<byte> text(1000, 'a');
+    for (int i = 0; i < 1000; i++) {
+        text[i] += i % 7;
+    }
+    stringstream ss;
+    FrameWriter writer(ss, 1000, 1000);
+    writer.writeChunk(text, FrameFormat::CONTEXT);
+    writer.close();
+    string frame = ss.str();
+    // the cluster count and map at the start of the payload
+    for (unsigned int i = 0; i < 8; i++) {
+        frame[FrameFormat::HEADER_SIZE + FrameFormat::CHUNK_HEADER_SIZE + i] =
+            (char)0xFF;
+    }
+
+    stringstream corrupt(frame);
+    FrameReader reader(corrupt);
+    ASSERT_TRUE(reader.isValid());
+    vector<byte> chunk;
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_TRUE(reader.isCorrupt());
+}
+
+/* a frame cut short, or ending before its total, is corrupt */
+TEST(FrameTests, TEST_TRUNCATED) {
+    vector<byte> text(1000, 'a');
+    stringstream ss;
+    FrameWriter writer(ss, 2000, 1000);
+    writer.writeChunk(text);
+    writer.close();
+
+    FrameReader reader(ss);
+    vector<byte> chunk;
+    EXPECT_TRUE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_TRUE(reader.isCorrupt());
+
+    stringstream cut(ss.str().substr(
+        0, FrameFormat::HEADER_SIZE + FrameFormat::CHUNK_HEADER_SIZE + 3));
+    FrameReader cutReader(cut);
+    EXPECT_FALSE(cutReader.readChunk(chunk));
+    EXPECT_TRUE(cutReader.isCorrupt());
+}
+
+/* the index takes a reader straight to the chunk holding an offset */
+TEST(FrameTests, TEST_SEEK_CHUNK) {
+    stringstream ss;
+    FrameWriter writer(ss, 2500, 1000);
+    vector<vector<byte>> chunks;
+    for (int i = 0; i < 3; i++) {
+        chunks.push_back(vector<byte>(i < 2 ? 1000 : 500, 'a' + i));
+        writer.writeChunk(chunks[i]);
+    }
+    writer.close();
+
+    FrameReader reader(ss);
+    unsigned long long chunkStart;
+    EXPECT_FALSE(reader.seekChunk(0, chunkStart));
+    ASSERT_TRUE(reader.readIndex());
+    EXPECT_EQ(reader.getChunkCount(), 3);
+    vector<byte> chunk;
+    ASSERT_TRUE(reader.seekChunk(2499, chunkStart));
+    EXPECT_EQ(chunkStart, 2000);
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, chunks[2]);
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.isCorrupt());
+
+    ASSERT_TRUE(reader.seekChunk(1000, chunkStart));
+    EXPECT_EQ(chunkStart, 1000);
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, chunks[1]);
+    EXPECT_FALSE(reader.seekChunk(2500, chunkStart));
+}
+
+/* a damaged index is refused, the chunks still read in order */
+TEST(FrameTests, TEST_BAD_INDEX) {
+    stringstream ss;
+    FrameWriter writer(ss, 1000, 1000);
+    writer.writeChunk(vector<byte>(1000, 'a'));
+    writer.close();
+    string frame = ss.str();
+    frame[frame.size() - 1] ^= 1;
+
+    stringstream bad(frame);
+    FrameReader reader(bad);
+    EXPECT_FALSE(reader.readIndex());
+    EXPECT_EQ(reader.getChunkCount(), 0);
+    vector<byte> chunk;
+    EXPECT_TRUE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.isCorrupt());
+}
+
+TEST(FrameTests, TEST_SKIP_STORED_CHUNK) {
+    stringstream ss;
+    FrameWriter writer(ss, 1500, 1000);
+    vector<byte> stored(1000);
+    for (int i = 0; i < 1000; i++) stored[i] = (i * 131) & 255;
+    vector<byte> coded(500, 'a');
+    writer.writeChunk(stored, FrameFormat::STORED);
+    writer.writeChunk(coded, FrameFormat::HUFFMAN);
+    writer.close();
+
+    FrameReader reader(ss);
+    unsigned int length, checksum;
+    streamoff offset;
+    ASSERT_TRUE(reader.skipStoredChunk(length, checksum, offset));
+    EXPECT_EQ(length, 1000);
+    EXPECT_EQ(checksum, Crc32c::compute(stored));
+    EXPECT_EQ(ss.str().substr(offset, length),
+              string(stored.begin(), stored.end()));
+    // a coded chunk is left to readChunk, as is the end
+    EXPECT_FALSE(reader.skipStoredChunk(length, checksum, offset));
+    vector<byte> chunk;
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, coded);
+    EXPECT_FALSE(reader.skipStoredChunk(length, checksum, offset));
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.isCorrupt());
+}
+
+TEST(FrameTests, TEST_SHARED_TREE) {
+    vector<byte> text(1000, 'a'), other(100, 'z');
+    for (int i = 0; i < 1000; i++) text[i] += i % 4;
+    vector<unsigned int> freqs(256, 0);
+    freqs['a'] = freqs['b'] = freqs['c'] = freqs['d'] = 1;
+    HCTree tree;
+    tree.build(freqs);
+    stringstream ss;
+    FrameWriter writer(ss, 1100, 1000, ChunkCodec::FASTEST_LEVEL, &tree, 42);
+    writer.writeChunk(text);
+    // a byte the tree has no code for, the chunk codes on its own
+    writer.writeChunk(other);
+    writer.close();
+    // 2 bits a byte, no tree in the chunk
+    string frame = ss.str();
+    unsigned int first = FrameFormat::HEADER_SIZE + FrameFormat::TREE_ID_SIZE;
+    EXPECT_EQ(frame[first], FrameFormat::SHARED);
+    EXPECT_EQ(frame[first + FrameFormat::CHUNK_HEADER_SIZE + 250],
+              FrameFormat::HUFFMAN);
+
+    FrameReader reader(ss);
+    ASSERT_TRUE(reader.isValid());
+    ASSERT_TRUE(reader.hasTreeId());
+    EXPECT_EQ(reader.getTreeId(), 42);
+    vector<byte> chunk;
+    // not without the tree
+    stringstream copy(frame);
+    FrameReader withoutTree(copy);
+    EXPECT_FALSE(withoutTree.readChunk(chunk));
+    EXPECT_TRUE(withoutTree.isCorrupt());
+
+    reader.setSharedTree(&tree);
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, text);
+    ASSERT_TRUE(reader.readChunk(chunk));
+    EXPECT_EQ(chunk, other);
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.isCorrupt());
+}
+
+TEST(FrameTests, TEST_REPEAT_TREE) {
+    // chunks of the same statistics, then one of other bytes
+    vector<vector<byte>> chunks(6, vector<byte>(1000));
+    unsigned int seed = 99;
+    for (int c = 0; c < 6; c++) {
+        for (int i = 0; i < 1000; i++) {
+            seed = seed * 1103515245 + 12345;
+            chunks[c][i] = (c == 5 ? 'A' : 'a') + (seed >> 16) % 5;
+        }
+    }
+    stringstream plain, ss;
+    FrameWriter plainWriter(plain, 6000, 1000);
+    FrameWriter writer(ss, 6000, 1000);
+    writer.setTreeReuse(true);
+    for (int c = 0; c < 6; c++) {
+        plainWriter.writeChunk(chunks[c]);
+        writer.writeChunk(chunks[c]);
+    }
+    plainWriter.close();
+    writer.close();
+    string frame = ss.str();
+    EXPECT_LT(frame.size(), plain.str().size());
+
+    // a tree, 4 chunks repeating it, and a new tree
+    unsigned int offset = FrameFormat::HEADER_SIZE;
+    for (int c = 0; c < 6; c++) {
+        EXPECT_EQ(frame[offset], c == 0 || c == 5 ? FrameFormat::HUFFMAN
+                                                  : FrameFormat::REPEAT);
+        stringstream header(frame.substr(offset + 5, 4));
+        offset += FrameFormat::CHUNK_HEADER_SIZE +
+                  FrameFormat::readNumber(header, 4);
+    }
+
+    FrameReader reader(ss);
+    vector<byte> chunk;
+    for (int c = 0; c < 6; c++) {
+        ASSERT_TRUE(reader.readChunk(chunk));
+        EXPECT_EQ(chunk, chunks[c]);
+    }
+    EXPECT_FALSE(reader.readChunk(chunk));
+    EXPECT_FALSE(reader.isCorrupt());
+
+    // straight to a REPEAT chunk, the tree is found before it
+    stringstream copy(frame);
+    FrameReader seeker(copy);
+    ASSERT_TRUE(seeker.readIndex());
+    unsigned long long start;
+    ASSERT_TRUE(seeker.seekChunk(3500, start));
+    EXPECT_EQ(start, 3000);
+    ASSERT_TRUE(seeker.readChunk(chunk));
+    EXPECT_EQ(chunk, chunks[3]);
+    ASSERT_TRUE(seeker.seekChunk(0, start));
+    ASSERT_TRUE(seeker.readChunk(chunk));
+    EXPECT_EQ(chunk, chunks[0]);
+}
@@ -0,0 +1,97 @@
+/**
+ * This file performs unit tests for GlobalTree.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "GlobalTree.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* a file of the given bytes under the temporary directory */
+static string makeFile(string name, string content) {
+    string fileName = "/tmp/test_GlobalTree_" + name;
+    ofstream outFile;
+    outFile.open(fileName, ios::binary);
+    outFile << content;
+    outFile.close();
+    return fileName;
+}
+
+TEST(GlobalTreeTests, TEST_EXPORT_AND_MERGE) {
+    string shard1 = makeFile("shard1", "aaab");
+    string shard2 = makeFile("shard2", "abcc");
+    vector<unsigned long long> freqs1, freqs2;
+    GlobalTree::countFile(shard1, freqs1);
+    GlobalTree::countFile(shard2, freqs2);
+    string hist1 = makeFile("hist1", "");
+    string hist2 = makeFile("hist2", "");
+    ASSERT_TRUE(GlobalTree::writeHistogram(hist1, freqs1));
+    ASSERT_TRUE(GlobalTree::writeHistogram(hist2, freqs2));
+
+    // merging is adding the counts of every shard
+    vector<unsigned long long> merged;
+    ASSERT_TRUE(GlobalTree::readHistogram(hist1, merged));
+    ASSERT_TRUE(GlobalTree::readHistogram(hist2, merged));
+    ASSERT_EQ(merged.size(), 256);
+    EXPECT_EQ(merged['a'], 4);
+    EXPECT_EQ(merged['b'], 2);
+    EXPECT_EQ(merged['c'], 2);
+    EXPECT_EQ(merged['d'], 0);
+
+    // the tree of the merged counts is the tree of the whole data set
+    vector<unsigned long long> whole;
+    GlobalTree::countFile(makeFile("whole", "aaababcc"), whole);
+    EXPECT_EQ(GlobalTree(merged).getId(), GlobalTree(whole).getId());
+    remove(shard1.c_str());
+    remove(shard2.c_str());
+    remove(hist1.c_str());
+    remove(hist2.c_str());
+}
+
+TEST(GlobalTreeTests, TEST_NOT_A_HISTOGRAM) {
+    vector<unsigned long long> freqs(256, 0);
+    string bad = makeFile("bad", "hc-histogram 1\n97 3\n300 1\n");
+    EXPECT_FALSE(GlobalTree::readHistogram(bad, freqs));
+    // nothing was added
+    EXPECT_EQ(freqs['a'], 0);
+    string text = makeFile("text", "97 3\n");
+    EXPECT_FALSE(GlobalTree::readHistogram(text, freqs));
+    remove(bad.c_str());
+    remove(text.c_str());
+}
+
+TEST(GlobalTreeTests, TEST_ID) {
+    vector<unsigned long long> freqs(256, 0);
+    freqs['a'] = 10;
+    freqs['b'] = 5;
+    freqs['c'] = 1;
+    // counts of the same tree have the same ID, other trees do not
+    vector<unsigned long long> doubled(freqs);
+    for (int i = 0; i < 256; i++) doubled[i] *= 2;
+    EXPECT_EQ(GlobalTree(freqs).getId(), GlobalTree(doubled).getId());
+    freqs['d'] = 1;
+    EXPECT_NE(GlobalTree(freqs).getId(), GlobalTree(doubled).getId());
+}
+
+TEST(GlobalTreeTests, TEST_LARGE_COUNTS) {
+    vector<unsigned long long> freqs(256, 0);
+    freqs['a'] = 1ULL << 40;
+    freqs['b'] = 1ULL << 39;
+    freqs['c'] = 1;
+    GlobalTree globalTree(freqs);
+    // scaled down alike, a rare byte keeps a code
+    const HCTree& tree = globalTree.getTree();
+    EXPECT_EQ(tree.getCodeLength('a'), 1);
+    EXPECT_EQ(tree.getCodeLength('b'), 2);
+    EXPECT_EQ(tree.getCodeLength('c'), 2);
+    EXPECT_EQ(tree.getCodeLength('d'), 0);
+}
@@ -89,6 +89,21 @@ TEST_F(SimpleHCTreeFixture, TEST_GETTREE) {
     EXPECT_EQ(ss.get(), asciiVal);
 }
 
+TEST_F(SimpleHCTreeFixture, TEST_SIZES) {
+    EXPECT_EQ(tree.getCodeLength('a'), 2);
+    EXPECT_EQ(tree.getCodeLength('c'), 1);
+    EXPECT_EQ(tree.getCodeLength('z'), 0);
+
+    vector<unsigned int> freqs(256);
+    freqs['a'] = 2;
+    freqs['b'] = 3;
+    freqs['c'] = 5;
+    EXPECT_EQ(tree.getEncodedBits(freqs), 2 * 2 + 3 * 2 + 5 * 1);
+
+    // three leaves of 9 bits, one inner node that is not the root
+    EXPECT_EQ(tree.getTreeBits(), 28);
+}
+
 /* Empty Tree & One-Node Tree Tests */
 TEST(HCTreeTests, SMALL_TEST_ENCODE) {
     HCTree tree1, tree2;
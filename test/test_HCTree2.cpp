@@ -5,11 +5,13 @@
  * Email: y3yang@ucse.edu
  */
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
 #include "HCTree2.hpp"
+#include "TestData.hpp"
 
 using namespace std;
 using namespace testing;
@@ -207,6 +209,106 @@ TEST(HCTree2Tests, TEST_RECONSTRUCT) {
     tree->reconstructTree(bis, 2);
 }
 
+/* the codes of the symbols, one after another */
+static string encodeAll(const HCTree2& tree, const vector<byte2>& symbols) {
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        tree.encode(symbols[i], bitOut);
+    }
+    bitOut.flush();
+    return os.str();
+}
+
+/* the tree a header written by getTree gives back */
+static void reconstruct(HCTree2& tree, HCTree2& copy) {
+    stringstream ss;
+    BitOutputStream bitOut(ss);
+    tree.getTree(bitOut);
+    bitOut.flush();
+    BitInputStream bitIn(ss);
+    ASSERT_TRUE(copy.reconstructTree(bitIn, tree.getDistinctChars()));
+}
+
+TEST(HCTree2Tests, TEST_BUILD_OCCURRING) {
+    // the same tree from the symbols that occur as from all the counts
+    vector<unsigned int> freqs(65536, 0);
+    vector<byte2> symbols;
+    vector<unsigned int> counts;
+    for (unsigned int i = 0; i < 65536; i += 97) {
+        freqs[i] = 1 + i % 13;
+        symbols.push_back(i);
+        counts.push_back(freqs[i]);
+    }
+    HCTree2 whole, occurring;
+    whole.build(freqs);
+    occurring.build(symbols, counts);
+    EXPECT_EQ(occurring.getDistinctChars(), whole.getDistinctChars());
+    EXPECT_EQ(occurring.getTreeBits(), whole.getTreeBits());
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        EXPECT_EQ(occurring.getCodeLength(symbols[i]),
+                  whole.getCodeLength(symbols[i]));
+    }
+    EXPECT_EQ(encodeAll(occurring, symbols), encodeAll(whole, symbols));
+}
+
+TEST(HCTree2Tests, TEST_SPARSE_ALPHABET) {
+    // a few symbols at both ends and far apart, the rest absent
+    byte2 present[] = {0, 1, 255, 256, 0x7FFF, 0x8000, 0xFFFE, 0xFFFF};
+    vector<byte2> symbols(present, present + 8);
+    vector<unsigned int> counts = {50, 3, 7, 1, 20, 2, 9, 4};
+    HCTree2 tree;
+    tree.build(symbols, counts);
+    EXPECT_EQ(tree.getDistinctChars(), 8);
+    EXPECT_EQ(tree.getCodeLength(2), 0);
+    EXPECT_EQ(tree.getCodeLength(0x7FFE), 0);
+
+    vector<byte2> data;
+    for (unsigned int i = 0; i < 1000; i++) {
+        data.push_back(present[(i * 5 + i / 7) % 8]);
+    }
+    HCTree2 copy;
+    reconstruct(tree, copy);
+    copy.buildDecodeTable();
+    istringstream is(encodeAll(tree, data));
+    BitInputStream bitIn(is);
+    vector<byte2> decoded(data.size());
+    copy.decode(bitIn, decoded.data(), decoded.size());
+    EXPECT_EQ(decoded, data);
+}
+
+TEST(HCTree2Tests, TEST_ODD_BLOCK) {
+    // an odd number of bytes, the last one paired with 0 as
+    // blockCompression does, and cut off again after decoding
+    vector<byte> data = makeData(10001);
+    vector<byte2> pairs;
+    for (unsigned int i = 0; i < data.size(); i += 2) {
+        byte second = i + 1 < data.size() ? data[i + 1] : 0;
+        pairs.push_back((data[i] << 8) + second);
+    }
+    vector<unsigned int> freqs(65536, 0);
+    for (unsigned int i = 0; i < pairs.size(); i++) {
+        freqs[pairs[i]]++;
+    }
+    HCTree2 tree;
+    tree.build(freqs);
+
+    HCTree2 copy;
+    reconstruct(tree, copy);
+    copy.buildDecodeTable();
+    istringstream is(encodeAll(tree, pairs));
+    BitInputStream bitIn(is);
+    vector<byte2> symbols(pairs.size());
+    copy.decode(bitIn, symbols.data(), symbols.size());
+    vector<byte> decoded;
+    for (unsigned int i = 0; i < symbols.size(); i++) {
+        decoded.push_back(symbols[i] >> 8);
+        decoded.push_back(symbols[i] & 255);
+    }
+    decoded.resize(data.size());
+    EXPECT_EQ(decoded, data);
+}
+
 TEST(HCNode2, TEST_PRINT) {
     // test for printing HCNode
     unsigned char first, second;
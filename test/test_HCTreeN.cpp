@@ -0,0 +1,129 @@
+/**
+ * This file performs unit tests for HCTreeN
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "HCTreeN.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* records of a 3 byte field of few values and a 4 byte counter */
+static vector<byte> makeRecords(unsigned int records) {
+    vector<byte> data;
+    unsigned int seed = 11;
+    for (unsigned int i = 0; i < records; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int field = 0x10000 * ((seed >> 16) % 5) + 0x0203;
+        unsigned int counter = 1000000 + i;
+        data.push_back(field >> 16);
+        data.push_back(field >> 8);
+        data.push_back(field);
+        data.push_back(counter >> 24);
+        data.push_back(counter >> 16);
+        data.push_back(counter >> 8);
+        data.push_back(counter);
+    }
+    return data;
+}
+
+/* return data coded and decoded with symbols of width bytes, setting bits
+   to the length of the coded stream */
+static vector<byte> roundTrip(const vector<byte>& data, int width,
+                              unsigned long long& bits) {
+    unordered_map<unsigned int, unsigned int> freqs;
+    HCTreeN::countSymbols(data.data(), data.size(), width, freqs);
+    HCTreeN tree(width);
+    tree.build(freqs);
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    tree.getTree(bitOut);
+    tree.encode(data.data(), data.size(), bitOut);
+    bitOut.flush();
+    bits = tree.getTreeBits() + tree.getEncodedBits(freqs);
+    EXPECT_EQ(os.str().size(), (bits + 7) / 8);
+
+    istringstream is(os.str());
+    BitInputStream bitIn(is);
+    HCTreeN decoder(width);
+    decoder.reconstructTree(bitIn);
+    EXPECT_EQ(decoder.getDistinctSymbols(), tree.getDistinctSymbols());
+    vector<byte> decoded(data.size());
+    decoder.decode(bitIn, decoded.data(), decoded.size());
+    return decoded;
+}
+
+TEST(HCTreeNTests, TEST_EVERY_WIDTH) {
+    // an odd length, the last symbol cut short for every width above 1
+    vector<byte> data = makeRecords(3001);
+    data.push_back('x');
+    unsigned long long bits;
+    for (int width = 1; width <= HCTreeN::MAX_WIDTH; width++) {
+        EXPECT_EQ(roundTrip(data, width, bits), data) << width << " bytes";
+    }
+}
+
+TEST(HCTreeNTests, TEST_SPARSE_ALPHABET) {
+    // the symbols of 4 bytes far apart, the distinct ones only are kept
+    vector<byte> data;
+    unsigned int values[] = {0, 7, 0x12345678, 0xFFFFFFFF};
+    for (int i = 0; i < 4000; i++) {
+        unsigned int value = values[(i * 7) % 11 % 4];
+        for (int j = 3; j >= 0; j--) {
+            data.push_back(value >> (8 * j));
+        }
+    }
+    unordered_map<unsigned int, unsigned int> freqs;
+    HCTreeN::countSymbols(data.data(), data.size(), 4, freqs);
+    EXPECT_EQ(freqs.size(), 4);
+    unsigned long long bits;
+    EXPECT_EQ(roundTrip(data, 4, bits), data);
+    EXPECT_LT(bits, 4000 * 2 + 200);
+}
+
+TEST(HCTreeNTests, TEST_ONE_SYMBOL) {
+    vector<byte> data(999, 'z');
+    unsigned long long bits;
+    EXPECT_EQ(roundTrip(data, 3, bits), data);
+    EXPECT_EQ(roundTrip(vector<byte>(1, 'z'), 4, bits), vector<byte>(1, 'z'));
+}
+
+TEST(HCTreeNTests, TEST_MANY_SYMBOLS) {
+    // more distinct symbols than a decode table holds, decoded a bit at a
+    // time
+    vector<byte> data;
+    unsigned int seed = 3;
+    for (int i = 0; i < 200000; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int value = (seed >> 8) % 100000;
+        for (int j = 2; j >= 0; j--) {
+            data.push_back(value >> (8 * j));
+        }
+    }
+    unsigned long long bits;
+    EXPECT_EQ(roundTrip(data, 3, bits), data);
+}
+
+TEST(HCTreeNTests, TEST_WIDER_IS_SMALLER) {
+    // records of wide fields code smaller with symbols of their width
+    vector<byte> data;
+    unsigned int seed = 5;
+    for (int i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int value = 0x01020304u * (1 + (seed >> 16) % 13);
+        for (int j = 3; j >= 0; j--) {
+            data.push_back(value >> (8 * j));
+        }
+    }
+    unsigned long long byteBits, wideBits;
+    roundTrip(data, 1, byteBits);
+    roundTrip(data, 4, wideBits);
+    EXPECT_LT(wideBits * 2, byteBits);
+}
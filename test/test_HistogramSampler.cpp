@@ -0,0 +1,87 @@
+/**
+ * This file performs unit tests for HistogramSampler.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "BitInputStream.hpp"
+#include "BitOutputStream.hpp"
+#include "HCTree.hpp"
+#include "HistogramSampler.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* text of 64 blocks, with a byte that only the last block holds */
+static string makeInput() {
+    string s;
+    while (s.size() < 64 * HistogramSampler::SAMPLE_BLOCK_SIZE) {
+        s += "a histogram of a few blocks is close to the whole one\n";
+    }
+    s.resize(64 * HistogramSampler::SAMPLE_BLOCK_SIZE);
+    s[s.size() - 10] = '#';
+    return s;
+}
+
+TEST(HistogramSamplerTests, TEST_FULL_RATE) {
+    string s = makeInput();
+    istringstream in(s);
+    vector<unsigned int> freqs;
+    EXPECT_EQ(HistogramSampler::sample(in, s.size(), 1, freqs), s.size());
+    vector<unsigned int> exact(256, 0);
+    for (unsigned int i = 0; i < s.size(); i++) {
+        exact[(unsigned char)s[i]]++;
+    }
+    // every byte read, the counts are exact and unseen bytes stay 0
+    EXPECT_EQ(freqs, exact);
+}
+
+TEST(HistogramSamplerTests, TEST_SAMPLED) {
+    string s = makeInput();
+    istringstream in(s);
+    vector<unsigned int> freqs;
+    unsigned long long read =
+        HistogramSampler::sample(in, s.size(), 0.1, freqs);
+    EXPECT_EQ(read, 7 * HistogramSampler::SAMPLE_BLOCK_SIZE);
+    ASSERT_EQ(freqs.size(), 256);
+    unsigned long long sum = 0;
+    for (int i = 0; i < 256; i++) {
+        EXPECT_GE(freqs[i], 1);
+        sum += freqs[i];
+    }
+    // scaled up to the input, the escapes aside
+    EXPECT_NEAR((double)sum, (double)s.size(), 0.01 * s.size());
+    EXPECT_EQ(freqs['#'], 1);
+}
+
+TEST(HistogramSamplerTests, TEST_UNSEEN_BYTE_ENCODES) {
+    string s = makeInput();
+    istringstream in(s);
+    vector<unsigned int> freqs;
+    HistogramSampler::sample(in, s.size(), 0.05, freqs);
+    HCTree tree;
+    tree.build(freqs);
+
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    for (unsigned int i = 0; i < s.size(); i++) {
+        tree.encode(s[i], bitOut);
+    }
+    bitOut.flush();
+    // barely larger than a tree of the exact histogram would make it
+    EXPECT_LT(os.str().size(), s.size() * 5 / 8);
+
+    istringstream is(os.str());
+    BitInputStream bitIn(is);
+    string decoded;
+    for (unsigned int i = 0; i < s.size(); i++) {
+        decoded.push_back(tree.decode(bitIn));
+    }
+    EXPECT_TRUE(decoded == s);
+}
@@ -0,0 +1,104 @@
+/**
+ * This file performs unit tests for LZCodec.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "LZCodec.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* encode then decode the text, return the decoded text */
+static string roundTrip(const string& text, int level) {
+    vector<byte> data(text.begin(), text.end());
+    stringstream ss;
+    BitOutputStream bos(ss);
+    LZCodec::encode(data, level, bos);
+    bos.flush();
+
+    BitInputStream bis(ss);
+    vector<byte> decoded;
+    EXPECT_TRUE(LZCodec::decode(bis, data.size(), decoded));
+    return string(decoded.begin(), decoded.end());
+}
+
+TEST(LZCodecTests, TEST_CODES) {
+    EXPECT_EQ(LZCodec::lengthCode(3), 0);
+    EXPECT_EQ(LZCodec::lengthCode(12), 8);
+    EXPECT_EQ(LZCodec::lengthCode(257), 27);
+    EXPECT_EQ(LZCodec::lengthCode(258), 28);
+    EXPECT_EQ(LZCodec::distanceCode(1), 0);
+    EXPECT_EQ(LZCodec::distanceCode(6), 4);
+    EXPECT_EQ(LZCodec::distanceCode(32768), 29);
+    // every code covers a run of lengths and distances
+    for (unsigned int length = 4; length <= 258; length++) {
+        unsigned int step =
+            LZCodec::lengthCode(length) - LZCodec::lengthCode(length - 1);
+        ASSERT_LE(step, 1);
+    }
+    for (unsigned int distance = 2; distance <= 32768; distance++) {
+        unsigned int step = LZCodec::distanceCode(distance) -
+                            LZCodec::distanceCode(distance - 1);
+        ASSERT_LE(step, 1);
+    }
+}
+
+TEST(LZCodecTests, TEST_ROUND_TRIP) {
+    string text;
+    for (int i = 0; i < 200; i++) {
+        text += "the quick brown fox " + to_string(i % 17) + "\n";
+    }
+    EXPECT_EQ(roundTrip(text, LZMatcher::FASTEST_LEVEL), text);
+    EXPECT_EQ(roundTrip(text, LZMatcher::BEST_LEVEL), text);
+}
+
+/* no match at all, and a single literal symbol: one-leaf trees */
+TEST(LZCodecTests, TEST_SMALL) {
+    EXPECT_EQ(roundTrip("a", LZMatcher::DEFAULT_LEVEL), "a");
+    EXPECT_EQ(roundTrip("abcdefg", LZMatcher::DEFAULT_LEVEL), "abcdefg");
+    EXPECT_EQ(roundTrip(string(1000, 'z'), LZMatcher::DEFAULT_LEVEL),
+              string(1000, 'z'));
+}
+
+/* a corrupted stream is rejected or decodes to garbage, never crashes, and
+   a truncated one is rejected */
+TEST(LZCodecTests, TEST_CORRUPT) {
+    string text;
+    for (int i = 0; i < 2000; i++) {
+        text += "the quick brown fox " + to_string(i % 37) + "\n";
+    }
+    vector<byte> data(text.begin(), text.end());
+    stringstream ss;
+    BitOutputStream bos(ss);
+    LZCodec::encode(data, LZMatcher::DEFAULT_LEVEL, bos);
+    bos.flush();
+    string encoded = ss.str();
+
+    unsigned int seed = 7;
+    for (int trial = 0; trial < 200; trial++) {
+        string corrupted = encoded;
+        for (int i = 0; i < 4; i++) {
+            seed = seed * 1103515245 + 12345;
+            corrupted[(seed >> 8) % corrupted.size()] ^= 1 + (seed >> 24) % 255;
+        }
+        stringstream in(corrupted);
+        BitInputStream bis(in);
+        vector<byte> decoded;
+        if (LZCodec::decode(bis, data.size(), decoded)) {
+            EXPECT_EQ(decoded.size(), data.size());
+        } else {
+            EXPECT_LE(decoded.size(), data.size());
+        }
+    }
+
+    stringstream in(encoded.substr(0, encoded.size() / 2));
+    BitInputStream bis(in);
+    vector<byte> decoded;
+    EXPECT_FALSE(LZCodec::decode(bis, data.size(), decoded));
+}
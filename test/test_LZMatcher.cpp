@@ -0,0 +1,87 @@
+/**
+ * This file performs unit tests for LZMatcher.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "LZMatcher.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* rebuild the buffer from the tokens */
+static vector<byte> expand(const vector<LZToken>& tokens) {
+    vector<byte> data;
+    for (unsigned int i = 0; i < tokens.size(); i++) {
+        if (tokens[i].length == 0) {
+            data.push_back(tokens[i].literal);
+            continue;
+        }
+        unsigned int from = data.size() - tokens[i].distance;
+        for (int j = 0; j < tokens[i].length; j++) {
+            data.push_back(data[from + j]);
+        }
+    }
+    return data;
+}
+
+TEST(LZMatcherTests, TEST_REPEAT) {
+    string text = "abcabcabcabcabc";
+    vector<byte> data(text.begin(), text.end());
+    vector<LZToken> tokens;
+    LZMatcher matcher;
+    matcher.parse(data, tokens);
+
+    // three literals, then one overlapping match
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[0].literal, 'a');
+    EXPECT_EQ(tokens[3].length, 12);
+    EXPECT_EQ(tokens[3].distance, 3);
+    EXPECT_EQ(expand(tokens), data);
+}
+
+TEST(LZMatcherTests, TEST_NO_MATCH) {
+    string text = "ab";
+    vector<byte> data(text.begin(), text.end());
+    vector<LZToken> tokens;
+    LZMatcher matcher;
+    matcher.parse(data, tokens);
+    ASSERT_EQ(tokens.size(), 2);
+    EXPECT_EQ(tokens[1].length, 0);
+}
+
+TEST(LZMatcherTests, TEST_ALL_LEVELS) {
+    vector<byte> data;
+    unsigned int seed = 7;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 1103515245 + 12345;
+        // a small alphabet with long repeats now and then
+        if ((seed >> 16) % 50 == 0 && data.size() > 1000) {
+            unsigned int from = data.size() - 1 - (seed >> 8) % 1000;
+            for (int j = 0; j < 40; j++) {
+                data.push_back(data[from + j]);
+            }
+        } else {
+            data.push_back('a' + (seed >> 16) % 8);
+        }
+    }
+    for (int level = LZMatcher::FASTEST_LEVEL; level <= LZMatcher::BEST_LEVEL;
+         level++) {
+        vector<LZToken> tokens;
+        LZMatcher matcher(level);
+        matcher.parse(data, tokens);
+        for (unsigned int i = 0; i < tokens.size(); i++) {
+            if (tokens[i].length > 0) {
+                ASSERT_GE(tokens[i].length, LZMatcher::MIN_MATCH);
+                ASSERT_LE(tokens[i].length, LZMatcher::MAX_MATCH);
+                ASSERT_LE(tokens[i].distance, LZMatcher::WINDOW_SIZE);
+            }
+        }
+        EXPECT_EQ(expand(tokens), data);
+    }
+}
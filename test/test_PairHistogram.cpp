@@ -0,0 +1,66 @@
+/**
+ * This file performs unit tests for PairHistogram
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "PairHistogram.hpp"
+#include "TestData.hpp"
+
+using namespace std;
+using namespace testing;
+
+TEST(PairHistogramTests, TEST_SAME_AS_SERIAL) {
+    // pieces of every size, the last one short and odd
+    vector<byte> data = makeData(3 * PairHistogram::PIECE_SIZE + 12345, 1357);
+    vector<unsigned int> expected(65536, 0);
+    BitKernels::countPairs(data.data(), data.size(), expected.data());
+
+    unsigned int threads[] = {1, 2, 3, 8};
+    for (int i = 0; i < 4; i++) {
+        PairHistogram histogram(threads[i]);
+        vector<unsigned int> freqs(65536, 0);
+        histogram.count(data.data(), data.size());
+        histogram.merge(freqs.data());
+        EXPECT_TRUE(freqs == expected) << threads[i] << " threads";
+    }
+}
+
+TEST(PairHistogramTests, TEST_COUNTS_ADDED) {
+    // an even batch then the rest, as blockCompression reads them
+    vector<byte> data = makeData(2 * PairHistogram::PIECE_SIZE + 7, 1357);
+    vector<unsigned int> expected(65536, 1);
+    BitKernels::countPairs(data.data(), data.size(), expected.data());
+
+    PairHistogram histogram(2);
+    vector<unsigned int> freqs(65536, 1);
+    size_t batch = histogram.getBatchSize();
+    histogram.count(data.data(), batch);
+    histogram.count(data.data() + batch, data.size() - batch);
+    histogram.merge(freqs.data());
+    EXPECT_TRUE(freqs == expected);
+
+    // the tables start over after a merge
+    vector<unsigned int> again(65536, 1);
+    histogram.count(data.data(), data.size());
+    histogram.merge(again.data());
+    EXPECT_TRUE(again == expected);
+}
+
+TEST(PairHistogramTests, TEST_COUNTS_WRAP) {
+    // one pair counted past 16 bits by every thread, over many batches
+    vector<byte> data(PairHistogram::PIECE_SIZE + 1, 7);
+    PairHistogram histogram(2);
+    vector<unsigned int> freqs(65536, 0);
+    for (int i = 0; i < 3; i++) {
+        histogram.count(data.data(), data.size());
+    }
+    histogram.merge(freqs.data());
+    EXPECT_EQ(freqs[0x0707], 3 * (PairHistogram::PIECE_SIZE / 2));
+    EXPECT_EQ(freqs[0x0700], 3u);
+}
@@ -0,0 +1,77 @@
+/**
+ * This file performs unit tests for ParallelEncoder
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "ParallelEncoder.hpp"
+#include "TestData.hpp"
+
+using namespace std;
+using namespace testing;
+
+TEST(ParallelEncoderTests, TEST_SAME_AS_SERIAL) {
+    // pieces of every size, the last one short
+    vector<byte> data =
+        makeData(3 * ParallelEncoder::PIECE_SIZE + 12345, 2468);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+
+    unsigned int threads[] = {1, 2, 3, 8};
+    for (int lead = 0; lead < 8; lead++) {
+        // the codes start after lead bits, end after 1 more
+        ostringstream expected;
+        BitOutputStream expectedOut(expected);
+        expectedOut.writeBits(0x55, lead);
+        tree.encode(data.data(), data.size(), expectedOut);
+        expectedOut.writeBit(1);
+        expectedOut.flush();
+        for (int i = 0; i < 4; i++) {
+            ParallelEncoder encoder(tree, threads[i]);
+            ostringstream os;
+            BitOutputStream bitOut(os);
+            bitOut.writeBits(0x55, lead);
+            encoder.encode(data.data(), data.size(), bitOut);
+            bitOut.writeBit(1);
+            bitOut.flush();
+            EXPECT_TRUE(os.str() == expected.str())
+                << threads[i] << " threads, " << lead << " bits before";
+        }
+    }
+}
+
+TEST(ParallelEncoderTests, TEST_BATCHES) {
+    // batch after batch, as trueCompression codes a file
+    vector<byte> data = makeData(5 * ParallelEncoder::PIECE_SIZE + 3, 2468);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    ostringstream expected;
+    BitOutputStream expectedOut(expected);
+    tree.encode(data.data(), data.size(), expectedOut);
+    expectedOut.flush();
+
+    ParallelEncoder encoder(tree, 2);
+    EXPECT_EQ(encoder.getBatchSize(), 2 * ParallelEncoder::PIECE_SIZE);
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    for (size_t i = 0; i < data.size(); i += encoder.getBatchSize()) {
+        size_t n = min(encoder.getBatchSize(), data.size() - i);
+        encoder.encode(data.data() + i, n, bitOut);
+    }
+    bitOut.flush();
+    EXPECT_TRUE(os.str() == expected.str());
+}
@@ -0,0 +1,353 @@
+/**
+ * This file performs unit tests for SpscQueue, the stream buffers of the
+ * pipeline and InputFile and OutputFile on either backend.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "AsyncReadBuf.hpp"
+#include "AsyncWriteBuf.hpp"
+#include "InputFile.hpp"
+#include "IoUring.hpp"
+#include "OutputFile.hpp"
+#include "PipeWriteBuf.hpp"
+#include "SpscQueue.hpp"
+#include "TestData.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* a few blocks and an odd tail, so every boundary is crossed */
+static string makeBlocks() {
+    vector<byte> data = makeData(3 * AsyncReadBuf::BLOCK_SIZE + 12345, 2020);
+    return string(data.begin(), data.end());
+}
+
+TEST(SpscQueueTests, TEST_CAPACITY) {
+    SpscQueue<int> queue(2);
+    int item;
+    EXPECT_FALSE(queue.tryPop(item));
+    EXPECT_TRUE(queue.tryPush(1));
+    EXPECT_TRUE(queue.tryPush(2));
+    EXPECT_FALSE(queue.tryPush(3));
+    EXPECT_TRUE(queue.tryPop(item));
+    EXPECT_EQ(item, 1);
+    EXPECT_TRUE(queue.tryPush(3));
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_FALSE(queue.tryPop(item));
+}
+
+TEST(SpscQueueTests, TEST_ORDER) {
+    SpscQueue<int> queue(4);
+    thread producer([&queue]() {
+        for (int i = 0; i < 100000; i++) {
+            queue.push(i);
+        }
+    });
+    bool ordered = true;
+    for (int i = 0; i < 100000; i++) {
+        if (queue.pop() != i) ordered = false;
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+}
+
+/* pop waits for a push made long after, and push for room */
+TEST(SpscQueueTests, TEST_BLOCKING) {
+    SpscQueue<int> queue(1);
+    thread producer([&queue]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        queue.push(1);
+        queue.push(2);
+    });
+    EXPECT_EQ(queue.pop(), 1);
+    this_thread::sleep_for(chrono::milliseconds(20));
+    EXPECT_EQ(queue.pop(), 2);
+    producer.join();
+}
+
+TEST(AsyncReadBufTests, TEST_READ) {
+    string data = makeBlocks();
+    istringstream source(data);
+    AsyncReadBuf inBuf(source.rdbuf());
+    istream in(&inBuf);
+    string read((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    EXPECT_EQ(read, data);
+    inBuf.close();
+}
+
+TEST(AsyncReadBufTests, TEST_SEEK) {
+    string data = makeBlocks();
+    istringstream source(data);
+    AsyncReadBuf inBuf(source.rdbuf());
+    istream in(&inBuf);
+
+    // tell in the middle of a block, then read to the end and rewind
+    char c;
+    for (int i = 0; i < 1000; i++) in.get(c);
+    EXPECT_EQ(in.tellg(), 1000);
+    while (in.get(c)) {
+    }
+    in.clear();
+    in.seekg(0, ios::beg);
+    EXPECT_EQ(in.get(), (unsigned char)data[0]);
+
+    // seek into a later block, and back from the end
+    in.seekg(2 * AsyncReadBuf::BLOCK_SIZE + 5);
+    EXPECT_EQ(in.get(), (unsigned char)data[2 * AsyncReadBuf::BLOCK_SIZE + 5]);
+    in.seekg(-3, ios::end);
+    EXPECT_EQ(in.get(), (unsigned char)data[data.size() - 3]);
+    EXPECT_EQ(in.tellg(), data.size() - 2);
+    inBuf.close();
+}
+
+TEST(AsyncWriteBufTests, TEST_WRITE) {
+    string data = makeBlocks();
+    ostringstream sink;
+    AsyncWriteBuf outBuf(sink.rdbuf());
+    ostream out(&outBuf);
+    // single bytes and whole runs, across blocks
+    for (int i = 0; i < 100; i++) out.put(data[i]);
+    out.write(data.data() + 100, data.size() - 100);
+    outBuf.close();
+    EXPECT_EQ(sink.str(), data);
+}
+
+TEST(AsyncWriteBufTests, TEST_FLUSH) {
+    ostringstream sink;
+    AsyncWriteBuf outBuf(sink.rdbuf());
+    ostream out(&outBuf);
+    out << "abc";
+    out.flush();
+    out << "def";
+    outBuf.close();
+    EXPECT_EQ(sink.str(), "abcdef");
+}
+
+/* a sink that takes no byte, as a full disk */
+class FullBuf : public streambuf {};
+
+TEST(AsyncWriteBufTests, TEST_FAILED) {
+    string data = makeBlocks();
+    FullBuf sink;
+    AsyncWriteBuf outBuf(&sink);
+    ostream out(&outBuf);
+    out.write(data.data(), data.size());
+    outBuf.close();
+    EXPECT_TRUE(outBuf.isFailed());
+}
+
+/* write data through an OutputFile and read it back through an InputFile,
+ * seeking as the coders do */
+static void roundTrip(bool useUring, bool direct) {
+    string data = makeBlocks();
+    const char* name = "test_Pipeline.tmp";
+    bool isUring = direct || (useUring && IoUring::isAvailable());
+    OutputFile outFile(name, useUring, direct);
+    EXPECT_EQ(outFile.isUring(), isUring);
+    ostream& out = outFile.getStream();
+    out.put(data[0]);
+    // a flush in the middle of a block, which a direct file ignores
+    out.flush();
+    out.write(data.data() + 1, data.size() - 1);
+    EXPECT_TRUE(outFile.close());
+    ifstream sizeFile(name, ios::binary | ios::ate);
+    EXPECT_EQ(sizeFile.tellg(), data.size());
+    sizeFile.close();
+
+    InputFile inFile(name, useUring, direct);
+    EXPECT_EQ(inFile.isUring(), isUring);
+    istream& in = inFile.getStream();
+    string read((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    EXPECT_EQ(read, data);
+    in.clear();
+    in.seekg(0, ios::beg);
+    EXPECT_EQ(in.get(), (unsigned char)data[0]);
+    EXPECT_EQ(in.tellg(), 1);
+    in.seekg(2 * UringReadBuf::BLOCK_SIZE - 1);
+    EXPECT_EQ(in.get(), (unsigned char)data[2 * UringReadBuf::BLOCK_SIZE - 1]);
+    EXPECT_EQ(in.get(), (unsigned char)data[2 * UringReadBuf::BLOCK_SIZE]);
+    in.seekg(-1, ios::end);
+    EXPECT_EQ(in.get(), (unsigned char)data.back());
+    EXPECT_EQ(in.get(), EOF);
+    inFile.close();
+    remove(name);
+}
+
+TEST(InputFileTests, TEST_ROUND_TRIP_STREAM) { roundTrip(false, false); }
+
+TEST(InputFileTests, TEST_ROUND_TRIP_URING) { roundTrip(true, false); }
+
+TEST(InputFileTests, TEST_ROUND_TRIP_DIRECT) {
+    roundTrip(true, true);
+    // synchronous aligned blocks when there is no ring
+    roundTrip(false, true);
+}
+
+TEST(InputFileTests, TEST_EMPTY) {
+    const char* name = "test_Pipeline.tmp";
+    OutputFile outFile(name);
+    EXPECT_TRUE(outFile.close());
+    InputFile inFile(name);
+    EXPECT_EQ(inFile.getStream().get(), EOF);
+    EXPECT_TRUE(inFile.getStream().eof());
+    inFile.close();
+    remove(name);
+}
+
+/* a file cut short while it is read makes the stream bad, not end early;
+ * the blocks past the queue are read after the cut */
+TEST(InputFileTests, TEST_SHRUNK) {
+    string data;
+    while (data.size() < 2 * UringReadBuf::QUEUE_DEPTH *
+                             UringReadBuf::BLOCK_SIZE) {
+        data += makeBlocks();
+    }
+    const char* name = "test_Pipeline.tmp";
+    ofstream outFile(name, ios::binary);
+    outFile.write(data.data(), data.size());
+    outFile.close();
+    InputFile inFile(name, true, true);
+    EXPECT_TRUE(inFile.isUring());
+    EXPECT_EQ(truncate(name, UringReadBuf::BLOCK_SIZE / 2), 0);
+    istream& in = inFile.getStream();
+    string read(data.size(), 0);
+    in.read(&read[0], read.size());
+    EXPECT_TRUE(in.bad());
+    EXPECT_LT(in.gcount(), data.size());
+    inFile.close();
+    remove(name);
+}
+
+/* a write that fails is reported by close, on either backend */
+TEST(OutputFileTests, TEST_FULL) {
+    string data = makeBlocks();
+    for (int useUring = 0; useUring < 2; useUring++) {
+        OutputFile outFile("/dev/full", useUring);
+        outFile.getStream().write(data.data(), data.size());
+        EXPECT_FALSE(outFile.close());
+    }
+}
+
+/* blocks by vmsplice, a partial one by write and a file range by splice
+ * must reach the reader of the pipe in order */
+TEST(PipeWriteBufTests, TEST_PIPE) {
+    string data = makeBlocks();
+    const char* name = "test_Pipeline.tmp";
+    ofstream rangeFile(name, ios::binary);
+    rangeFile.write(data.data(), data.size());
+    rangeFile.close();
+    int inFd = open(name, O_RDONLY);
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    thread writer([&]() {
+        PipeWriteBuf outBuf(fds[1]);
+        EXPECT_TRUE(outBuf.isPipe());
+        ostream out(&outBuf);
+        out.write(data.data(), 5 * PipeWriteBuf::BLOCK_SIZE + 17);
+        out.flush();
+        EXPECT_TRUE(outBuf.spliceFrom(inFd, 1000, 3 * 4096 + 5));
+        out << "end";
+        outBuf.close();
+        close(fds[1]);
+    });
+    string read;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = ::read(fds[0], buffer, sizeof(buffer))) > 0) {
+        read.append(buffer, count);
+    }
+    writer.join();
+    close(fds[0]);
+    close(inFd);
+    remove(name);
+
+    string expected = data.substr(0, 5 * PipeWriteBuf::BLOCK_SIZE + 17) +
+                      data.substr(1000, 3 * 4096 + 5) + "end";
+    ASSERT_EQ(read.size(), expected.size());
+    EXPECT_TRUE(read == expected);
+}
+
+/* a reader that splices the pages on before reading them, as pv or a
+ * zero-copy parser does, must still get the bytes as they were written */
+TEST(PipeWriteBufTests, TEST_SPLICING_READER) {
+    string data = makeBlocks();
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    thread writer([&]() {
+        PipeWriteBuf outBuf(fds[1]);
+        EXPECT_TRUE(outBuf.isPipe());
+        ostream out(&outBuf);
+        out.write(data.data(), data.size());
+        outBuf.close();
+        close(fds[1]);
+    });
+
+    // every page is moved into pipes of its own first, and read only once
+    // the writer is done
+    vector<int> held;
+    bool more = true;
+    while (more) {
+        int next[2];
+        ASSERT_EQ(pipe(next), 0);
+        int size = fcntl(next[1], F_SETPIPE_SZ, 1 << 20);
+        ASSERT_GT(size, 0);
+        held.push_back(next[0]);
+        int left = size;
+        while (left > 0) {
+            ssize_t moved = splice(fds[0], 0, next[1], 0, left, 0);
+            if (moved <= 0) {
+                more = false;
+                break;
+            }
+            left -= moved;
+        }
+        close(next[1]);
+    }
+    writer.join();
+    close(fds[0]);
+
+    string read;
+    char buffer[4096];
+    for (unsigned int i = 0; i < held.size(); i++) {
+        ssize_t count;
+        while ((count = ::read(held[i], buffer, sizeof(buffer))) > 0) {
+            read.append(buffer, count);
+        }
+        close(held[i]);
+    }
+    ASSERT_EQ(read.size(), data.size());
+    EXPECT_TRUE(read == data);
+}
+
+TEST(PipeWriteBufTests, TEST_NOT_A_PIPE) {
+    string data = makeBlocks();
+    const char* name = "test_Pipeline.tmp";
+    int fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    PipeWriteBuf outBuf(fd);
+    EXPECT_FALSE(outBuf.isPipe());
+    ostream out(&outBuf);
+    out.write(data.data(), data.size());
+    outBuf.close();
+    close(fd);
+    ifstream inFile(name, ios::binary);
+    string read((istreambuf_iterator<char>(inFile)),
+                istreambuf_iterator<char>());
+    EXPECT_EQ(read, data);
+    inFile.close();
+    remove(name);
+}
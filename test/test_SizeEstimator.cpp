@@ -0,0 +1,109 @@
+/**
+ * This file performs unit tests for SizeEstimator.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "BitOutputStream.hpp"
+#include "ContextHCTree.hpp"
+#include "HCTree.hpp"
+#include "SizeEstimator.hpp"
+
+using namespace std;
+using namespace testing;
+
+class SimpleSizeEstimatorFixture : public ::testing::Test {
+  protected:
+    vector<byte> text;
+
+  public:
+    SimpleSizeEstimatorFixture() {
+        // initialization code here
+        string s;
+        for (int i = 0; i < 50; i++) {
+            s += "the size of a text can be known before writing it\n";
+        }
+        text.assign(s.begin(), s.end());
+    }
+};
+
+TEST(SizeEstimatorTests, TEST_ENTROPY) {
+    vector<unsigned int> freqs(256, 0);
+    EXPECT_EQ(SizeEstimator::entropy(freqs), 0);
+    freqs['a'] = 10;
+    EXPECT_EQ(SizeEstimator::entropy(freqs), 0);
+    freqs['b'] = 10;
+    EXPECT_DOUBLE_EQ(SizeEstimator::entropy(freqs), 1);
+    freqs['c'] = 10;
+    freqs['d'] = 10;
+    EXPECT_DOUBLE_EQ(SizeEstimator::entropy(freqs), 2);
+}
+
+/* "abab..." is two symbols of one bit, but each one tells the next */
+TEST(SizeEstimatorTests, TEST_CONTEXT_ENTROPY) {
+    vector<byte> data;
+    for (int i = 0; i < 100; i++) {
+        data.push_back('a');
+        data.push_back('b');
+    }
+    vector<unsigned int> freqs;
+    vector<vector<unsigned int>> contextFreqs;
+    SizeEstimator::countBytes(data, freqs);
+    SizeEstimator::countContexts(data, contextFreqs);
+    EXPECT_DOUBLE_EQ(SizeEstimator::entropy(freqs), 1);
+    EXPECT_DOUBLE_EQ(SizeEstimator::contextEntropy(contextFreqs), 0);
+}
+
+TEST_F(SimpleSizeEstimatorFixture, TEST_BYTE_MODE_BYTES) {
+    vector<unsigned int> freqs;
+    SizeEstimator::countBytes(text, freqs);
+    HCTree tree;
+    tree.build(freqs);
+    // the byte mode output: total, distinct count, tree and codes
+    ostringstream os;
+    BitOutputStream out(os);
+    out.writeBits(text.size(), 32);
+    out.writeBits(tree.getDistinctChars() - 1, 8);
+    tree.getTree(out);
+    for (unsigned int i = 0; i < text.size(); i++) {
+        tree.encode(text[i], out);
+    }
+    out.flush();
+    EXPECT_EQ(SizeEstimator::byteModeBytes(freqs), os.str().size());
+    EXPECT_EQ(SizeEstimator::byteModeBytes(vector<unsigned int>(256, 0)), 4);
+}
+
+TEST_F(SimpleSizeEstimatorFixture, TEST_CONTEXT_MODE_BYTES) {
+    vector<vector<unsigned int>> freqs;
+    SizeEstimator::countContexts(text, freqs);
+    ContextHCTree model;
+    model.build(freqs);
+    ostringstream os;
+    BitOutputStream out(os);
+    out.writeBits(text.size(), 32);
+    model.getTree(out);
+    byte prev = 0;
+    for (unsigned int i = 0; i < text.size(); i++) {
+        model.encode(prev, text[i], out);
+        prev = text[i];
+    }
+    out.flush();
+    EXPECT_EQ(SizeEstimator::contextModeBytes(freqs), os.str().size());
+}
+
+TEST_F(SimpleSizeEstimatorFixture, TEST_COUNT_PAIRS) {
+    vector<byte> data(text.begin(), text.begin() + 5);
+    vector<unsigned int> freqs;
+    SizeEstimator::countPairs(data, freqs);
+    EXPECT_EQ(freqs.size(), 65536);
+    EXPECT_EQ(freqs[('t' << 8) + 'h'], 1);
+    EXPECT_EQ(freqs[('e' << 8) + ' '], 1);
+    // the odd last byte is paired with 0
+    EXPECT_EQ(freqs['s' << 8], 1);
+}
@@ -0,0 +1,143 @@
+/**
+ * This file performs unit tests for SpeculativeDecoder
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "HCTree.hpp"
+#include "SpeculativeDecoder.hpp"
+#include "TestData.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* the codes of data after 3 other bits, and 8 bytes of zeros */
+static string encode(HCTree& tree, const vector<byte>& data) {
+    ostringstream os;
+    BitOutputStream bitOut(os);
+    bitOut.writeBits(5, 3);
+    tree.encode(data.data(), data.size(), bitOut);
+    bitOut.flush();
+    tree.buildDecodeTable();
+    return os.str();
+}
+
+TEST(SpeculativeDecoderTests, TEST_SAME_AS_SERIAL) {
+    vector<byte> data = makeData(300000, 4321);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    string coded = encode(tree, data);
+    size_t size = coded.size();
+    coded.append(8, '\0');
+
+    unsigned int pieces[] = {1, 2, 3, 8, 61, 400};
+    for (unsigned int i = 0; i < 6; i++) {
+        vector<byte> decoded(data.size(), 1);
+        SpeculativeDecoder::decode((const byte*)coded.data(), size, 3,
+                                   tree.getDecodeTable(), decoded.data(),
+                                   decoded.size(), pieces[i]);
+        EXPECT_EQ(decoded, data) << pieces[i] << " pieces";
+    }
+}
+
+TEST(SpeculativeDecoderTests, TEST_LONG_CODES) {
+    // Fibonacci counts make codes of every length up to 30, which take
+    // longer to resynchronize
+    vector<unsigned int> freqs(256, 0);
+    unsigned int a = 1, b = 1;
+    for (int i = 0; i < 31; i++) {
+        freqs[i] = a;
+        unsigned int next = a + b;
+        a = b;
+        b = next;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    vector<byte> data;
+    unsigned int seed = 7;
+    for (int i = 0; i < 50000; i++) {
+        seed = seed * 1103515245 + 12345;
+        data.push_back((seed >> 16) % 31);
+    }
+    string coded = encode(tree, data);
+    size_t size = coded.size();
+    coded.append(8, '\0');
+
+    vector<byte> decoded(data.size());
+    SpeculativeDecoder::decode((const byte*)coded.data(), size, 3,
+                               tree.getDecodeTable(), decoded.data(),
+                               decoded.size(), 200);
+    EXPECT_EQ(decoded, data);
+}
+
+TEST(SpeculativeDecoderTests, TEST_WINDOWS) {
+    vector<byte> data = makeData(300000, 4321);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    string coded = encode(tree, data);
+    size_t size = coded.size();
+    coded.append(8, '\0');
+
+    // windows of a few thousand bits, each going on where the last code of
+    // the one before ended
+    vector<byte> decoded, symbols;
+    unsigned long long pos = 3;
+    while (decoded.size() < data.size()) {
+        unsigned long long endPos = min(pos + 40000, size * 8ULL);
+        SpeculativeDecoder::decodeWindow(
+            (const byte*)coded.data(), size, pos, endPos,
+            tree.getDecodeTable(), symbols, data.size() - decoded.size(), 7);
+        if (symbols.empty()) break;
+        decoded.insert(decoded.end(), symbols.begin(), symbols.end());
+        if (decoded.size() < data.size()) {
+            EXPECT_GE(pos, endPos);
+        }
+    }
+    EXPECT_EQ(decoded, data);
+}
+
+TEST(SpeculativeDecoderTests, TEST_TRUNCATED) {
+    vector<byte> data = makeData(100000, 4321);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    HCTree tree;
+    tree.build(freqs);
+    string coded = encode(tree, data);
+    // half of the stream, the symbols it lacks are 0
+    size_t size = coded.size() / 2;
+    coded.replace(size, 8, 8, '\0');
+
+    vector<byte> decoded(data.size(), 1);
+    SpeculativeDecoder::decode((const byte*)coded.data(), size, 3,
+                               tree.getDecodeTable(), decoded.data(),
+                               decoded.size(), 5);
+    EXPECT_EQ(vector<byte>(decoded.begin(), decoded.begin() + 1000),
+              vector<byte>(data.begin(), data.begin() + 1000));
+    EXPECT_EQ(decoded.back(), 0);
+}
+
+TEST(SpeculativeDecoderTests, TEST_PIECE_COUNT) {
+    unsigned int piece = SpeculativeDecoder::MIN_PIECE_BYTES;
+    EXPECT_EQ(SpeculativeDecoder::getPieceCount(piece - 1, 8), 1);
+    EXPECT_EQ(SpeculativeDecoder::getPieceCount(3 * piece, 8), 3);
+    EXPECT_EQ(SpeculativeDecoder::getPieceCount(30 * piece, 8), 8);
+    EXPECT_EQ(SpeculativeDecoder::getPieceCount(30 * piece, 1), 1);
+    EXPECT_GE(SpeculativeDecoder::getPieceCount(30 * piece, 0), 1);
+}
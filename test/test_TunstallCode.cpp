@@ -0,0 +1,122 @@
+/**
+ * This file performs unit tests for TunstallCode
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "TestData.hpp"
+#include "TunstallCode.hpp"
+
+using namespace std;
+using namespace testing;
+
+/* return data coded and decoded again, through a written dictionary, in
+   calls of step bytes */
+static vector<byte> roundTrip(const vector<byte>& data, size_t step) {
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    TunstallCode code;
+    code.build(freqs);
+    EXPECT_LE(code.getCodewordCount(), TunstallCode::MAX_CODEWORDS);
+    ostringstream os;
+    code.writeDictionary(os);
+    vector<byte> codes;
+    for (size_t i = 0; i < data.size(); i += step) {
+        code.encode(data.data() + i, min(step, data.size() - i), codes);
+    }
+    code.flush(codes);
+
+    TunstallCode decoder;
+    istringstream is(os.str());
+    EXPECT_TRUE(decoder.readDictionary(is));
+    EXPECT_EQ(decoder.getCodewordCount(), code.getCodewordCount());
+    vector<byte> decoded(data.size());
+    size_t done = decoder.decode(codes.data(), codes.size() / 2,
+                                 decoded.data(), decoded.size());
+    EXPECT_EQ(done, data.size());
+    return decoded;
+}
+
+TEST(TunstallCodeTests, TEST_ROUND_TRIP) {
+    vector<byte> data = makeData(200000, 1357);
+    EXPECT_EQ(roundTrip(data, data.size()), data);
+    // the parse goes on across calls
+    EXPECT_EQ(roundTrip(data, 777), data);
+    EXPECT_EQ(roundTrip(vector<byte>(data.begin(), data.begin() + 5), 1),
+              vector<byte>(data.begin(), data.begin() + 5));
+}
+
+TEST(TunstallCodeTests, TEST_ONE_SYMBOL) {
+    // one byte throughout, phrases as long as allowed
+    vector<byte> data(1000, 'x');
+    vector<unsigned int> freqs(256, 0);
+    freqs['x'] = 1000;
+    TunstallCode code;
+    code.build(freqs);
+    EXPECT_EQ(code.getCodewordCount(), TunstallCode::MAX_PHRASE_LENGTH);
+    vector<byte> codes;
+    code.encode(data.data(), data.size(), codes);
+    code.flush(codes);
+    EXPECT_EQ(codes.size(),
+              2 * ((1000 + TunstallCode::MAX_PHRASE_LENGTH - 1) /
+                   TunstallCode::MAX_PHRASE_LENGTH));
+    EXPECT_EQ(roundTrip(data, 3), data);
+}
+
+TEST(TunstallCodeTests, TEST_EVERY_BYTE) {
+    // a flat alphabet of 256 bytes, room for 256 inner nodes only
+    vector<byte> data;
+    unsigned int seed = 99;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 1103515245 + 12345;
+        data.push_back(seed >> 24);
+    }
+    EXPECT_EQ(roundTrip(data, data.size()), data);
+}
+
+TEST(TunstallCodeTests, TEST_SMALLER_THAN_BYTES) {
+    vector<byte> data = makeData(100000, 1357);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    TunstallCode code;
+    code.build(freqs);
+    vector<byte> codes;
+    code.encode(data.data(), data.size(), codes);
+    code.flush(codes);
+    EXPECT_LT(codes.size(), data.size() * 3 / 4);
+}
+
+TEST(TunstallCodeTests, TEST_TRUNCATED) {
+    vector<byte> data = makeData(10000, 1357);
+    vector<unsigned int> freqs(256, 0);
+    for (unsigned int i = 0; i < data.size(); i++) {
+        freqs[data[i]]++;
+    }
+    TunstallCode code;
+    code.build(freqs);
+    ostringstream os;
+    code.writeDictionary(os);
+    vector<byte> codes;
+    code.encode(data.data(), data.size(), codes);
+    code.flush(codes);
+
+    // half of the codewords give fewer bytes
+    vector<byte> decoded(data.size());
+    EXPECT_LT(code.decode(codes.data(), codes.size() / 4, decoded.data(),
+                          decoded.size()),
+              data.size());
+    // a dictionary cut short is refused
+    TunstallCode decoder;
+    istringstream is(os.str().substr(0, os.str().size() - 1));
+    EXPECT_FALSE(decoder.readDictionary(is));
+}
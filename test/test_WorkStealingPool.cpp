@@ -0,0 +1,71 @@
+/**
+ * This file performs unit tests for WorkStealingPool.
+ *
+ * Author: Yuening YANG
+ * Email: y3yang@ucsd.edu
+ */
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "WorkStealingPool.hpp"
+
+using namespace std;
+using namespace testing;
+
+TEST(WorkStealingPoolTests, TEST_RUN_ALL) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.getThreadCount(), 4);
+    vector<int> done(1000, 0);
+    for (int i = 0; i < 1000; i++) {
+        pool.submit([&done, i]() { done[i]++; });
+    }
+    pool.run();
+    EXPECT_EQ(done, vector<int>(1000, 1));
+    // nothing left, a second run returns at once
+    pool.run();
+    EXPECT_EQ(done, vector<int>(1000, 1));
+}
+
+/* the tasks a task submits go to its own queue, so while it waits for
+ * them only the other threads can run them, by stealing */
+TEST(WorkStealingPoolTests, TEST_STEAL) {
+    WorkStealingPool pool(2);
+    atomic<int> count(0);
+    pool.submit([&]() {
+        for (int i = 0; i < 100; i++) {
+            pool.submit([&]() { count++; });
+        }
+        while (count < 100) {
+            this_thread::yield();
+        }
+    });
+    pool.run();
+    EXPECT_EQ(count, 100);
+}
+
+/* idle threads wait for the tasks of a running one, submitted late */
+TEST(WorkStealingPoolTests, TEST_LATE_SUBMIT) {
+    WorkStealingPool pool(4);
+    atomic<int> count(0);
+    pool.submit([&]() {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        for (int i = 0; i < 10; i++) {
+            pool.submit([&]() { count++; });
+        }
+    });
+    pool.run();
+    EXPECT_EQ(count, 10);
+}
+
+TEST(WorkStealingPoolTests, TEST_ONE_PER_CORE) {
+    WorkStealingPool pool(0);
+    EXPECT_GE(pool.getThreadCount(), 1);
+    atomic<int> count(0);
+    pool.submit([&]() { count++; });
+    pool.run();
+    EXPECT_EQ(count, 1);
+}